@@ -17,6 +17,8 @@
 #include <vector>
 #include <map>
 #include <set>
+#include <optional>
+#include <algorithm>
 #include <functional>
 
 #include "ILexer.h"
@@ -30,6 +32,7 @@
 #include "CharacterSet.h"
 #include "LexerModule.h"
 #include "OptionSet.h"
+#include "Checkpoints.h"
 #include "SubStyles.h"
 #include "DefaultLexer.h"
 
@@ -765,6 +768,7 @@ struct OptionsHTML {
 	bool foldComment = false;
 	bool foldHeredoc = false;
 	bool foldXmlAtTagOpen = false;
+	int checkpointLines = 64;
 };
 
 const char * const htmlWordListDesc[] = {
@@ -845,6 +849,12 @@ struct OptionSetHTML : public OptionSet<OptionsHTML> {
 			"Enable folding for XML at the start of open tag. "
 			"The default is off.");
 
+		DefineProperty("lexer.html.checkpoint.lines", &OptionsHTML::checkpointLines,
+			"Number of lines between saved copies of the lexer state. "
+			"Restyling inside a long tag or PHP heredoc resumes from the nearest copy "
+			"instead of rereading from where the tag or string started. "
+			"Set to 0 to turn off. The default is 64.");
+
 		DefineWordListSets(isPHPScript_ ? phpscriptWordListDesc : htmlWordListDesc);
 	}
 };
@@ -1045,6 +1055,37 @@ const char * const tagsThatDoNotFold[] = {
 
 }
 
+// Complete state of LexerHTML::Lex at the start of a line so lexing can resume there.
+struct CheckpointHTML {
+	std::string lastTag;
+	std::string prevWord;
+	PhpNumberState phpNumber;
+	std::string phpStringDelimiter;
+	int StateToPrint = SCE_H_DEFAULT;
+	int state = SCE_H_DEFAULT;
+	std::string makoBlockType;
+	int makoComment = 0;
+	std::string djangoBlockType;
+	script_mode inScriptType = eHtml;
+	bool tagOpened = false;
+	bool tagClosing = false;
+	bool tagDontFold = false;
+	script_type aspScript = eScriptNone;
+	script_type clientScript = eScriptNone;
+	int beforePreProc = 0;
+	bool isLanguageType = false;
+	int sgmlBlockLevel = 0;
+	script_type scriptLanguage = eScriptNone;
+	script_type beforeLanguage = eScriptNone;
+	int levelPrev = 0;
+	int levelCurrent = 0;
+	Sci_Position visibleChars = 0;
+	int lineStartVisibleChars = 0;
+	int chPrev = ' ';
+	int ch = ' ';
+	int chPrevNonWhite = ' ';
+};
+
 class LexerHTML : public DefaultLexer {
 	bool isXml;
 	bool isPHPScript;
@@ -1056,6 +1097,7 @@ class LexerHTML : public DefaultLexer {
 	WordList keywordsSGML; // SGML (DTD) keywords
 	OptionsHTML options;
 	OptionSetHTML osHTML;
+	Checkpoints<CheckpointHTML> checkpoints;
 	std::set<std::string> nonFoldingTags;
 	SubStyles subStyles{styleSubable,SubStylesHTML,SubStylesAvailable,0};
 public:
@@ -1068,6 +1110,7 @@ public:
 		isXml(isXml_),
 		isPHPScript(isPHPScript_),
 		osHTML(isPHPScript_),
+		checkpoints(options.checkpointLines),
 		nonFoldingTags(std::begin(tagsThatDoNotFold), std::end(tagsThatDoNotFold)) {
 	}
 	~LexerHTML() override {
@@ -1139,6 +1182,7 @@ public:
 
 Sci_Position SCI_METHOD LexerHTML::PropertySet(const char *key, const char *val) {
 	if (osHTML.PropertySet(&options, key, val)) {
+		checkpoints.SetInterval(options.checkpointLines);
 		return 0;
 	}
 	return -1;
@@ -1205,18 +1249,30 @@ void SCI_METHOD LexerHTML::Lex(Sci_PositionU startPos, Sci_Position length, int
 	std::string djangoBlockType;
 	// If inside a tag, it may be a script tag, so reread from the start of line starting tag to ensure any language tags are seen
 	// PHP string can be heredoc, must find a delimiter first. Reread from beginning of line containing the string, to get the correct lineState
+	// A checkpoint after that line holds everything learnt up to it so resume from there instead.
+	std::optional<CheckpointHTML> resume;
 	if (StyleNeedsBacktrack(state)) {
+		Sci_Position positionCheckpoint = 0;
+		const CheckpointHTML *checkpoint = checkpoints.Find(startPos, positionCheckpoint);
+		const Sci_Position endPos = startPos + length;
 		while ((startPos > 0) && (StyleNeedsBacktrack(styler.StyleIndexAt(startPos - 1)))) {
 			const Sci_Position backLineStart = styler.LineStart(styler.GetLine(startPos-1));
 			length += startPos - backLineStart;
 			startPos = backLineStart;
 		}
-		if (startPos > 0) {
+		if (checkpoint && (positionCheckpoint > static_cast<Sci_Position>(startPos))) {
+			resume = *checkpoint;
+			startPos = positionCheckpoint;
+			length = endPos - positionCheckpoint;
+			state = resume->state;
+		} else if (startPos > 0) {
 			state = styler.StyleIndexAt(startPos - 1);
 		} else {
 			state = isPHPScript ? SCE_HPHP_DEFAULT : SCE_H_DEFAULT;
 		}
 	}
+	// Text from startPos may have changed since checkpoints there were saved
+	checkpoints.Invalidate(startPos);
 	styler.StartAt(startPos);
 
 	/* Nothing handles getting out of these, so we need not start in any of them.
@@ -1302,9 +1358,56 @@ void SCI_METHOD LexerHTML::Lex(Sci_PositionU startPos, Sci_Position length, int
 		}
 	}
 
+	if (resume) {
+		lastTag = resume->lastTag;
+		prevWord = resume->prevWord;
+		phpNumber = resume->phpNumber;
+		phpStringDelimiter = resume->phpStringDelimiter;
+		StateToPrint = resume->StateToPrint;
+		state = resume->state;
+		makoBlockType = resume->makoBlockType;
+		makoComment = resume->makoComment;
+		djangoBlockType = resume->djangoBlockType;
+		inScriptType = resume->inScriptType;
+		tagOpened = resume->tagOpened;
+		tagClosing = resume->tagClosing;
+		tagDontFold = resume->tagDontFold;
+		aspScript = resume->aspScript;
+		clientScript = resume->clientScript;
+		beforePreProc = resume->beforePreProc;
+		isLanguageType = resume->isLanguageType;
+		sgmlBlockLevel = resume->sgmlBlockLevel;
+		scriptLanguage = resume->scriptLanguage;
+		beforeLanguage = resume->beforeLanguage;
+		levelPrev = resume->levelPrev;
+		levelCurrent = resume->levelCurrent;
+		visibleChars = resume->visibleChars;
+		lineStartVisibleChars = resume->lineStartVisibleChars;
+		chPrev = resume->chPrev;
+		ch = resume->ch;
+		chPrevNonWhite = resume->chPrevNonWhite;
+	}
+
+	Sci_Position lineCheckpoint = checkpoints.NextLine(lineCurrent - 1);
+	Sci_Position positionCheckpoint = (lineCheckpoint >= 0) ? styler.LineStart(lineCheckpoint) : -1;
+
 	styler.StartSegment(startPos);
 	const Sci_Position lengthDoc = startPos + length;
 	for (Sci_Position i = startPos; i < lengthDoc; i++) {
+		if ((positionCheckpoint >= 0) && (i >= positionCheckpoint)) {
+			// Only save at the start of a line, not when a multi-character token stepped over it
+			if ((i == positionCheckpoint) && (lineCurrent == lineCheckpoint)) {
+				checkpoints.Save(i, CheckpointHTML{
+					lastTag, prevWord, phpNumber, phpStringDelimiter, StateToPrint, state,
+					makoBlockType, makoComment, djangoBlockType, inScriptType,
+					tagOpened, tagClosing, tagDontFold, aspScript, clientScript,
+					beforePreProc, isLanguageType, sgmlBlockLevel, scriptLanguage, beforeLanguage,
+					levelPrev, levelCurrent, visibleChars, lineStartVisibleChars,
+					chPrev, ch, chPrevNonWhite });
+			}
+			lineCheckpoint = checkpoints.NextLine(styler.GetLine(i));
+			positionCheckpoint = styler.LineStart(lineCheckpoint);
+		}
 		const int chPrev2 = chPrev;
 		chPrev = ch;
 		if (!IsASpace(ch) && state != SCE_HJ_COMMENT &&
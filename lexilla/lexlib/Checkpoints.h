@@ -0,0 +1,82 @@
+// Scintilla source code edit control
+/** @file Checkpoints.h
+ ** Hold copies of a lexer's complete internal state at line starts.
+ ** A lexer that would otherwise backtrack many lines to find a safe restart point can
+ ** instead resume from the nearest checkpoint before the position it is asked to lex.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef CHECKPOINTS_H
+#define CHECKPOINTS_H
+
+namespace Lexilla {
+
+template <typename T>
+class Checkpoints {
+	struct Checkpoint {
+		Sci_Position position;
+		T value;
+		Checkpoint(Sci_Position position_, T value_) :
+			position(position_), value(std::move(value_)) {
+		}
+	};
+	typedef std::vector<Checkpoint> checkpointVector;
+	checkpointVector checkpoints;
+	Sci_Position interval;
+
+	typename checkpointVector::const_iterator After(Sci_Position position) const {
+		return std::upper_bound(checkpoints.begin(), checkpoints.end(), position,
+			[](Sci_Position pos, const Checkpoint &checkpoint) noexcept {
+				return pos < checkpoint.position;
+			});
+	}
+
+public:
+	// Checkpoints are taken every interval_ lines. 0 turns checkpoints off.
+	explicit Checkpoints(Sci_Position interval_=0) noexcept : interval(interval_) {
+	}
+	void SetInterval(Sci_Position interval_) {
+		if (interval != interval_) {
+			interval = interval_;
+			checkpoints.clear();
+		}
+	}
+	// The first line after line to checkpoint or -1 when checkpoints are off.
+	Sci_Position NextLine(Sci_Position line) const noexcept {
+		if (interval <= 0)
+			return -1;
+		return (line / interval + 1) * interval;
+	}
+	// Positions must be saved in increasing order, as happens when lexing.
+	void Save(Sci_Position position, T value) {
+		Invalidate(position);
+		checkpoints.emplace_back(position, std::move(value));
+	}
+	// Text at or after position may have changed so checkpoints there can not be trusted.
+	// Lexing only starts where the text before is unchanged, so each Lex call should
+	// invalidate from its start position.
+	void Invalidate(Sci_Position position) {
+		const typename checkpointVector::const_iterator low = After(position - 1);
+		checkpoints.erase(low, checkpoints.end());
+	}
+	// Find the checkpoint nearest to but not after position. Returns nullptr if none.
+	const T *Find(Sci_Position position, Sci_Position &positionCheckpoint) const {
+		const typename checkpointVector::const_iterator after = After(position);
+		if (after == checkpoints.begin())
+			return nullptr;
+		const Checkpoint &checkpoint = *(after - 1);
+		positionCheckpoint = checkpoint.position;
+		return &checkpoint.value;
+	}
+	void Clear() noexcept {
+		checkpoints.clear();
+	}
+	size_t size() const noexcept {
+		return checkpoints.size();
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,85 @@
+/** @file testCheckpoints.cxx
+ ** Unit Tests for Lexilla internal data structures
+ **/
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <memory>
+
+#include "Sci_Position.h"
+
+#include "Checkpoints.h"
+
+#include "catch.hpp"
+
+using namespace Lexilla;
+
+// Test Checkpoints.
+
+TEST_CASE("Checkpoints") {
+
+	Checkpoints<std::string> cp(4);
+	Sci_Position position = -1;
+
+	SECTION("IsEmptyInitially") {
+		REQUIRE(0u == cp.size());
+		REQUIRE(nullptr == cp.Find(100, position));
+		REQUIRE(-1 == position);
+	}
+
+	SECTION("NextLine") {
+		REQUIRE(4 == cp.NextLine(0));
+		REQUIRE(4 == cp.NextLine(3));
+		REQUIRE(8 == cp.NextLine(4));
+		cp.SetInterval(0);
+		REQUIRE(-1 == cp.NextLine(4));
+	}
+
+	SECTION("SaveAndFind") {
+		cp.Save(10, "a");
+		cp.Save(20, "b");
+		cp.Save(30, "c");
+		REQUIRE(3u == cp.size());
+		REQUIRE(nullptr == cp.Find(9, position));
+		REQUIRE("a" == *cp.Find(10, position));
+		REQUIRE(10 == position);
+		REQUIRE("a" == *cp.Find(19, position));
+		REQUIRE("b" == *cp.Find(20, position));
+		REQUIRE(20 == position);
+		REQUIRE("c" == *cp.Find(1000, position));
+		REQUIRE(30 == position);
+	}
+
+	SECTION("Invalidate") {
+		cp.Save(10, "a");
+		cp.Save(20, "b");
+		cp.Save(30, "c");
+		cp.Invalidate(21);
+		REQUIRE(2u == cp.size());
+		cp.Invalidate(20);
+		REQUIRE(1u == cp.size());
+		REQUIRE("a" == *cp.Find(25, position));
+		cp.Invalidate(0);
+		REQUIRE(0u == cp.size());
+	}
+
+	SECTION("SaveReplacesLater") {
+		cp.Save(10, "a");
+		cp.Save(20, "b");
+		cp.Save(30, "c");
+		cp.Save(20, "x");
+		REQUIRE(2u == cp.size());
+		REQUIRE("x" == *cp.Find(40, position));
+		REQUIRE(20 == position);
+	}
+
+	SECTION("ChangeIntervalClears") {
+		cp.Save(10, "a");
+		cp.SetInterval(4);
+		REQUIRE(1u == cp.size());
+		cp.SetInterval(8);
+		REQUIRE(0u == cp.size());
+	}
+}
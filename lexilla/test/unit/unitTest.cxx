@@ -6,6 +6,7 @@
     Currently tested:
         WordList
         SparseState
+        Checkpoints
 */
 
 #include <cstdio>
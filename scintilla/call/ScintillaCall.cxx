@@ -1551,6 +1551,26 @@ FindOption ScintillaCall::SearchFlags() {
 	return static_cast<Scintilla::FindOption>(Call(Message::GetSearchFlags));
 }
 
+Position ScintillaCall::FindAllInTarget(Position maxMatches, const char *text) {
+	return CallString(Message::FindAllInTarget, maxMatches, text);
+}
+
+Position ScintillaCall::CountAllInTarget(Position maxMatches, const char *text) {
+	return CallString(Message::CountAllInTarget, maxMatches, text);
+}
+
+Position ScintillaCall::FoundStart(Position index) {
+	return Call(Message::GetFoundStart, index);
+}
+
+Position ScintillaCall::FoundEnd(Position index) {
+	return Call(Message::GetFoundEnd, index);
+}
+
+void ScintillaCall::IndicatorFillFound() {
+	Call(Message::IndicatorFillFound);
+}
+
 void ScintillaCall::CallTipShow(Position pos, const char *definition) {
 	CallString(Message::CallTipShow, pos, definition);
 }
@@ -1763,6 +1783,22 @@ Wrap ScintillaCall::WrapMode() {
 	return static_cast<Scintilla::Wrap>(Call(Message::GetWrapMode));
 }
 
+void ScintillaCall::SetIdleWrapping(Scintilla::IdleWrapping idleWrapping) {
+	Call(Message::SetIdleWrapping, static_cast<uintptr_t>(idleWrapping));
+}
+
+IdleWrapping ScintillaCall::IdleWrapping() {
+	return static_cast<Scintilla::IdleWrapping>(Call(Message::GetIdleWrapping));
+}
+
+void ScintillaCall::SetEstimateWrapHeights(bool estimate) {
+	Call(Message::SetEstimateWrapHeights, estimate);
+}
+
+bool ScintillaCall::EstimateWrapHeights() {
+	return Call(Message::GetEstimateWrapHeights);
+}
+
 void ScintillaCall::SetWrapVisualFlags(Scintilla::WrapVisualFlag wrapVisualFlags) {
 	Call(Message::SetWrapVisualFlags, static_cast<uintptr_t>(wrapVisualFlags));
 }
@@ -2759,6 +2795,38 @@ int ScintillaCall::PositionCache() {
 	return static_cast<int>(Call(Message::GetPositionCache));
 }
 
+Position ScintillaCall::PositionCacheStatistic(Scintilla::PositionCacheStatistic statistic) {
+	return Call(Message::GetPositionCacheStatistic, static_cast<uintptr_t>(statistic));
+}
+
+void ScintillaCall::ClearPositionCacheStatistics() {
+	Call(Message::ClearPositionCacheStatistics);
+}
+
+void ScintillaCall::SetPositionCacheShared(bool shared) {
+	Call(Message::SetPositionCacheShared, shared);
+}
+
+bool ScintillaCall::PositionCacheShared() {
+	return Call(Message::GetPositionCacheShared);
+}
+
+void ScintillaCall::SetLineBitmapCache(int lines) {
+	Call(Message::SetLineBitmapCache, lines);
+}
+
+int ScintillaCall::LineBitmapCache() {
+	return static_cast<int>(Call(Message::GetLineBitmapCache));
+}
+
+void ScintillaCall::SetChunkedLayoutLength(Position length) {
+	Call(Message::SetChunkedLayoutLength, length);
+}
+
+Position ScintillaCall::ChunkedLayoutLength() {
+	return Call(Message::GetChunkedLayoutLength);
+}
+
 void ScintillaCall::SetLayoutThreads(int threads) {
 	Call(Message::SetLayoutThreads, threads);
 }
@@ -2767,6 +2835,14 @@ int ScintillaCall::LayoutThreads() {
 	return static_cast<int>(Call(Message::GetLayoutThreads));
 }
 
+Position ScintillaCall::LayoutThreadStatistic(Scintilla::LayoutThreadStatistic statistic) {
+	return Call(Message::GetLayoutThreadStatistic, static_cast<uintptr_t>(statistic));
+}
+
+void ScintillaCall::ClearLayoutThreadStatistics() {
+	Call(Message::ClearLayoutThreadStatistics);
+}
+
 void ScintillaCall::CopyAllowLine() {
 	Call(Message::CopyAllowLine);
 }
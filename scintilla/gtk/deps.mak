@@ -114,6 +114,15 @@ AutoComplete.o: \
 	../src/CharacterType.h \
 	../src/Position.h \
 	../src/AutoComplete.h
+BackgroundStyling.o: \
+	../src/BackgroundStyling.cxx \
+	../include/ScintillaTypes.h \
+	../include/ILexer.h \
+	../include/Sci_Position.h \
+	../src/Debugging.h \
+	../src/Position.h \
+	../src/UniConversion.h \
+	../src/BackgroundStyling.h
 CallTip.o: \
 	../src/CallTip.cxx \
 	../include/ScintillaTypes.h \
@@ -138,6 +147,7 @@ CellBuffer.o: \
 	../src/Debugging.h \
 	../src/Position.h \
 	../src/SplitVector.h \
+	../src/PieceTree.h \
 	../src/Partitioning.h \
 	../src/RunStyles.h \
 	../src/SparseVector.h \
@@ -207,8 +217,11 @@ Document.o: \
 	../src/CaseFolder.h \
 	../src/Document.h \
 	../src/RESearch.h \
+	../src/LinearRegex.h \
 	../src/UniConversion.h \
-	../src/ElapsedPeriod.h
+	../src/ElapsedPeriod.h \
+	../src/BackgroundStyling.h \
+	../src/ThreadPool.h
 EditModel.o: \
 	../src/EditModel.cxx \
 	../include/ScintillaTypes.h \
@@ -276,7 +289,8 @@ Editor.o: \
 	../src/MarginView.h \
 	../src/EditView.h \
 	../src/Editor.h \
-	../src/ElapsedPeriod.h
+	../src/ElapsedPeriod.h \
+	../src/ThreadPool.h
 EditView.o: \
 	../src/EditView.cxx \
 	../include/ScintillaTypes.h \
@@ -313,7 +327,8 @@ EditView.o: \
 	../src/EditModel.h \
 	../src/MarginView.h \
 	../src/EditView.h \
-	../src/ElapsedPeriod.h
+	../src/ElapsedPeriod.h \
+	../src/ThreadPool.h
 Geometry.o: \
 	../src/Geometry.cxx \
 	../src/Geometry.h
@@ -333,6 +348,12 @@ KeyMap.o: \
 	../src/Geometry.h \
 	../src/Platform.h \
 	../src/KeyMap.h
+LinearRegex.o: \
+	../src/LinearRegex.cxx \
+	../src/Position.h \
+	../src/CharClassify.h \
+	../src/UniConversion.h \
+	../src/LinearRegex.h
 LineMarker.o: \
 	../src/LineMarker.cxx \
 	../include/ScintillaTypes.h \
@@ -480,6 +501,9 @@ Style.o: \
 	../src/Geometry.h \
 	../src/Platform.h \
 	../src/Style.h
+ThreadPool.o: \
+	../src/ThreadPool.cxx \
+	../src/ThreadPool.h
 UndoHistory.o: \
 	../src/UndoHistory.cxx \
 	../include/ScintillaTypes.h \
@@ -525,6 +525,8 @@ typedef sptr_t (*SciFnDirectStatus)(sptr_t ptr, unsigned int iMessage, uptr_t wP
 #define SCFIND_REGEXP 0x00200000
 #define SCFIND_POSIX 0x00400000
 #define SCFIND_CXX11REGEX 0x00800000
+#define SCFIND_LINEARREGEX 0x01000000
+#define SCFIND_PARALLEL 0x02000000
 #define SCI_FINDTEXT 2150
 #define SCI_FINDTEXTFULL 2196
 #define SCI_FORMATRANGE 2151
@@ -604,6 +606,11 @@ typedef sptr_t (*SciFnDirectStatus)(sptr_t ptr, unsigned int iMessage, uptr_t wP
 #define SCI_SEARCHINTARGET 2197
 #define SCI_SETSEARCHFLAGS 2198
 #define SCI_GETSEARCHFLAGS 2199
+#define SCI_FINDALLINTARGET 2826
+#define SCI_COUNTALLINTARGET 2827
+#define SCI_GETFOUNDSTART 2828
+#define SCI_GETFOUNDEND 2829
+#define SCI_INDICATORFILLFOUND 2830
 #define SCI_CALLTIPSHOW 2200
 #define SCI_CALLTIPCANCEL 2201
 #define SCI_CALLTIPACTIVE 2202
@@ -680,6 +687,7 @@ typedef sptr_t (*SciFnDirectStatus)(sptr_t ptr, unsigned int iMessage, uptr_t wP
 #define SC_IDLESTYLING_TOVISIBLE 1
 #define SC_IDLESTYLING_AFTERVISIBLE 2
 #define SC_IDLESTYLING_ALL 3
+#define SC_IDLESTYLING_BACKGROUND 4
 #define SCI_SETIDLESTYLING 2692
 #define SCI_GETIDLESTYLING 2693
 #define SC_WRAP_NONE 0
@@ -688,6 +696,12 @@ typedef sptr_t (*SciFnDirectStatus)(sptr_t ptr, unsigned int iMessage, uptr_t wP
 #define SC_WRAP_WHITESPACE 3
 #define SCI_SETWRAPMODE 2268
 #define SCI_GETWRAPMODE 2269
+#define SC_IDLEWRAPPING_INCREMENTAL 0
+#define SC_IDLEWRAPPING_BACKGROUND 1
+#define SCI_SETIDLEWRAPPING 2822
+#define SCI_GETIDLEWRAPPING 2823
+#define SCI_SETESTIMATEWRAPHEIGHTS 2839
+#define SCI_GETESTIMATEWRAPHEIGHTS 2840
 #define SC_WRAPVISUALFLAG_NONE 0x0000
 #define SC_WRAPVISUALFLAG_END 0x0001
 #define SC_WRAPVISUALFLAG_START 0x0002
@@ -851,6 +865,7 @@ typedef sptr_t (*SciFnDirectStatus)(sptr_t ptr, unsigned int iMessage, uptr_t wP
 #define SC_DOCUMENTOPTION_DEFAULT 0
 #define SC_DOCUMENTOPTION_STYLES_NONE 0x1
 #define SC_DOCUMENTOPTION_TEXT_LARGE 0x100
+#define SC_DOCUMENTOPTION_PIECE_TREE 0x200
 #define SCI_CREATEDOCUMENT 2375
 #define SCI_ADDREFDOCUMENT 2376
 #define SCI_RELEASEDOCUMENT 2377
@@ -1002,8 +1017,26 @@ typedef sptr_t (*SciFnDirectStatus)(sptr_t ptr, unsigned int iMessage, uptr_t wP
 #define SCI_INDICATOREND 2509
 #define SCI_SETPOSITIONCACHE 2514
 #define SCI_GETPOSITIONCACHE 2515
+#define SC_POSITIONCACHESTATISTIC_HITS 0
+#define SC_POSITIONCACHESTATISTIC_MISSES 1
+#define SC_POSITIONCACHESTATISTIC_EVICTIONS 2
+#define SCI_GETPOSITIONCACHESTATISTIC 2831
+#define SCI_CLEARPOSITIONCACHESTATISTICS 2832
+#define SCI_SETPOSITIONCACHESHARED 2833
+#define SCI_GETPOSITIONCACHESHARED 2834
+#define SCI_SETLINEBITMAPCACHE 2835
+#define SCI_GETLINEBITMAPCACHE 2836
+#define SCI_SETCHUNKEDLAYOUTLENGTH 2837
+#define SCI_GETCHUNKEDLAYOUTLENGTH 2838
 #define SCI_SETLAYOUTTHREADS 2775
 #define SCI_GETLAYOUTTHREADS 2776
+#define SC_LAYOUTTHREADSTATISTIC_RUNS 0
+#define SC_LAYOUTTHREADSTATISTIC_TASKS 1
+#define SC_LAYOUTTHREADSTATISTIC_WORKERTASKS 2
+#define SC_LAYOUTTHREADSTATISTIC_THREADSCREATED 3
+#define SC_LAYOUTTHREADSTATISTIC_IDLEMICROSECONDS 4
+#define SCI_GETLAYOUTTHREADSTATISTIC 2824
+#define SCI_CLEARLAYOUTTHREADSTATISTICS 2825
 #define SCI_COPYALLOWLINE 2519
 #define SCI_CUTALLOWLINE 2810
 #define SCI_SETCOPYSEPARATOR 2811
@@ -1332,6 +1365,7 @@ typedef sptr_t (*SciFnDirectStatus)(sptr_t ptr, unsigned int iMessage, uptr_t wP
 #define SCN_AUTOCCOMPLETED 2030
 #define SCN_MARGINRIGHTCLICK 2031
 #define SCN_AUTOCSELECTIONCHANGE 2032
+#define SCN_WRAPPROGRESS 2033
 #ifndef SCI_DISABLE_PROVISIONAL
 #define SCALE_TECHNIQUE_DEFAULT 0
 #define SCALE_TECHNIQUE_PIXEL_ALIGNED 1
@@ -1436,7 +1470,7 @@ struct SCNotification {
 	/* SCN_HOTSPOTCLICK, SCN_HOTSPOTDOUBLECLICK, SCN_HOTSPOTRELEASECLICK, */
 	/* SCN_INDICATORCLICK, SCN_INDICATORRELEASE, */
 	/* SCN_USERLISTSELECTION, SCN_AUTOCCOMPLETED, SCN_AUTOCSELECTION, */
-	/* SCN_AUTOCSELECTIONCHANGE */
+	/* SCN_AUTOCSELECTIONCHANGE, SCN_WRAPPROGRESS */
 
 	int ch;
 	/* SCN_CHARADDED, SCN_KEY, SCN_AUTOCCOMPLETED, SCN_AUTOCSELECTION, */
@@ -1456,7 +1490,7 @@ struct SCNotification {
 	int message;	/* SCN_MACRORECORD */
 	uptr_t wParam;	/* SCN_MACRORECORD */
 	sptr_t lParam;	/* SCN_MACRORECORD */
-	Sci_Position line;		/* SCN_MODIFIED */
+	Sci_Position line;		/* SCN_MODIFIED, SCN_WRAPPROGRESS */
 	int foldLevelNow;	/* SCN_MODIFIED */
 	int foldLevelPrev;	/* SCN_MODIFIED */
 	int margin;		/* SCN_MARGINCLICK, SCN_MARGINRIGHTCLICK */
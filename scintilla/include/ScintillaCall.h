@@ -433,6 +433,11 @@ public:
 	Position SearchInTarget(Position length, const char *text);
 	void SetSearchFlags(Scintilla::FindOption searchFlags);
 	Scintilla::FindOption SearchFlags();
+	Position FindAllInTarget(Position maxMatches, const char *text);
+	Position CountAllInTarget(Position maxMatches, const char *text);
+	Position FoundStart(Position index);
+	Position FoundEnd(Position index);
+	void IndicatorFillFound();
 	void CallTipShow(Position pos, const char *definition);
 	void CallTipCancel();
 	bool CallTipActive();
@@ -486,6 +491,10 @@ public:
 	Scintilla::IdleStyling IdleStyling();
 	void SetWrapMode(Scintilla::Wrap wrapMode);
 	Scintilla::Wrap WrapMode();
+	void SetIdleWrapping(Scintilla::IdleWrapping idleWrapping);
+	Scintilla::IdleWrapping IdleWrapping();
+	void SetEstimateWrapHeights(bool estimate);
+	bool EstimateWrapHeights();
 	void SetWrapVisualFlags(Scintilla::WrapVisualFlag wrapVisualFlags);
 	Scintilla::WrapVisualFlag WrapVisualFlags();
 	void SetWrapVisualFlagsLocation(Scintilla::WrapVisualLocation wrapVisualFlagsLocation);
@@ -735,8 +744,18 @@ public:
 	Position IndicatorEnd(int indicator, Position pos);
 	void SetPositionCache(int size);
 	int PositionCache();
+	Position PositionCacheStatistic(Scintilla::PositionCacheStatistic statistic);
+	void ClearPositionCacheStatistics();
+	void SetPositionCacheShared(bool shared);
+	bool PositionCacheShared();
+	void SetLineBitmapCache(int lines);
+	int LineBitmapCache();
+	void SetChunkedLayoutLength(Position length);
+	Position ChunkedLayoutLength();
 	void SetLayoutThreads(int threads);
 	int LayoutThreads();
+	Position LayoutThreadStatistic(Scintilla::LayoutThreadStatistic statistic);
+	void ClearLayoutThreadStatistics();
 	void CopyAllowLine();
 	void CutAllowLine();
 	void SetCopySeparator(const char *separator);
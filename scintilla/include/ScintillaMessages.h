@@ -353,6 +353,11 @@ enum class Message {
 	SearchInTarget = 2197,
 	SetSearchFlags = 2198,
 	GetSearchFlags = 2199,
+	FindAllInTarget = 2826,
+	CountAllInTarget = 2827,
+	GetFoundStart = 2828,
+	GetFoundEnd = 2829,
+	IndicatorFillFound = 2830,
 	CallTipShow = 2200,
 	CallTipCancel = 2201,
 	CallTipActive = 2202,
@@ -405,6 +410,10 @@ enum class Message {
 	GetIdleStyling = 2693,
 	SetWrapMode = 2268,
 	GetWrapMode = 2269,
+	SetIdleWrapping = 2822,
+	GetIdleWrapping = 2823,
+	SetEstimateWrapHeights = 2839,
+	GetEstimateWrapHeights = 2840,
 	SetWrapVisualFlags = 2460,
 	GetWrapVisualFlags = 2461,
 	SetWrapVisualFlagsLocation = 2462,
@@ -648,8 +657,18 @@ enum class Message {
 	IndicatorEnd = 2509,
 	SetPositionCache = 2514,
 	GetPositionCache = 2515,
+	GetPositionCacheStatistic = 2831,
+	ClearPositionCacheStatistics = 2832,
+	SetPositionCacheShared = 2833,
+	GetPositionCacheShared = 2834,
+	SetLineBitmapCache = 2835,
+	GetLineBitmapCache = 2836,
+	SetChunkedLayoutLength = 2837,
+	GetChunkedLayoutLength = 2838,
 	SetLayoutThreads = 2775,
 	GetLayoutThreads = 2776,
+	GetLayoutThreadStatistic = 2824,
+	ClearLayoutThreadStatistics = 2825,
 	CopyAllowLine = 2519,
 	CutAllowLine = 2810,
 	SetCopySeparator = 2811,
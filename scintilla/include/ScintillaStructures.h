@@ -93,7 +93,7 @@ struct NotificationData {
 	/* SCN_HOTSPOTCLICK, SCN_HOTSPOTDOUBLECLICK, SCN_HOTSPOTRELEASECLICK, */
 	/* SCN_INDICATORCLICK, SCN_INDICATORRELEASE, */
 	/* SCN_USERLISTSELECTION, SCN_AUTOCCOMPLETED, SCN_AUTOCSELECTION, */
-	/* SCN_AUTOCSELECTIONCHANGE */
+	/* SCN_AUTOCSELECTIONCHANGE, SCN_WRAPPROGRESS */
 
 	int ch;
 	/* SCN_CHARADDED, SCN_KEY, SCN_AUTOCCOMPLETED, SCN_AUTOCSELECTION, */
@@ -113,7 +113,7 @@ struct NotificationData {
 	Message message;	/* SCN_MACRORECORD */
 	uptr_t wParam;	/* SCN_MACRORECORD */
 	sptr_t lParam;	/* SCN_MACRORECORD */
-	Position line;		/* SCN_MODIFIED */
+	Position line;		/* SCN_MODIFIED, SCN_WRAPPROGRESS */
 	FoldLevel foldLevelNow;	/* SCN_MODIFIED */
 	FoldLevel foldLevelPrev;	/* SCN_MODIFIED */
 	int margin;		/* SCN_MARGINCLICK, SCN_MARGINRIGHTCLICK */
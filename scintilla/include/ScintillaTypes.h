@@ -291,6 +291,8 @@ enum class FindOption {
 	RegExp = 0x00200000,
 	Posix = 0x00400000,
 	Cxx11RegEx = 0x00800000,
+	LinearRegEx = 0x01000000,
+	Parallel = 0x02000000,
 };
 
 enum class ChangeHistoryOption {
@@ -349,6 +351,7 @@ enum class IdleStyling {
 	ToVisible = 1,
 	AfterVisible = 2,
 	All = 3,
+	Background = 4,
 };
 
 enum class Wrap {
@@ -358,6 +361,11 @@ enum class Wrap {
 	WhiteSpace = 3,
 };
 
+enum class IdleWrapping {
+	Incremental = 0,
+	Background = 1,
+};
+
 enum class WrapVisualFlag {
 	None = 0x0000,
 	End = 0x0001,
@@ -426,6 +434,7 @@ enum class DocumentOption {
 	Default = 0,
 	StylesNone = 0x1,
 	TextLarge = 0x100,
+	PieceTree = 0x200,
 };
 
 enum class Status {
@@ -489,6 +498,20 @@ enum class CaretStyle {
 	BlockAfter = 0x100,
 };
 
+enum class PositionCacheStatistic {
+	Hits = 0,
+	Misses = 1,
+	Evictions = 2,
+};
+
+enum class LayoutThreadStatistic {
+	Runs = 0,
+	Tasks = 1,
+	WorkerTasks = 2,
+	ThreadsCreated = 3,
+	IdleMicroseconds = 4,
+};
+
 enum class MarginOption {
 	None = 0,
 	SubLineSelect = 1,
@@ -701,6 +724,7 @@ enum class Notification {
 	AutoCCompleted = 2030,
 	MarginRightClick = 2031,
 	AutoCSelectionChange = 2032,
+	WrapProgress = 2033,
 };
 //--Autogenerated -- end of section automatically generated from Scintilla.iface
 
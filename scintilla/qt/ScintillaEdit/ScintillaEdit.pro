@@ -26,6 +26,7 @@ SOURCES += \
     ../../src/UndoHistory.cxx \
     ../../src/UniqueString.cxx \
     ../../src/UniConversion.cxx \
+    ../../src/ThreadPool.cxx \
     ../../src/Style.cxx \
     ../../src/Selection.cxx \
     ../../src/ScintillaBase.cxx \
@@ -35,6 +36,7 @@ SOURCES += \
     ../../src/PerLine.cxx \
     ../../src/MarginView.cxx \
     ../../src/LineMarker.cxx \
+    ../../src/LinearRegex.cxx \
     ../../src/KeyMap.cxx \
     ../../src/Indicator.cxx \
     ../../src/Geometry.cxx \
@@ -53,6 +55,7 @@ SOURCES += \
     ../../src/CaseFolder.cxx \
     ../../src/CaseConvert.cxx \
     ../../src/CallTip.cxx \
+    ../../src/BackgroundStyling.cxx \
     ../../src/AutoComplete.cxx
 
 HEADERS  += \
@@ -24,6 +24,7 @@ SOURCES += \
     ../../src/UniqueString.cxx \
     ../../src/UniConversion.cxx \
     ../../src/UndoHistory.cxx \
+    ../../src/ThreadPool.cxx \
     ../../src/Style.cxx \
     ../../src/Selection.cxx \
     ../../src/ScintillaBase.cxx \
@@ -33,6 +34,7 @@ SOURCES += \
     ../../src/PerLine.cxx \
     ../../src/MarginView.cxx \
     ../../src/LineMarker.cxx \
+    ../../src/LinearRegex.cxx \
     ../../src/KeyMap.cxx \
     ../../src/Indicator.cxx \
     ../../src/Geometry.cxx \
@@ -51,6 +53,7 @@ SOURCES += \
     ../../src/CaseFolder.cxx \
     ../../src/CaseConvert.cxx \
     ../../src/CallTip.cxx \
+    ../../src/BackgroundStyling.cxx \
     ../../src/AutoComplete.cxx
 
 HEADERS  += \
@@ -61,6 +64,7 @@ HEADERS  += \
     ../../src/ViewStyle.h \
     ../../src/UndoHistory.h \
     ../../src/UniConversion.h \
+    ../../src/ThreadPool.h \
     ../../src/Style.h \
     ../../src/SplitVector.h \
     ../../src/Selection.h \
@@ -69,9 +73,11 @@ HEADERS  += \
     ../../src/RESearch.h \
     ../../src/PositionCache.h \
     ../../src/Platform.h \
+    ../../src/PieceTree.h \
     ../../src/PerLine.h \
     ../../src/Partitioning.h \
     ../../src/LineMarker.h \
+    ../../src/LinearRegex.h \
     ../../src/KeyMap.h \
     ../../src/Indicator.h \
     ../../src/Geometry.h \
@@ -87,6 +93,7 @@ HEADERS  += \
     ../../src/CaseFolder.h \
     ../../src/CaseConvert.h \
     ../../src/CallTip.h \
+    ../../src/BackgroundStyling.h \
     ../../src/AutoComplete.h \
     ../../include/Scintilla.h \
     ../../include/ILexer.h
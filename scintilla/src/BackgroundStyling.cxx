@@ -0,0 +1,434 @@
+// Scintilla source code edit control
+/** @file BackgroundStyling.cxx
+ ** Runs a lexer over a copy of a document on a worker thread.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <stdexcept>
+#include <utility>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#include "ScintillaTypes.h"
+#include "ILexer.h"
+
+#include "Debugging.h"
+
+#include "Position.h"
+#include "UniConversion.h"
+#include "BackgroundStyling.h"
+
+using namespace Scintilla;
+
+namespace Scintilla::Internal {
+
+namespace {
+
+constexpr Sci::Position NextTab(Sci::Position pos, Sci::Position tabSize) noexcept {
+	return ((pos / tabSize) + 1) * tabSize;
+}
+
+// Extend a range of lines [first, last] to include line. An empty range has last < first.
+void IncludeLine(Sci::Line &first, Sci::Line &last, Sci::Line line) noexcept {
+	if (last < first) {
+		first = line;
+		last = line;
+	} else {
+		first = std::min(first, line);
+		last = std::max(last, line);
+	}
+}
+
+LineValues ChangedLines(const std::vector<int> &values, Sci::Line first, Sci::Line last) {
+	LineValues changed;
+	if (first <= last) {
+		changed.first = first;
+		changed.values.assign(values.begin() + first, values.begin() + last + 1);
+	}
+	return changed;
+}
+
+}
+
+unsigned char StyleSnapshot::UCharAt(Sci::Position position) const noexcept {
+	if ((position < 0) || (position >= Length())) {
+		return 0;
+	}
+	return text[position];
+}
+
+Sci::Line StyleSnapshot::Lines() const noexcept {
+	return static_cast<Sci::Line>(lineStarts.size()) - 1;
+}
+
+StyleBatch StyleSnapshot::TakeChanges() {
+	StyleBatch batch = std::move(changes);
+	changes = StyleBatch();
+	if ((styleChangeStart >= 0) && (styleChangeStart < endStyled)) {
+		batch.styleStart = styleChangeStart;
+		batch.styles.assign(styles, styleChangeStart, endStyled - styleChangeStart);
+	} else {
+		batch.styleStart = endStyled;
+	}
+	styleChangeStart = Sci::invalidPosition;
+	batch.levels = ChangedLines(levels, levelFirst, levelLast);
+	batch.lineStates = ChangedLines(lineStates, stateFirst, stateLast);
+	levelLast = levelFirst - 1;
+	stateLast = stateFirst - 1;
+	return batch;
+}
+
+void SCI_METHOD StyleSnapshot::SetErrorStatus(int status) noexcept {
+	changes.errorStatus = status;
+}
+
+Sci_Position SCI_METHOD StyleSnapshot::Length() const noexcept {
+	return static_cast<Sci_Position>(text.length());
+}
+
+void SCI_METHOD StyleSnapshot::GetCharRange(char *buffer, Sci_Position position, Sci_Position lengthRetrieve) const {
+	if ((position < 0) || (lengthRetrieve <= 0) || (position + lengthRetrieve > Length())) {
+		return;
+	}
+	memcpy(buffer, text.data() + position, lengthRetrieve);
+}
+
+char SCI_METHOD StyleSnapshot::StyleAt(Sci_Position position) const noexcept {
+	if ((position < 0) || (position >= Length())) {
+		return 0;
+	}
+	return styles[position];
+}
+
+Sci_Position SCI_METHOD StyleSnapshot::LineFromPosition(Sci_Position position) const noexcept {
+	if (position <= 0) {
+		return 0;
+	}
+	// Last line start at or before position
+	const std::vector<Sci::Position>::const_iterator it =
+		std::upper_bound(lineStarts.begin(), lineStarts.end() - 1, position);
+	return (it - lineStarts.begin()) - 1;
+}
+
+Sci_Position SCI_METHOD StyleSnapshot::LineStart(Sci_Position line) const noexcept {
+	if (line < 0) {
+		return 0;
+	}
+	if (line >= Lines()) {
+		return Length();
+	}
+	return lineStarts[line];
+}
+
+int SCI_METHOD StyleSnapshot::GetLevel(Sci_Position line) const noexcept {
+	if ((line >= 0) && (line < static_cast<Sci::Line>(levels.size()))) {
+		return levels[line];
+	}
+	return static_cast<int>(FoldLevel::Base);
+}
+
+int SCI_METHOD StyleSnapshot::SetLevel(Sci_Position line, int level) noexcept {
+	if ((line >= 0) && (line < static_cast<Sci::Line>(levels.size()))) {
+		const int prev = levels[line];
+		if (prev != level) {
+			levels[line] = level;
+			IncludeLine(levelFirst, levelLast, line);
+		}
+		return prev;
+	}
+	return 0;
+}
+
+int SCI_METHOD StyleSnapshot::GetLineState(Sci_Position line) const noexcept {
+	if ((line >= 0) && (line < static_cast<Sci::Line>(lineStates.size()))) {
+		return lineStates[line];
+	}
+	return 0;
+}
+
+int SCI_METHOD StyleSnapshot::SetLineState(Sci_Position line, int state) noexcept {
+	if ((line >= 0) && (line < static_cast<Sci::Line>(lineStates.size()))) {
+		const int statePrevious = lineStates[line];
+		if (state != statePrevious) {
+			lineStates[line] = state;
+			IncludeLine(stateFirst, stateLast, line);
+		}
+		return statePrevious;
+	}
+	return 0;
+}
+
+void SCI_METHOD StyleSnapshot::StartStyling(Sci_Position position) noexcept {
+	endStyled = std::clamp<Sci::Position>(position, 0, Length());
+	if ((styleChangeStart < 0) || (endStyled < styleChangeStart)) {
+		styleChangeStart = endStyled;
+	}
+}
+
+bool SCI_METHOD StyleSnapshot::SetStyleFor(Sci_Position length, char style) noexcept {
+	if ((length < 0) || (endStyled + length > Length())) {
+		return false;
+	}
+	std::fill_n(styles.begin() + endStyled, length, style);
+	endStyled += length;
+	return true;
+}
+
+bool SCI_METHOD StyleSnapshot::SetStyles(Sci_Position length, const char *styles_) noexcept {
+	if ((length < 0) || (endStyled + length > Length())) {
+		return false;
+	}
+	std::copy_n(styles_, length, styles.begin() + endStyled);
+	endStyled += length;
+	return true;
+}
+
+void SCI_METHOD StyleSnapshot::DecorationSetCurrentIndicator(int indicator) noexcept {
+	currentIndicator = indicator;
+}
+
+void SCI_METHOD StyleSnapshot::DecorationFillRange(Sci_Position position, int value, Sci_Position fillLength) {
+	changes.fills.push_back({ currentIndicator, position, value, fillLength });
+}
+
+void SCI_METHOD StyleSnapshot::ChangeLexerState(Sci_Position start, Sci_Position end) {
+	changes.lexerStateChanges.emplace_back(start, end);
+}
+
+int SCI_METHOD StyleSnapshot::CodePage() const noexcept {
+	return codePage;
+}
+
+bool SCI_METHOD StyleSnapshot::IsDBCSLeadByte(char) const noexcept {
+	return false;
+}
+
+const char *SCI_METHOD StyleSnapshot::BufferPointer() noexcept {
+	return text.c_str();
+}
+
+int SCI_METHOD StyleSnapshot::GetLineIndentation(Sci_Position line) noexcept {
+	int indent = 0;
+	if ((line >= 0) && (line < Lines())) {
+		const Sci::Position length = Length();
+		for (Sci::Position i = LineStart(line); i < length; i++) {
+			const char ch = text[i];
+			if (ch == ' ')
+				indent++;
+			else if (ch == '\t')
+				indent = static_cast<int>(NextTab(indent, tabInChars));
+			else
+				return indent;
+		}
+	}
+	return indent;
+}
+
+Sci_Position SCI_METHOD StyleSnapshot::LineEnd(Sci_Position line) const noexcept {
+	if (line >= Lines() - 1) {
+		return LineStart(line + 1);
+	}
+	Sci::Position position = LineStart(line + 1);
+	if (unicodeLineEnds) {
+		const unsigned char bytes[] = {
+			UCharAt(position - 3),
+			UCharAt(position - 2),
+			UCharAt(position - 1),
+		};
+		if (UTF8IsSeparator(bytes)) {
+			return position - UTF8SeparatorLength;
+		}
+		if (UTF8IsNEL(bytes + 1)) {
+			return position - UTF8NELLength;
+		}
+	}
+	position--; // Back over CR or LF
+	// When line terminator is CR+LF, may need to go back one more
+	if ((position > LineStart(line)) && (text[position - 1] == '\r')) {
+		position--;
+	}
+	return position;
+}
+
+// Return -1 on out-of-bounds
+Sci_Position SCI_METHOD StyleSnapshot::GetRelativePosition(Sci_Position positionStart, Sci_Position characterOffset) const noexcept {
+	Sci::Position pos = positionStart;
+	if (codePage == CpUtf8) {
+		while (characterOffset > 0) {
+			if (pos >= Length())
+				return Sci::invalidPosition;
+			Sci_Position width = 1;
+			GetCharacterAndWidth(pos, &width);
+			pos += width;
+			characterOffset--;
+		}
+		while (characterOffset < 0) {
+			if (pos <= 0)
+				return Sci::invalidPosition;
+			// Back over trail bytes to a lead byte that starts a valid character ending at pos
+			Sci::Position posPrevious = pos - 1;
+			for (Sci::Position lead = pos - 1; (lead >= 0) && (lead >= pos - UTF8MaxBytes); lead--) {
+				if (!UTF8IsTrailByte(UCharAt(lead))) {
+					Sci_Position width = 1;
+					GetCharacterAndWidth(lead, &width);
+					if (lead + width == pos)
+						posPrevious = lead;
+					break;
+				}
+			}
+			pos = posPrevious;
+			characterOffset++;
+		}
+	} else {
+		pos = positionStart + characterOffset;
+		if ((pos < 0) || (pos > Length()))
+			return Sci::invalidPosition;
+	}
+	return pos;
+}
+
+int SCI_METHOD StyleSnapshot::GetCharacterAndWidth(Sci_Position position, Sci_Position *pWidth) const noexcept {
+	int bytesInCharacter = 1;
+	const unsigned char leadByte = UCharAt(position);
+	int character = leadByte;
+	if ((codePage == CpUtf8) && !UTF8IsAscii(leadByte)) {
+		const int widthCharBytes = UTF8BytesOfLead[leadByte];
+		unsigned char charBytes[UTF8MaxBytes] = {leadByte,0,0,0};
+		for (int b=1; b<widthCharBytes; b++)
+			charBytes[b] = UCharAt(position+b);
+		const int utf8status = UTF8Classify(charBytes, widthCharBytes);
+		if (utf8status & UTF8MaskInvalid) {
+			// Report as singleton surrogate values which are invalid Unicode
+			character =  0xDC80 + leadByte;
+		} else {
+			bytesInCharacter = utf8status & UTF8MaskWidth;
+			character = UnicodeFromUTF8(charBytes);
+		}
+	}
+	if (pWidth) {
+		*pWidth = bytesInCharacter;
+	}
+	return character;
+}
+
+BackgroundStyling::~BackgroundStyling() noexcept {
+	Stop();
+}
+
+void BackgroundStyling::Run(ILexer5 *lexer) noexcept {
+	try {
+		const Sci::Position length = snapshot->Length();
+		Sci::Position start = next;
+		while (!cancel && (start < length)) {
+			// Always end at a line start so the next batch can start from its style
+			const Sci::Line lineEnd = snapshot->LineFromPosition(std::min(start + batchBytes, length)) + 1;
+			const Sci::Position end = snapshot->LineStart(lineEnd);
+			int styleStart = 0;
+			if (start > 0)
+				styleStart = snapshot->StyleAt(start - 1);
+			snapshot->StartStyling(start);
+			lexer->Lex(start, end - start, styleStart, snapshot.get());
+			lexer->Fold(start, end - start, styleStart, snapshot.get());
+			StyleBatch batch = snapshot->TakeChanges();
+			batch.lexEnd = end;
+			{
+				std::lock_guard<std::mutex> guard(mutexBatches);
+				batches.push_back(std::move(batch));
+			}
+			batchReady.notify_one();
+			start = end;
+			next = end;
+		}
+	} catch (...) {
+		std::lock_guard<std::mutex> guard(mutexBatches);
+		failed = true;
+	}
+	{
+		std::lock_guard<std::mutex> guard(mutexBatches);
+		finished = true;
+	}
+	batchReady.notify_one();
+}
+
+void BackgroundStyling::Start(std::unique_ptr<StyleSnapshot> snapshot_, ILexer5 *lexer, Sci::Position start) {
+	Stop();
+	snapshot = std::move(snapshot_);
+	Resume(lexer, start);
+}
+
+void BackgroundStyling::Resume(ILexer5 *lexer, Sci::Position start) {
+	Stop();
+	if (!snapshot) {
+		return;
+	}
+	next = start;
+	cancel = false;
+	finished = false;
+	failed = false;
+	worker = std::thread([this, lexer]() {
+		Run(lexer);
+	});
+}
+
+void BackgroundStyling::Cancel() noexcept {
+	cancel = true;
+}
+
+void BackgroundStyling::Stop() noexcept {
+	if (worker.joinable()) {
+		cancel = true;
+		try {
+			worker.join();
+		} catch (...) {
+			// Only fails when thread not joinable
+		}
+	}
+}
+
+void BackgroundStyling::DiscardBatches() noexcept {
+	Stop();
+	std::lock_guard<std::mutex> guard(mutexBatches);
+	batches.clear();
+}
+
+void BackgroundStyling::Discard() noexcept {
+	DiscardBatches();
+	snapshot.reset();
+}
+
+bool BackgroundStyling::Running() noexcept {
+	std::lock_guard<std::mutex> guard(mutexBatches);
+	return worker.joinable() && !finished;
+}
+
+bool BackgroundStyling::Failed() noexcept {
+	std::lock_guard<std::mutex> guard(mutexBatches);
+	return failed;
+}
+
+std::vector<StyleBatch> BackgroundStyling::TakeBatches(std::chrono::milliseconds timeout) {
+	std::unique_lock<std::mutex> lock(mutexBatches);
+	if (batches.empty() && worker.joinable() && !finished) {
+		batchReady.wait_for(lock, timeout, [this]() noexcept {
+			return !batches.empty() || finished;
+		});
+	}
+	std::vector<StyleBatch> taken;
+	taken.swap(batches);
+	return taken;
+}
+
+}
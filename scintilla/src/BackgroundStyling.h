@@ -0,0 +1,165 @@
+// Scintilla source code edit control
+/** @file BackgroundStyling.h
+ ** Runs a lexer over a copy of a document on a worker thread.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef BACKGROUNDSTYLING_H
+#define BACKGROUNDSTYLING_H
+
+namespace Scintilla::Internal {
+
+// Per-line values changed by lexing or folding for a contiguous range of lines.
+struct LineValues {
+	Sci::Line first = 0;
+	std::vector<int> values;
+};
+
+// Indicator fill requested by a lexer.
+struct DecorationFill {
+	int indicator = 0;
+	Sci::Position position = 0;
+	int value = 0;
+	Sci::Position fillLength = 0;
+};
+
+// Results of lexing and folding a range of a snapshot to be applied to the document.
+struct StyleBatch {
+	Sci::Position styleStart = 0;
+	Sci::Position lexEnd = 0;	// Line start where lexing of the batch ended
+	std::string styles;
+	LineValues levels;
+	LineValues lineStates;
+	std::vector<DecorationFill> fills;
+	std::vector<std::pair<Sci::Position, Sci::Position>> lexerStateChanges;
+	int errorStatus = 0;
+};
+
+/**
+ * A copy of the text, styles, and per-line values of a document that a lexer can
+ * work on without touching the document. Changes made by the lexer are collected
+ * by TakeChanges.
+ * Only single byte and UTF-8 documents are supported as DBCS character navigation
+ * is not duplicated.
+ */
+class StyleSnapshot : public Scintilla::IDocument {
+	Sci::Position endStyled = 0;
+	Sci::Position styleChangeStart = Sci::invalidPosition;	// Lowest position styled since TakeChanges
+	Sci::Line levelFirst = 0;
+	Sci::Line levelLast = -1;
+	Sci::Line stateFirst = 0;
+	Sci::Line stateLast = -1;
+	int currentIndicator = 0;
+	StyleBatch changes;
+	[[nodiscard]] unsigned char UCharAt(Sci::Position position) const noexcept;
+	[[nodiscard]] Sci::Line Lines() const noexcept;
+public:
+	// Filled in by the document before styling
+	std::string text;
+	std::string styles;
+	std::vector<Sci::Position> lineStarts;	// Includes an entry for the end of the document
+	std::vector<int> levels;
+	std::vector<int> lineStates;
+	int codePage = 0;
+	bool unicodeLineEnds = false;
+	int tabInChars = 8;
+
+	StyleSnapshot() noexcept = default;
+	// Deleted so StyleSnapshot objects can not be copied.
+	StyleSnapshot(const StyleSnapshot &) = delete;
+	StyleSnapshot(StyleSnapshot &&) = delete;
+	StyleSnapshot &operator=(const StyleSnapshot &) = delete;
+	StyleSnapshot &operator=(StyleSnapshot &&) = delete;
+	virtual ~StyleSnapshot() noexcept = default;
+
+	// Return the changes since the previous call and start collecting afresh.
+	StyleBatch TakeChanges();
+
+	int SCI_METHOD Version() const noexcept override {
+		return Scintilla::dvRelease4;
+	}
+	void SCI_METHOD SetErrorStatus(int status) noexcept override;
+	Sci_Position SCI_METHOD Length() const noexcept override;
+	void SCI_METHOD GetCharRange(char *buffer, Sci_Position position, Sci_Position lengthRetrieve) const override;
+	char SCI_METHOD StyleAt(Sci_Position position) const noexcept override;
+	Sci_Position SCI_METHOD LineFromPosition(Sci_Position position) const noexcept override;
+	Sci_Position SCI_METHOD LineStart(Sci_Position line) const noexcept override;
+	int SCI_METHOD GetLevel(Sci_Position line) const noexcept override;
+	int SCI_METHOD SetLevel(Sci_Position line, int level) noexcept override;
+	int SCI_METHOD GetLineState(Sci_Position line) const noexcept override;
+	int SCI_METHOD SetLineState(Sci_Position line, int state) noexcept override;
+	void SCI_METHOD StartStyling(Sci_Position position) noexcept override;
+	bool SCI_METHOD SetStyleFor(Sci_Position length, char style) noexcept override;
+	bool SCI_METHOD SetStyles(Sci_Position length, const char *styles) noexcept override;
+	void SCI_METHOD DecorationSetCurrentIndicator(int indicator) noexcept override;
+	void SCI_METHOD DecorationFillRange(Sci_Position position, int value, Sci_Position fillLength) override;
+	void SCI_METHOD ChangeLexerState(Sci_Position start, Sci_Position end) override;
+	int SCI_METHOD CodePage() const noexcept override;
+	bool SCI_METHOD IsDBCSLeadByte(char ch) const noexcept override;
+	const char *SCI_METHOD BufferPointer() noexcept override;
+	int SCI_METHOD GetLineIndentation(Sci_Position line) noexcept override;
+	Sci_Position SCI_METHOD LineEnd(Sci_Position line) const noexcept override;
+	Sci_Position SCI_METHOD GetRelativePosition(Sci_Position positionStart, Sci_Position characterOffset) const noexcept override;
+	int SCI_METHOD GetCharacterAndWidth(Sci_Position position, Sci_Position *pWidth) const noexcept override;
+};
+
+/**
+ * Lexes and folds a StyleSnapshot on a worker thread, publishing the results in
+ * batches of whole lines for the main thread to apply to the document.
+ * The lexer must not be called by any other thread between Start and Stop.
+ */
+class BackgroundStyling {
+	std::unique_ptr<StyleSnapshot> snapshot;
+	Sci::Position next = 0;	// Where styling continues, only read when worker not running
+	std::thread worker;
+	std::mutex mutexBatches;
+	std::condition_variable batchReady;
+	std::vector<StyleBatch> batches;
+	bool finished = false;
+	bool failed = false;
+	std::atomic<bool> cancel = false;
+	void Run(Scintilla::ILexer5 *lexer) noexcept;
+public:
+	// Approximate amount of text lexed for each batch
+	static constexpr Sci::Position batchBytes = 0x10000;
+
+	BackgroundStyling() noexcept = default;
+	// Deleted so BackgroundStyling objects can not be copied.
+	BackgroundStyling(const BackgroundStyling &) = delete;
+	BackgroundStyling(BackgroundStyling &&) = delete;
+	BackgroundStyling &operator=(const BackgroundStyling &) = delete;
+	BackgroundStyling &operator=(BackgroundStyling &&) = delete;
+	~BackgroundStyling() noexcept;
+
+	// Start styling snapshot_ from start which should be the start of a line.
+	void Start(std::unique_ptr<StyleSnapshot> snapshot_, Scintilla::ILexer5 *lexer, Sci::Position start);
+	// Continue styling the current snapshot from start after Stop.
+	void Resume(Scintilla::ILexer5 *lexer, Sci::Position start);
+	// Ask the worker to stop after its current batch without waiting.
+	void Cancel() noexcept;
+	// Stop the worker and wait for it to finish. Published batches and the snapshot are retained.
+	void Stop() noexcept;
+	// Stop the worker and discard published batches, keeping the snapshot to be updated.
+	void DiscardBatches() noexcept;
+	// Discard published batches and the snapshot.
+	void Discard() noexcept;
+	// The snapshot being styled or nullptr. Only valid when worker not running.
+	[[nodiscard]] StyleSnapshot *Snapshot() const noexcept {
+		return snapshot.get();
+	}
+	// Where styling stopped. Only valid when worker not running.
+	[[nodiscard]] Sci::Position Next() const noexcept {
+		return next;
+	}
+	// True when a worker has been started and has not finished.
+	[[nodiscard]] bool Running() noexcept;
+	// True when a worker stopped because of an exception.
+	[[nodiscard]] bool Failed() noexcept;
+	// Return published batches, waiting up to timeout for one if none are ready.
+	std::vector<StyleBatch> TakeBatches(std::chrono::milliseconds timeout);
+};
+
+}
+
+#endif
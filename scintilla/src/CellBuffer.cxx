@@ -21,14 +21,22 @@
 #include <optional>
 #include <algorithm>
 #include <memory>
+#include <atomic>
+#include <array>
 #include <type_traits>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CELLBUFFER_SSE2
+#endif
+
 #include "ScintillaTypes.h"
 
 #include "Debugging.h"
 
 #include "Position.h"
 #include "SplitVector.h"
+#include "PieceTree.h"
 #include "Partitioning.h"
 #include "RunStyles.h"
 #include "SparseVector.h"
@@ -77,6 +85,7 @@ public:
 	virtual void InsertLines(Sci::Line line, const Sci::Position *positions, size_t lines, bool lineStart) = 0;
 	virtual void SetLineStart(Sci::Line line, Sci::Position position) noexcept = 0;
 	virtual void RemoveLine(Sci::Line line) = 0;
+	virtual void RemoveLines(Sci::Line line, Sci::Line lines) = 0;
 	virtual Sci::Line Lines() const noexcept = 0;
 	virtual void AllocateLines(Sci::Line lines) = 0;
 	virtual Sci::Line LineFromPosition(Sci::Position pos) const noexcept = 0;
@@ -148,9 +157,11 @@ public:
 		// The line widths will be fixed up by later measuring code.
 		const POS lineAsPos = line_cast(line);
 		const POS lineStart = starts.PositionFromPartition(lineAsPos - 1) + 1;
+		std::vector<POS> positions(lines);
 		for (POS l = 0; l < line_cast(lines); l++) {
-			starts.InsertPartition(lineAsPos + l, lineStart + l);
+			positions[l] = lineStart + l;
 		}
+		starts.InsertPartitions(lineAsPos, positions.data(), positions.size());
 	}
 };
 
@@ -250,6 +261,18 @@ public:
 			perLine->RemoveLine(line);
 		}
 	}
+	void RemoveLines(Sci::Line line, Sci::Line lines) override {
+		starts.RemovePartitions(pos_cast(line), pos_cast(lines));
+		if (FlagSet(activeIndices, LineCharacterIndexType::Utf32)) {
+			startsUTF32.starts.RemovePartitions(pos_cast(line), pos_cast(lines));
+		}
+		if (FlagSet(activeIndices, LineCharacterIndexType::Utf16)) {
+			startsUTF16.starts.RemovePartitions(pos_cast(line), pos_cast(lines));
+		}
+		if (perLine) {
+			perLine->RemoveLines(line, lines);
+		}
+	}
 	Sci::Line Lines() const noexcept override {
 		return line_from_pos_cast(starts.Partitions());
 	}
@@ -332,8 +355,14 @@ public:
 	}
 };
 
-CellBuffer::CellBuffer(bool hasStyles_, bool largeDocument_) :
+CellBuffer::CellBuffer(bool hasStyles_, bool largeDocument_, bool pieceTree_) :
 	hasStyles(hasStyles_), largeDocument(largeDocument_) {
+	if (pieceTree_) {
+		substancePieces = std::make_unique<PieceTree<char>>();
+		if (hasStyles) {
+			stylePieces = std::make_unique<PieceTree<char>>();
+		}
+	}
 	readOnly = false;
 	utf8Substance = false;
 	utf8LineEnds = LineEndType::Default;
@@ -348,11 +377,14 @@ CellBuffer::CellBuffer(bool hasStyles_, bool largeDocument_) :
 CellBuffer::~CellBuffer() noexcept = default;
 
 char CellBuffer::CharAt(Sci::Position position) const noexcept {
+	if (substancePieces) {
+		return substancePieces->ValueAt(position);
+	}
 	return substance.ValueAt(position);
 }
 
 unsigned char CellBuffer::UCharAt(Sci::Position position) const noexcept {
-	return substance.ValueAt(position);
+	return CharAt(position);
 }
 
 void CellBuffer::GetCharRange(char *buffer, Sci::Position position, Sci::Position lengthRetrieve) const {
@@ -360,18 +392,28 @@ void CellBuffer::GetCharRange(char *buffer, Sci::Position position, Sci::Positio
 		return;
 	if (position < 0)
 		return;
-	if ((position + lengthRetrieve) > substance.Length()) {
+	if ((position + lengthRetrieve) > Length()) {
 		Platform::DebugPrintf("Bad GetCharRange %.0f for %.0f of %.0f\n",
 				      static_cast<double>(position),
 				      static_cast<double>(lengthRetrieve),
-				      static_cast<double>(substance.Length()));
+				      static_cast<double>(Length()));
+		return;
+	}
+	if (substancePieces) {
+		substancePieces->GetRange(buffer, position, lengthRetrieve);
 		return;
 	}
 	substance.GetRange(buffer, position, lengthRetrieve);
 }
 
 char CellBuffer::StyleAt(Sci::Position position) const noexcept {
-	return hasStyles ? style.ValueAt(position) : '\0';
+	if (!hasStyles) {
+		return '\0';
+	}
+	if (stylePieces) {
+		return stylePieces->ValueAt(position);
+	}
+	return style.ValueAt(position);
 }
 
 void CellBuffer::GetStyleRange(unsigned char *buffer, Sci::Position position, Sci::Position lengthRetrieve) const {
@@ -383,30 +425,50 @@ void CellBuffer::GetStyleRange(unsigned char *buffer, Sci::Position position, Sc
 		std::fill(buffer, buffer + lengthRetrieve, static_cast<unsigned char>(0));
 		return;
 	}
-	if ((position + lengthRetrieve) > style.Length()) {
+	if ((position + lengthRetrieve) > Length()) {
 		Platform::DebugPrintf("Bad GetStyleRange %.0f for %.0f of %.0f\n",
 				      static_cast<double>(position),
 				      static_cast<double>(lengthRetrieve),
-				      static_cast<double>(style.Length()));
+				      static_cast<double>(Length()));
+		return;
+	}
+	if (stylePieces) {
+		stylePieces->GetRange(reinterpret_cast<char *>(buffer), position, lengthRetrieve);
 		return;
 	}
 	style.GetRange(reinterpret_cast<char *>(buffer), position, lengthRetrieve);
 }
 
 const char *CellBuffer::BufferPointer() {
+	if (substancePieces) {
+		return substancePieces->BufferPointer();
+	}
 	return substance.BufferPointer();
 }
 
 const char *CellBuffer::RangePointer(Sci::Position position, Sci::Position rangeLength) noexcept {
+	if (substancePieces) {
+		return substancePieces->RangePointer(position, rangeLength);
+	}
 	return substance.RangePointer(position, rangeLength);
 }
 
 Sci::Position CellBuffer::GapPosition() const noexcept {
+	if (substancePieces) {
+		// No gap so treat as all before gap
+		return substancePieces->Length();
+	}
 	return substance.GapPosition();
 }
 
+// Only for text held in a gap buffer: piece tree text is read with SegmentPointer
+// as making it contiguous would copy the whole document.
 SplitView CellBuffer::AllView() const noexcept {
-	const size_t length = substance.Length();
+	PLATFORM_ASSERT(!substancePieces);
+	if (substancePieces) {
+		return {};
+	}
+	const size_t length = Length();
 	size_t length1 = substance.GapPosition();
 	if (length1 == 0) {
 		// Assign segment2 to segment1 / length1 to avoid useless test against 0 length1
@@ -420,6 +482,21 @@ SplitView CellBuffer::AllView() const noexcept {
 	};
 }
 
+// Pointer to position and the number of bytes from there that are contiguous, up to
+// the gap or the end of a piece, so text can be read in place without rearranging it.
+const char *CellBuffer::SegmentPointer(Sci::Position position, Sci::Position &segmentLength) const noexcept {
+	if (substancePieces) {
+		return substancePieces->SegmentPointer(position, segmentLength);
+	}
+	const Sci::Position gap = substance.GapPosition();
+	segmentLength = (position < gap) ? gap - position : Length() - position;
+	if ((position < 0) || (segmentLength <= 0)) {
+		segmentLength = 0;
+		return "";
+	}
+	return substance.ElementPointer(position);
+}
+
 // The char* returned is to an allocation owned by the undo history
 const char *CellBuffer::InsertString(Sci::Position position, const char *s, Sci::Position insertLength, bool &startSequence) {
 	// InsertString and DeleteChars are the bottleneck though which all changes occur
@@ -500,6 +577,15 @@ ChangedRange CellBuffer::SetStyles(Sci::Position position, const char *styles, S
 		return {};
 	}
 
+	if (stylePieces) {
+		ChangedRange cr;
+		stylePieces->ForEachSegment(position, length, [&cr, styles, position](char *segment, ptrdiff_t lengthSegment, ptrdiff_t start) noexcept {
+			cr.Merge(CopyBytes(segment, styles + start - position, lengthSegment, start));
+			return true;
+		});
+		return cr;
+	}
+
 	const Lengths lengths = SplitUpdate(style, position, length);
 	ChangedRange cr = CopyBytes(&style[position], styles, lengths.length1, position);
 	if (lengths.length2) {
@@ -515,6 +601,15 @@ ChangedRange CellBuffer::SetStyleFor(Sci::Position position, Sci::Position lengt
 		return {};
 	}
 
+	if (stylePieces) {
+		ChangedRange cr;
+		stylePieces->ForEachSegment(position, length, [&cr, value](char *segment, ptrdiff_t lengthSegment, ptrdiff_t start) noexcept {
+			cr.Merge(SetBytes(segment, value, lengthSegment, start));
+			return true;
+		});
+		return cr;
+	}
+
 	const Lengths lengths = SplitUpdate(style, position, length);
 	ChangedRange cr = SetBytes(&style[position], value, lengths.length1, position);
 	if (lengths.length2) {
@@ -534,7 +629,7 @@ const char *CellBuffer::DeleteChars(Sci::Position position, Sci::Position delete
 		if (collectingUndo) {
 			// Save into the undo/redo stack, but only the characters - not the formatting
 			// The gap would be moved to position anyway for the deletion so this doesn't cost extra
-			data = substance.RangePointer(position, deleteLength);
+			data = RangePointer(position, deleteLength);
 			data = uh->AppendAction(ActionType::remove, position, data, deleteLength, startSequence);
 		}
 
@@ -549,6 +644,9 @@ const char *CellBuffer::DeleteChars(Sci::Position position, Sci::Position delete
 }
 
 Sci::Position CellBuffer::Length() const noexcept {
+	if (substancePieces) {
+		return substancePieces->Length();
+	}
 	return substance.Length();
 }
 
@@ -556,6 +654,13 @@ void CellBuffer::Allocate(Sci::Position newSize) {
 	if (!largeDocument && (newSize > INT32_MAX)) {
 		throw std::runtime_error("CellBuffer::Allocate: size of standard document limited to 2G.");
 	}
+	if (substancePieces) {
+		substancePieces->ReAllocate(newSize);
+		if (hasStyles) {
+			stylePieces->ReAllocate(newSize);
+		}
+		return;
+	}
 	substance.ReAllocate(newSize);
 	if (hasStyles) {
 		style.ReAllocate(newSize);
@@ -686,6 +791,10 @@ bool CellBuffer::HasStyles() const noexcept {
 	return hasStyles;
 }
 
+bool CellBuffer::IsPieceTree() const noexcept {
+	return substancePieces != nullptr;
+}
+
 void CellBuffer::SetSavePoint() {
 	uh->SetSavePoint();
 	if (changeHistory) {
@@ -723,12 +832,20 @@ void CellBuffer::RemoveLine(Sci::Line line) {
 	plv->RemoveLine(line);
 }
 
+void CellBuffer::RemoveLines(Sci::Line line, Sci::Line lines) {
+	if (lines == 1) {
+		plv->RemoveLine(line);
+	} else if (lines > 1) {
+		plv->RemoveLines(line, lines);
+	}
+}
+
 bool CellBuffer::UTF8LineEndOverlaps(Sci::Position position) const noexcept {
 	const unsigned char bytes[] = {
-		static_cast<unsigned char>(substance.ValueAt(position-2)),
-		static_cast<unsigned char>(substance.ValueAt(position-1)),
-		static_cast<unsigned char>(substance.ValueAt(position)),
-		static_cast<unsigned char>(substance.ValueAt(position+1)),
+		static_cast<unsigned char>(CharAt(position-2)),
+		static_cast<unsigned char>(CharAt(position-1)),
+		static_cast<unsigned char>(CharAt(position)),
+		static_cast<unsigned char>(CharAt(position+1)),
 	};
 	return UTF8IsSeparator(bytes) || UTF8IsSeparator(bytes+1) || UTF8IsNEL(bytes+1);
 }
@@ -742,7 +859,7 @@ bool CellBuffer::UTF8IsCharacterBoundary(Sci::Position position) const {
 			if (posBack < 0) {
 				return false;
 			}
-			back.insert(0, 1, substance.ValueAt(posBack));
+			back.insert(0, 1, CharAt(posBack));
 			if (!UTF8IsTrailByte(back.front())) {
 				if (i > 0) {
 					// Have reached a non-trail
@@ -756,7 +873,7 @@ bool CellBuffer::UTF8IsCharacterBoundary(Sci::Position position) const {
 		}
 	}
 	if (position < Length()) {
-		const unsigned char fore = substance.ValueAt(position);
+		const unsigned char fore = CharAt(position);
 		if (UTF8IsTrailByte(fore)) {
 			return false;
 		}
@@ -778,7 +895,7 @@ void CellBuffer::ResetLineEnds() {
 	unsigned char chBeforePrev = 0;
 	unsigned char chPrev = 0;
 	for (Sci::Position i = 0; i < length; i++) {
-		const unsigned char ch = substance.ValueAt(position + i);
+		const unsigned char ch = CharAt(position + i);
 		if (ch == '\r') {
 			InsertLine(lineInsert, (position + i) + 1, atLineStart);
 			lineInsert++;
@@ -837,12 +954,88 @@ void CellBuffer::RecalculateIndexLineStarts(Sci::Line lineFirst, Sci::Line lineL
 	}
 }
 
+void CellBuffer::RecalculateIndexLineStarts(Sci::Line lineFirst, Sci::Line lineLast, Sci::Position position, std::string_view inserted) {
+	const Sci::Position positionEnd = position + inserted.length();
+	Sci::Position posLineEnd = LineStart(lineFirst);
+	for (Sci::Line line = lineFirst; line <= lineLast; line++) {
+		const Sci::Position posLineStart = posLineEnd;
+		posLineEnd = LineStart(line+1);
+		if ((posLineStart >= position) && (posLineEnd <= positionEnd)) {
+			// Whole line is in inserted so count it there without copying
+			const CountWidths cw = CountCharacterWidthsUTF8(
+				inserted.substr(posLineStart - position, posLineEnd - posLineStart));
+			plv->SetLineCharactersWidth(line, cw);
+		} else {
+			RecalculateIndexLineStarts(line, line);
+		}
+	}
+}
+
+namespace {
+
+// Quickly find blocks of text that may contain line ends so that the byte at a time
+// line end checks only run over a small part of large insertions.
+
+#if defined(CELLBUFFER_SSE2)
+
+constexpr ptrdiff_t scanBlockSize = sizeof(__m128i);
+
+bool BlockMayHaveLineEnd(const char *p, bool unicodeLineEnds) noexcept {
+	const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+	__m128i found = _mm_or_si128(
+		_mm_cmpeq_epi8(block, _mm_set1_epi8('\n')),
+		_mm_cmpeq_epi8(block, _mm_set1_epi8('\r')));
+	if (unicodeLineEnds) {
+		// Last bytes of NEL, LS and PS
+		found = _mm_or_si128(found, _mm_cmpeq_epi8(block, _mm_set1_epi8(static_cast<char>(0x85))));
+		found = _mm_or_si128(found, _mm_cmpeq_epi8(block, _mm_set1_epi8(static_cast<char>(0xa8))));
+		found = _mm_or_si128(found, _mm_cmpeq_epi8(block, _mm_set1_epi8(static_cast<char>(0xa9))));
+	}
+	return _mm_movemask_epi8(found) != 0;
+}
+
+#else
+
+constexpr ptrdiff_t scanBlockSize = sizeof(uint64_t);
+
+// Non-zero when any byte of word is equal to byte
+constexpr uint64_t HasByte(uint64_t word, unsigned char byte) noexcept {
+	constexpr uint64_t ones = 0x0101010101010101ULL;
+	constexpr uint64_t highs = 0x8080808080808080ULL;
+	const uint64_t x = word ^ (ones * byte);
+	return (x - ones) & ~x & highs;
+}
+
+bool BlockMayHaveLineEnd(const char *p, bool unicodeLineEnds) noexcept {
+	uint64_t word = 0;
+	memcpy(&word, p, sizeof(word));
+	uint64_t found = HasByte(word, '\n') | HasByte(word, '\r');
+	if (unicodeLineEnds) {
+		// Last bytes of NEL, LS and PS
+		found |= HasByte(word, 0x85) | HasByte(word, 0xa8) | HasByte(word, 0xa9);
+	}
+	return found != 0;
+}
+
+#endif
+
+// Skip over whole blocks before end that do not contain line ends.
+// Stops before end as the caller reads the byte after a '\r' which must be before end.
+const char *SkipToPossibleLineEnd(const char *ptr, const char *end, bool unicodeLineEnds) noexcept {
+	while (((end - ptr) > scanBlockSize) && !BlockMayHaveLineEnd(ptr, unicodeLineEnds)) {
+		ptr += scanBlockSize;
+	}
+	return ptr;
+}
+
+}
+
 void CellBuffer::BasicInsertString(Sci::Position position, const char *s, Sci::Position insertLength) {
 	if (insertLength == 0)
 		return;
 	PLATFORM_ASSERT(insertLength > 0);
 
-	const unsigned char chAfter = substance.ValueAt(position);
+	const unsigned char chAfter = CharAt(position);
 	bool breakingUTF8LineEnd = false;
 	if (utf8LineEnds == LineEndType::Unicode && UTF8IsTrailByte(chAfter)) {
 		breakingUTF8LineEnd = UTF8LineEndOverlaps(position);
@@ -850,6 +1043,7 @@ void CellBuffer::BasicInsertString(Sci::Position position, const char *s, Sci::P
 
 	const Sci::Line linePosition = plv->LineFromPosition(position);
 	Sci::Line lineInsert = linePosition + 1;
+	Sci::Line lineRecalculateStart = linePosition;
 
 	// A simple insertion is one that inserts valid text on a single line at a character boundary
 	bool simpleInsertion = false;
@@ -864,16 +1058,23 @@ void CellBuffer::BasicInsertString(Sci::Position position, const char *s, Sci::P
 			UTF8IsValid(std::string_view(s, insertLength));
 	}
 
-	substance.InsertFromArray(position, s, 0, insertLength);
-	if (hasStyles) {
-		style.InsertValue(position, insertLength, 0);
+	if (substancePieces) {
+		substancePieces->InsertFromArray(position, s, 0, insertLength);
+		if (hasStyles) {
+			stylePieces->InsertValue(position, insertLength, 0);
+		}
+	} else {
+		substance.InsertFromArray(position, s, 0, insertLength);
+		if (hasStyles) {
+			style.InsertValue(position, insertLength, 0);
+		}
 	}
 
 	const bool atLineStart = plv->LineStart(lineInsert-1) == position;
 	// Point all the lines after the insertion point further along in the buffer
 	plv->InsertText(lineInsert-1, insertLength);
-	unsigned char chBeforePrev = substance.ValueAt(position - 2);
-	unsigned char chPrev = substance.ValueAt(position - 1);
+	unsigned char chBeforePrev = CharAt(position - 2);
+	unsigned char chPrev = CharAt(position - 1);
 	if (chPrev == '\r' && chAfter == '\n') {
 		// Splitting up a crlf pair at position
 		InsertLine(lineInsert, position, false);
@@ -883,9 +1084,8 @@ void CellBuffer::BasicInsertString(Sci::Position position, const char *s, Sci::P
 		RemoveLine(lineInsert);
 	}
 
-	constexpr size_t PositionBlockSize = 128;
-	Sci::Position positions[PositionBlockSize]{};
-	size_t nPositions = 0;
+	// Collect the start of each new line in one pass over the text then insert them together
+	std::vector<Sci::Position> positions;
 	const Sci::Line lineStart = lineInsert;
 
 	// s may not NULL-terminated, ensure *ptr == '\n' or *next == '\n' is valid.
@@ -898,6 +1098,8 @@ void CellBuffer::BasicInsertString(Sci::Position position, const char *s, Sci::P
 		// Patch up what was end of line
 		plv->SetLineStart(lineInsert - 1, (position + ptr - s));
 		simpleInsertion = false;
+		// Previous line now ends with \r\n so has changed width
+		lineRecalculateStart = linePosition - 1;
 	}
 
 	if (ptr < end) {
@@ -911,8 +1113,15 @@ void CellBuffer::BasicInsertString(Sci::Position position, const char *s, Sci::P
 			eolTable[0xa9] = 3;
 		}
 
+		const bool unicodeLineEnds = utf8LineEnds == LineEndType::Unicode;
 		do {
-			// skip to line end
+			// skip to line end, jumping over blocks that can not contain one
+			const char *const possible = SkipToPossibleLineEnd(ptr, end, unicodeLineEnds);
+			if (possible != ptr) {
+				chBeforePrev = ((possible - ptr) >= 2) ? possible[-2] : chPrev;
+				chPrev = possible[-1];
+				ptr = possible;
+			}
 			ch = *ptr++;
 			uint8_t type;
 			while ((type = eolTable[ch]) == 0 && ptr < end) {
@@ -927,23 +1136,13 @@ void CellBuffer::BasicInsertString(Sci::Position position, const char *s, Sci::P
 				}
 				[[fallthrough]];
 			case 1: // '\n'
-				positions[nPositions++] = position + ptr - s;
-				if (nPositions == PositionBlockSize) {
-					plv->InsertLines(lineInsert, positions, nPositions, atLineStart);
-					lineInsert += nPositions;
-					nPositions = 0;
-				}
+				positions.push_back(position + ptr - s);
 				break;
 			case 3:
 			case 4:
 				// LS, PS and NEL
 				if ((type == 3 && chPrev == 0x80 && chBeforePrev == 0xe2) || (type == 4 && chPrev == 0xc2)) {
-					positions[nPositions++] = position + ptr - s;
-					if (nPositions == PositionBlockSize) {
-						plv->InsertLines(lineInsert, positions, nPositions, atLineStart);
-						lineInsert += nPositions;
-						nPositions = 0;
-					}
+					positions.push_back(position + ptr - s);
 				}
 				break;
 			}
@@ -953,25 +1152,23 @@ void CellBuffer::BasicInsertString(Sci::Position position, const char *s, Sci::P
 		} while (ptr < end);
 	}
 
-	if (nPositions != 0) {
-		plv->InsertLines(lineInsert, positions, nPositions, atLineStart);
-		lineInsert += nPositions;
-	}
-
 	ch = *end;
 	if (ptr == end) {
 		++ptr;
 		if (ch == '\r' || ch == '\n') {
-			InsertLine(lineInsert, (position + ptr - s), atLineStart);
-			lineInsert++;
+			positions.push_back(position + ptr - s);
 		} else if (utf8LineEnds == LineEndType::Unicode && !UTF8IsAscii(ch)) {
 			if (UTF8IsMultibyteLineEnd(chBeforePrev, chPrev, ch)) {
-				InsertLine(lineInsert, (position + ptr - s), atLineStart);
-				lineInsert++;
+				positions.push_back(position + ptr - s);
 			}
 		}
 	}
 
+	if (!positions.empty()) {
+		plv->InsertLines(lineInsert, positions.data(), positions.size(), atLineStart);
+		lineInsert += positions.size();
+	}
+
 	// Joining two lines where last insertion is cr and following substance starts with lf
 	if (chAfter == '\n') {
 		if (ch == '\r') {
@@ -984,7 +1181,7 @@ void CellBuffer::BasicInsertString(Sci::Position position, const char *s, Sci::P
 		chPrev = ch;
 		// May have end of UTF-8 line end in buffer and start in insertion
 		for (int j = 0; j < UTF8SeparatorLength-1; j++) {
-			const unsigned char chAt = substance.ValueAt(position + insertLength + j);
+			const unsigned char chAt = CharAt(position + insertLength + j);
 			const unsigned char back3[3] = {chBeforePrev, chPrev, chAt};
 			if (UTF8IsSeparator(back3)) {
 				InsertLine(lineInsert, (position + insertLength + j) + 1, atLineStart);
@@ -1003,7 +1200,7 @@ void CellBuffer::BasicInsertString(Sci::Position position, const char *s, Sci::P
 			const CountWidths cw = CountCharacterWidthsUTF8(std::string_view(s, insertLength));
 			plv->InsertCharacters(linePosition, cw);
 		} else {
-			RecalculateIndexLineStarts(linePosition, lineInsert - 1);
+			RecalculateIndexLineStarts(lineRecalculateStart, lineInsert - 1, position, std::string_view(s, insertLength));
 		}
 	}
 }
@@ -1014,7 +1211,7 @@ void CellBuffer::BasicDeleteChars(Sci::Position position, Sci::Position deleteLe
 
 	Sci::Line lineRecalculateStart = Sci::invalidPosition;
 
-	if ((position == 0) && (deleteLength == substance.Length())) {
+	if ((position == 0) && (deleteLength == Length())) {
 		// If whole buffer is being deleted, faster to reinitialise lines data
 		// than to delete each line.
 		plv->Init();
@@ -1026,9 +1223,9 @@ void CellBuffer::BasicDeleteChars(Sci::Position position, Sci::Position deleteLe
 		Sci::Line lineRemove = linePosition + 1;
 
 		plv->InsertText(lineRemove-1, - (deleteLength));
-		const unsigned char chPrev = substance.ValueAt(position - 1);
+		const unsigned char chPrev = CharAt(position - 1);
 		const unsigned char chBefore = chPrev;
-		unsigned char chNext = substance.ValueAt(position);
+		unsigned char chNext = CharAt(position);
 
 		// Check for breaking apart a UTF-8 sequence
 		// Needs further checks that text is UTF-8 or that some other break apart is occurring
@@ -1060,52 +1257,63 @@ void CellBuffer::BasicDeleteChars(Sci::Position position, Sci::Position deleteLe
 			lineRemove++;
 			ignoreNL = true; 	// First \n is not real deletion
 		}
+		// Each removed line is at lineRemove so count them then remove together
+		Sci::Line linesRemoved = 0;
 		if (utf8LineEnds == LineEndType::Unicode && UTF8IsTrailByte(chNext)) {
 			if (UTF8LineEndOverlaps(position)) {
-				RemoveLine(lineRemove);
+				linesRemoved++;
 			}
 		}
 
 		unsigned char ch = chNext;
 		for (Sci::Position i = 0; i < deleteLength; i++) {
-			chNext = substance.ValueAt(position + i + 1);
+			chNext = CharAt(position + i + 1);
 			if (ch == '\r') {
 				if (chNext != '\n') {
-					RemoveLine(lineRemove);
+					linesRemoved++;
 				}
 			} else if (ch == '\n') {
 				if (ignoreNL) {
 					ignoreNL = false; 	// Further \n are real deletions
 				} else {
-					RemoveLine(lineRemove);
+					linesRemoved++;
 				}
 			} else if (utf8LineEnds == LineEndType::Unicode) {
 				if (!UTF8IsAscii(ch)) {
 					const unsigned char next3[3] = {ch, chNext,
-						static_cast<unsigned char>(substance.ValueAt(position + i + 2))};
+						static_cast<unsigned char>(CharAt(position + i + 2))};
 					if (UTF8IsSeparator(next3) || UTF8IsNEL(next3)) {
-						RemoveLine(lineRemove);
+						linesRemoved++;
 					}
 				}
 			}
 
 			ch = chNext;
 		}
+		RemoveLines(lineRemove, linesRemoved);
 		// May have to fix up end if last deletion causes cr to be next to lf
 		// or removes one of a crlf pair
-		const char chAfter = substance.ValueAt(position + deleteLength);
+		const char chAfter = CharAt(position + deleteLength);
 		if (chBefore == '\r' && chAfter == '\n') {
 			// Using lineRemove-1 as cr ended line before start of deletion
 			RemoveLine(lineRemove - 1);
 			plv->SetLineStart(lineRemove - 1, position + 1);
 		}
 	}
-	substance.DeleteRange(position, deleteLength);
+	if (substancePieces) {
+		substancePieces->DeleteRange(position, deleteLength);
+	} else {
+		substance.DeleteRange(position, deleteLength);
+	}
 	if (lineRecalculateStart >= 0) {
 		RecalculateIndexLineStarts(lineRecalculateStart, lineRecalculateStart);
 	}
 	if (hasStyles) {
-		style.DeleteRange(position, deleteLength);
+		if (stylePieces) {
+			stylePieces->DeleteRange(position, deleteLength);
+		} else {
+			style.DeleteRange(position, deleteLength);
+		}
 	}
 }
 
@@ -1164,7 +1372,7 @@ void CellBuffer::PerformUndoStep() {
 		changeHistory->StartReversion();
 	}
 	if (previousStep.at == ActionType::insert) {
-		if (substance.Length() < previousStep.lenData) {
+		if (Length() < previousStep.lenData) {
 			throw std::runtime_error(
 				"CellBuffer::PerformUndoStep: deletion must be less than document length.");
 		}
@@ -23,10 +23,12 @@ public:
 	virtual void InsertLine(Sci::Line line)=0;
 	virtual void InsertLines(Sci::Line line, Sci::Line lines) = 0;
 	virtual void RemoveLine(Sci::Line line)=0;
+	virtual void RemoveLines(Sci::Line line, Sci::Line lines) = 0;
 };
 
 class UndoHistory;
 class ChangeHistory;
+template <typename T> class PieceTree;
 
 /**
  * The line vector contains information about each of the lines in a cell buffer.
@@ -101,6 +103,9 @@ private:
 	bool largeDocument;
 	SplitVector<char> substance;
 	SplitVector<char> style;
+	// When using a piece tree, these are used instead of substance and style
+	std::unique_ptr<PieceTree<char>> substancePieces;
+	std::unique_ptr<PieceTree<char>> stylePieces;
 	bool readOnly;
 	bool utf8Substance;
 	Scintilla::LineEndType utf8LineEnds;
@@ -116,6 +121,7 @@ private:
 	bool UTF8IsCharacterBoundary(Sci::Position position) const;
 	void ResetLineEnds();
 	void RecalculateIndexLineStarts(Sci::Line lineFirst, Sci::Line lineLast);
+	void RecalculateIndexLineStarts(Sci::Line lineFirst, Sci::Line lineLast, Sci::Position position, std::string_view inserted);
 	bool MaintainingLineCharacterIndex() const noexcept;
 	/// Actions without undo
 	void BasicInsertString(Sci::Position position, const char *s, Sci::Position insertLength);
@@ -123,7 +129,7 @@ private:
 
 public:
 
-	CellBuffer(bool hasStyles_, bool largeDocument_);
+	CellBuffer(bool hasStyles_, bool largeDocument_, bool pieceTree_=false);
 	// Deleted so CellBuffer objects can not be copied.
 	CellBuffer(const CellBuffer &) = delete;
 	CellBuffer(CellBuffer &&) = delete;
@@ -141,6 +147,7 @@ public:
 	const char *RangePointer(Sci::Position position, Sci::Position rangeLength) noexcept;
 	Sci::Position GapPosition() const noexcept;
 	SplitView AllView() const noexcept;
+	const char *SegmentPointer(Sci::Position position, Sci::Position &segmentLength) const noexcept;
 
 	Sci::Position Length() const noexcept;
 	void Allocate(Sci::Position newSize);
@@ -161,6 +168,7 @@ public:
 	Sci::Line LineFromPositionIndex(Sci::Position pos, Scintilla::LineCharacterIndexType lineCharacterIndex) const noexcept;
 	void InsertLine(Sci::Line line, Sci::Position position, bool lineStart);
 	void RemoveLine(Sci::Line line);
+	void RemoveLines(Sci::Line line, Sci::Line lines);
 	const char *InsertString(Sci::Position position, const char *s, Sci::Position insertLength, bool &startSequence);
 
 	/// Setting styles for positions outside the range of the buffer is safe and has no effect.
@@ -174,6 +182,7 @@ public:
 	void SetReadOnly(bool set) noexcept;
 	bool IsLarge() const noexcept;
 	bool HasStyles() const noexcept;
+	bool IsPieceTree() const noexcept;
 
 	/// The save point is a marker in the undo stack where the container has stated that
 	/// the buffer was saved. Undo and redo can move over the save point.
@@ -381,9 +381,10 @@ bool ContractionState<LINE>::SetHeight(Sci::Line lineDoc, int height) {
 		return false;
 	} else if (lineDoc < LinesInDoc()) {
 		EnsureData();
-		if (GetHeight(lineDoc) != height) {
+		const int heightPrevious = GetHeight(lineDoc);
+		if (heightPrevious != height) {
 			if (GetVisible(lineDoc)) {
-				displayLines->InsertText(line_cast(lineDoc), height - GetHeight(lineDoc));
+				displayLines->InsertText(line_cast(lineDoc), height - heightPrevious);
 			}
 			heights->SetValueAt(line_cast(lineDoc), height);
 			Check();
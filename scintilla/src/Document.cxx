@@ -25,13 +25,23 @@
 #include <optional>
 #include <algorithm>
 #include <iterator>
+#include <functional>
 #include <memory>
 #include <chrono>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 
 #ifndef NO_CXX11_REGEX
 #include <regex>
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DOCUMENT_SSE2
+#endif
+
 #include "ScintillaTypes.h"
 #include "ILoader.h"
 #include "ILexer.h"
@@ -51,8 +61,11 @@
 #include "CaseFolder.h"
 #include "Document.h"
 #include "RESearch.h"
+#include "LinearRegex.h"
 #include "UniConversion.h"
 #include "ElapsedPeriod.h"
+#include "BackgroundStyling.h"
+#include "ThreadPool.h"
 
 using namespace Scintilla;
 using namespace Scintilla::Internal;
@@ -62,17 +75,23 @@ using namespace Scintilla::Internal;
 #pragma GCC diagnostic ignored "-Wstringop-overflow"
 #endif
 
-LexInterface::LexInterface(Document *pdoc_) noexcept : pdoc(pdoc_), performingStyle(false) {
+LexInterface::LexInterface(Document *pdoc_) noexcept : pdoc(pdoc_), performingStyle(false), backgroundStale(false),
+	backgroundChangeStart(0), backgroundApplied(0) {
 }
 
 LexInterface::~LexInterface() noexcept = default;
 
 void LexInterface::SetInstance(ILexer5 *instance_) noexcept {
+	// Results from the previous lexer are not wanted
+	background.reset();
+	backgroundStale = false;
 	instance.reset(instance_);
 }
 
 void LexInterface::Colourise(Sci::Position start, Sci::Position end) {
 	if (pdoc && instance && !performingStyle) {
+		StopBackgroundStyling();
+
 		// Protect against reentrance, which may occur, for example, when
 		// fold points are discovered while performing styling and the folding
 		// code looks for child lines which may trigger styling.
@@ -99,7 +118,116 @@ void LexInterface::Colourise(Sci::Position start, Sci::Position end) {
 	}
 }
 
+// Apply batches of styles and fold levels from the worker to the document.
+void LexInterface::CommitBackgroundStyling(bool wait) {
+	if (backgroundStale) {
+		background->DiscardBatches();
+		return;
+	}
+	if (performingStyle) {
+		return;
+	}
+	const std::vector<StyleBatch> batches = background->TakeBatches(std::chrono::milliseconds(wait ? 10 : 0));
+	performingStyle = true;
+	for (const StyleBatch &batch : batches) {
+		if (backgroundStale) {
+			// Notifications led to document changing so remaining batches are invalid
+			break;
+		}
+		pdoc->StartStyling(batch.styleStart);
+		pdoc->SetStyles(batch.styles.length(), batch.styles.data());
+		for (size_t i = 0; i < batch.levels.values.size(); i++) {
+			pdoc->SetLevel(batch.levels.first + i, batch.levels.values[i]);
+		}
+		for (size_t i = 0; i < batch.lineStates.values.size(); i++) {
+			pdoc->SetLineState(batch.lineStates.first + i, batch.lineStates.values[i]);
+		}
+		for (const DecorationFill &fill : batch.fills) {
+			pdoc->DecorationSetCurrentIndicator(fill.indicator);
+			pdoc->DecorationFillRange(fill.position, fill.value, fill.fillLength);
+		}
+		for (const auto &[start, end] : batch.lexerStateChanges) {
+			pdoc->ChangeLexerState(start, end);
+		}
+		if (batch.errorStatus) {
+			pdoc->SetErrorStatus(batch.errorStatus);
+		}
+		backgroundApplied = batch.lexEnd;
+	}
+	performingStyle = false;
+}
+
+// Continue styling the document on a worker thread after applying any results that
+// are ready. Returns false when styling is complete or can not be performed in the background.
+bool LexInterface::StyleInBackground(bool wait) {
+	if (!pdoc || !instance || performingStyle) {
+		return false;
+	}
+	if (pdoc->dbcsCodePage && (pdoc->dbcsCodePage != CpUtf8)) {
+		// StyleSnapshot does not implement DBCS character navigation
+		return false;
+	}
+	if (!background) {
+		background = std::make_unique<BackgroundStyling>();
+	}
+	if (backgroundStale) {
+		background->DiscardBatches();
+	} else {
+		CommitBackgroundStyling(wait);
+	}
+	if (!background->Running()) {
+		if (background->Failed()) {
+			return false;
+		}
+		// Worker has finished or was stopped so commit any batches published after the previous commit
+		background->Stop();
+		CommitBackgroundStyling(false);
+		if (pdoc->GetEndStyled() >= pdoc->Length()) {
+			return false;
+		}
+		const Sci::Position start = pdoc->LineStartPosition(pdoc->GetEndStyled());
+		StyleSnapshot *snapshot = background->Snapshot();
+		if (snapshot && !backgroundStale && (start >= background->Next())) {
+			// Text is unchanged so continue with the snapshot after copying any styling
+			// performed on this thread since the worker stopped.
+			pdoc->RefreshSnapshot(*snapshot, background->Next(), start);
+			background->Resume(instance.get(), start);
+		} else if (snapshot && backgroundStale) {
+			// Text before the earliest change is unchanged so only copy the text after it
+			// and any styling performed on this thread beyond the applied batches.
+			const Sci::Position unchanged = std::min(start, pdoc->LineStartPosition(backgroundChangeStart));
+			pdoc->RefreshSnapshot(*snapshot, backgroundApplied, unchanged);
+			pdoc->UpdateSnapshot(*snapshot, unchanged);
+			background->Resume(instance.get(), start);
+		} else {
+			background->Start(pdoc->SnapshotForStyling(), instance.get(), start);
+		}
+		backgroundApplied = start;
+		backgroundStale = false;
+	}
+	return true;
+}
+
+// Wait for the worker so the lexer can be used by this thread, keeping its valid results.
+void LexInterface::StopBackgroundStyling() {
+	if (background) {
+		background->Stop();
+		CommitBackgroundStyling(false);
+	}
+}
+
+void LexInterface::InvalidateBackgroundStyling(Sci::Position position) noexcept {
+	if (background) {
+		background->Cancel();
+		if (!backgroundStale || (position < backgroundChangeStart)) {
+			backgroundChangeStart = position;
+		}
+		backgroundStale = true;
+	}
+}
+
 LineEndType LexInterface::LineEndTypesSupported() {
+	StopBackgroundStyling();
 	if (instance) {
 		return static_cast<LineEndType>(instance->LineEndTypesSupported());
 	}
@@ -153,7 +281,8 @@ CharacterExtracted::CharacterExtracted(const unsigned char *charBytes, size_t wi
 
 Document::Document(DocumentOption options) :
 	refCount(0),
-	cb(!FlagSet(options, DocumentOption::StylesNone), FlagSet(options, DocumentOption::TextLarge)),
+	cb(!FlagSet(options, DocumentOption::StylesNone), FlagSet(options, DocumentOption::TextLarge),
+		FlagSet(options, DocumentOption::PieceTree)),
 	endStyled(0),
 	styleClock(0),
 	enteredModification(0),
@@ -236,6 +365,13 @@ void Document::RemoveLine(Sci::Line line) {
 	}
 }
 
+void Document::RemoveLines(Sci::Line line, Sci::Line lines) {
+	for (const std::unique_ptr<PerLine> &pl : perLineData) {
+		if (pl)
+			pl->RemoveLines(line, lines);
+	}
+}
+
 LineMarkers *Document::Markers() const noexcept {
 	return static_cast<LineMarkers *>(perLineData[ldMarkers].get());
 }
@@ -1421,6 +1557,9 @@ EncodingFamily Document::CodePageFamily() const noexcept {
 void Document::ModifiedAt(Sci::Position pos) noexcept {
 	if (endStyled > pos)
 		endStyled = pos;
+	if (pli) {
+		pli->InvalidateBackgroundStyling(pos);
+	}
 }
 
 void Document::CheckReadOnly() {
@@ -1968,7 +2107,8 @@ std::string_view Document::EOLString() const noexcept {
 
 DocumentOption Document::Options() const noexcept {
 	return (IsLarge() ? DocumentOption::TextLarge : DocumentOption::Default) |
-		(cb.HasStyles() ? DocumentOption::Default : DocumentOption::StylesNone);
+		(cb.HasStyles() ? DocumentOption::Default : DocumentOption::StylesNone) |
+		(cb.IsPieceTree() ? DocumentOption::PieceTree : DocumentOption::Default);
 }
 
 bool Document::IsWhiteLine(Sci::Line line) const {
@@ -2262,6 +2402,48 @@ bool Document::HasCaseFolder() const noexcept {
 
 void Document::SetCaseFolder(std::unique_ptr<CaseFolder> pcf_) noexcept {
 	pcf = std::move(pcf_);
+	foldStarts.clear();
+}
+
+void Document::CalculateFoldStarts() {
+	constexpr size_t byteValues = 0x100;
+	foldStarts.assign(byteValues * byteValues, false);
+	// ASCII is compared after MakeLowerCase, not with the case folder
+	for (int ch = 0; ch < 0x80; ch++) {
+		foldStarts[MakeLowerCase(static_cast<unsigned char>(ch)) * byteValues + ch] = true;
+	}
+	char folded[UTF8MaxBytes * 4 + 1] {};
+	auto addFolding = [this, &folded](const char *bytes, size_t width) {
+		const unsigned char leadByte = bytes[0];
+		const size_t lenFlat = pcf->Fold(folded, sizeof(folded), bytes, width);
+		if (lenFlat == 0) {
+			// Folds to nothing so may precede any text
+			for (size_t first = 0; first < byteValues; first++) {
+				foldStarts[first * byteValues + leadByte] = true;
+			}
+		} else {
+			foldStarts[static_cast<unsigned char>(folded[0]) * byteValues + leadByte] = true;
+		}
+	};
+	// Bytes that are not part of valid characters are folded individually
+	for (int byte = 0x80; byte < 0x100; byte++) {
+		const char single = static_cast<char>(byte);
+		addFolding(&single, 1);
+	}
+	for (unsigned int ch = 0x80; ch < 0x10000; ch++) {
+		if (!IsSurrogate(ch)) {
+			char bytes[UTF8MaxBytes + 1] {};
+			UTF8FromUTF32Character(ch, bytes);
+			addFolding(bytes, strlen(bytes));
+		}
+	}
+	// Treat characters outside the basic multilingual plane as possible starts of any match
+	// as checking all of them is slow.
+	for (int leadByte = 0xF0; leadByte < 0x100; leadByte++) {
+		for (size_t first = 0; first < byteValues; first++) {
+			foldStarts[first * byteValues + leadByte] = true;
+		}
+	}
 }
 
 CharacterExtracted Document::ExtractCharacter(Sci::Position position) const noexcept {
@@ -2297,10 +2479,135 @@ ptrdiff_t SplitFindChar(const SplitView &view, size_t start, size_t length, int
 	return -1;
 }
 
+// Set of bytes that may start a match, with the bytes listed for vector comparison.
+// Every byte at or above highStart is a member as UTF-8 lead bytes of
+// supplementary characters are always treated as possible starts.
+struct ByteSet {
+	std::array<bool, 256> members {};
+	std::vector<char> listed;
+	int highStart = 0x100;
+	ByteSet(const std::vector<bool> &starts, size_t offset) {
+		for (size_t b = 0; b < members.size(); b++) {
+			members[b] = starts[offset + b];
+		}
+		while ((highStart > 0) && members[highStart - 1]) {
+			highStart--;
+		}
+		for (int b = 0; b < highStart; b++) {
+			if (members[b]) {
+				listed.push_back(static_cast<char>(b));
+			}
+		}
+	}
+};
+
+ptrdiff_t FindByteSet(const char *text, size_t length, const ByteSet &set) noexcept {
+	size_t i = 0;
+#if defined(DOCUMENT_SSE2)
+	// Skip blocks of 16 bytes that contain no members then check the block found byte by byte
+	constexpr size_t maxListed = 8;
+	constexpr size_t blockSize = sizeof(__m128i);
+	if (set.listed.size() <= maxListed) {
+		__m128i listed[maxListed] {};
+		for (size_t l = 0; l < set.listed.size(); l++) {
+			listed[l] = _mm_set1_epi8(set.listed[l]);
+		}
+		const bool hasHigh = set.highStart < 0x100;
+		const __m128i high = _mm_set1_epi8(static_cast<char>(set.highStart));
+		for (; i + blockSize <= length; i += blockSize) {
+			const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text + i));
+			__m128i found = _mm_setzero_si128();
+			for (size_t l = 0; l < set.listed.size(); l++) {
+				found = _mm_or_si128(found, _mm_cmpeq_epi8(block, listed[l]));
+			}
+			if (hasHigh) {
+				// Unsigned block >= high when max(block, high) == block
+				found = _mm_or_si128(found, _mm_cmpeq_epi8(_mm_max_epu8(block, high), block));
+			}
+			if (_mm_movemask_epi8(found) != 0) {
+				break;
+			}
+		}
+	}
+#endif
+	for (; i < length; i++) {
+		if (set.members[static_cast<unsigned char>(text[i])]) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+// Find the first byte in a set over the split view
+ptrdiff_t SplitFindByteSet(const SplitView &view, size_t start, size_t length, const ByteSet &set) noexcept {
+	size_t range1Length = 0;
+	if (start < view.length1) {
+		range1Length = std::min(length, view.length1 - start);
+		const ptrdiff_t match = FindByteSet(view.segment1 + start, range1Length, set);
+		if (match >= 0) {
+			return start + match;
+		}
+		start += range1Length;
+	}
+	const ptrdiff_t match2 = FindByteSet(view.segment2 + start, length - range1Length, set);
+	if (match2 >= 0) {
+		return start + match2;
+	}
+	return -1;
+}
+
+// Text held as pieces is read in place one piece at a time instead of copying
+// the whole document into one block as AllView would need.
+struct PieceView {
+	const CellBuffer &cb;
+	char CharAt(size_t position) const noexcept {
+		return cb.CharAt(position);
+	}
+};
+
+// Equivalent of memchr over the pieces
+ptrdiff_t SplitFindChar(const PieceView &view, size_t start, size_t length, int ch) noexcept {
+	const size_t end = start + length;
+	while (start < end) {
+		Sci::Position segmentLength = 0;
+		const char *segment = view.cb.SegmentPointer(start, segmentLength);
+		if (segmentLength <= 0) {
+			break;
+		}
+		const size_t lengthSearch = std::min<size_t>(segmentLength, end - start);
+		const char *match = static_cast<const char *>(memchr(segment, ch, lengthSearch));
+		if (match) {
+			return start + (match - segment);
+		}
+		start += lengthSearch;
+	}
+	return -1;
+}
+
+// Find the first byte in a set over the pieces
+ptrdiff_t SplitFindByteSet(const PieceView &view, size_t start, size_t length, const ByteSet &set) noexcept {
+	const size_t end = start + length;
+	while (start < end) {
+		Sci::Position segmentLength = 0;
+		const char *segment = view.cb.SegmentPointer(start, segmentLength);
+		if (segmentLength <= 0) {
+			break;
+		}
+		const size_t lengthSearch = std::min<size_t>(segmentLength, end - start);
+		const ptrdiff_t match = FindByteSet(segment, lengthSearch, set);
+		if (match >= 0) {
+			return start + match;
+		}
+		start += lengthSearch;
+	}
+	return -1;
+}
+
 // Equivalent of memcmp over the split view
 // This does not call memcmp as search texts are commonly too short to overcome the
 // call overhead.
-bool SplitMatch(const SplitView &view, size_t start, std::string_view text) noexcept {
+template <typename View>
+bool SplitMatch(const View &view, size_t start, std::string_view text) noexcept {
 	for (size_t i = 0; i < text.length(); i++) {
 		if (view.CharAt(i + start) != text[i]) {
 			return false;
@@ -2309,231 +2616,605 @@ bool SplitMatch(const SplitView &view, size_t start, std::string_view text) noex
 	return true;
 }
 
+// Searches with FindOption::Parallel over at least searchChunksMinimum chunks
+// are divided into chunks that are searched by the threads of a ThreadPool.
+constexpr Sci::Position searchChunkSize = 0x100000;
+constexpr Sci::Position searchChunksMinimum = 4;
+
+// A chunk reports matches that start in [start, end) and may examine text up to limit
+// so that matches starting just before end are complete.
+struct SearchChunk {
+	Sci::Position start;
+	Sci::Position end;
+	Sci::Position limit;
+};
+
+// Divide [start, end] into chunks at character boundaries, extending each by overlap.
+// As regular expression matches do not cross line ends, regular expression chunks are
+// whole lines and are limited to the end of their last line so nothing after a chunk is
+// read by RangePointer.
+std::vector<SearchChunk> SearchChunks(const Document *pdoc, Sci::Position start, Sci::Position end,
+	Sci::Position overlap, bool lines) {
+	std::vector<SearchChunk> chunks;
+	Sci::Position chunkStart = start;
+	do {
+		Sci::Position chunkEnd = end;
+		Sci::Position limit = end;
+		if ((end - chunkStart) >= 2 * searchChunkSize) {
+			const Sci::Position split = chunkStart + searchChunkSize;
+			if (lines) {
+				const Sci::Line lineNext = pdoc->SciLineFromPosition(split) + 1;
+				chunkEnd = std::min<Sci::Position>(pdoc->LineStart(lineNext), end);
+				if (chunkEnd < end) {
+					limit = pdoc->LineEnd(lineNext - 1);
+				}
+			} else {
+				chunkEnd = pdoc->MovePositionOutsideChar(split, 1, false);
+				limit = std::min(chunkEnd + overlap, end);
+			}
+		}
+		chunks.push_back({ chunkStart, chunkEnd, limit });
+		chunkStart = chunkEnd;
+	} while (chunkStart < end);
+	return chunks;
+}
+
+// The start of the chunk that contains position or position if it is not inside a chunk.
+// Regular expression chunks read whole lines so the first chunk extends back to the
+// start of its line and the last chunk forward to the end of its line.
+Sci::Position ChunkStartContaining(const Document *pdoc, const std::vector<SearchChunk> &chunks,
+	Sci::Position position, bool lines) {
+	for (size_t index = 0; index < chunks.size(); index++) {
+		Sci::Position start = chunks[index].start;
+		Sci::Position end = chunks[index].end;
+		if (lines && (index == 0)) {
+			start = pdoc->LineStart(pdoc->SciLineFromPosition(start));
+		}
+		if (lines && (index == chunks.size() - 1)) {
+			end = pdoc->LineEnd(pdoc->SciLineFromPosition(end));
+		}
+		if ((position > start) && (position < end)) {
+			return start;
+		}
+	}
+	return position;
+}
+
+// Call find for each match from pos onwards, stepping over empty matches, and
+// pass each to record until there are maxMatches, if maxMatches is not 0.
+template <typename Find, typename Record>
+Sci::Position FindEach(const Document *pdoc, Sci::Position pos, Sci::Position maxPos, Sci::Position length,
+	Sci::Position maxMatches, Find find, Record record) {
+	Sci::Position matches = 0;
+	while (pos <= maxPos) {
+		Sci::Position lengthFound = length;
+		const Sci::Position posFound = find(pos, &lengthFound);
+		if (posFound < 0) {
+			break;
+		}
+		matches++;
+		record(posFound, lengthFound);
+		if (maxMatches && (matches >= maxMatches)) {
+			break;
+		}
+		pos = posFound + lengthFound;
+		if (lengthFound == 0) {
+			// Empty matches are possible for regular expressions
+			if (pos >= maxPos) {
+				break;
+			}
+			pos = pdoc->NextPosition(pos, 1);
+		}
+	}
+	return matches;
+}
+
 }
 
 /**
- * Find text in document, supporting both forward and backward
- * searches (just pass minPos > maxPos to do a backward search)
- * Has not been tested with backwards DBCS searches yet.
+ * Scan cbView for literal text, calling report with the position and length of each match.
+ * Stops and returns the position of the match when report returns true, otherwise
+ * continues with the following match that does not overlap it in the direction of the scan.
  */
-Sci::Position Document::FindText(Sci::Position minPos, Sci::Position maxPos, const char *search,
-                        FindOption flags, Sci::Position *length) {
-	if (*length <= 0)
-		return minPos;
+template <typename View, typename Report>
+Sci::Position Document::ScanView(const View &cbView, Sci::Position minPos, Sci::Position maxPos, const char *search,
+	FindOption flags, Sci::Position lengthFind, Report report) {
 	const bool caseSensitive = FlagSet(flags, FindOption::MatchCase);
 	const bool word = FlagSet(flags, FindOption::WholeWord);
 	const bool wordStart = FlagSet(flags, FindOption::WordStart);
-	const bool regExp = FlagSet(flags, FindOption::RegExp);
-	if (regExp) {
-		if (!regex)
-			regex = std::unique_ptr<RegexSearchBase>(CreateRegexSearch(&charClass));
-		return regex->FindText(this, minPos, maxPos, search, caseSensitive, word, wordStart, flags, length);
-	} else {
-
-		const bool forward = minPos <= maxPos;
-		const int increment = forward ? 1 : -1;
-
-		// Range endpoints should not be inside DBCS characters, but just in case, move them.
-		const Sci::Position startPos = MovePositionOutsideChar(minPos, increment, false);
-		const Sci::Position endPos = MovePositionOutsideChar(maxPos, increment, false);
-
-		// Compute actual search ranges needed
-		const Sci::Position lengthFind = *length;
-
-		//Platform::DebugPrintf("Find %d %d %s %d\n", startPos, endPos, ft->lpstrText, lengthFind);
-		const Sci::Position limitPos = std::max(startPos, endPos);
-		Sci::Position pos = startPos;
-		if (!forward) {
-			// Back all of a character
-			pos = NextPosition(pos, increment);
-		}
-		const SplitView cbView = cb.AllView();
-		if (caseSensitive) {
-			const Sci::Position endSearch = (startPos <= endPos) ? endPos - lengthFind + 1 : endPos;
-			const unsigned char charStartSearch =  search[0];
-			if (forward && ((0 == dbcsCodePage) || (CpUtf8 == dbcsCodePage && !UTF8IsTrailByte(charStartSearch)))) {
-				// This is a fast case where there is no need to test byte values to iterate
-				// so becomes the equivalent of a memchr+memcmp loop.
-				// UTF-8 search will not be self-synchronizing when starts with trail byte
-				const std::string_view suffix(search + 1, lengthFind - 1);
-				while (pos < endSearch) {
-					pos = SplitFindChar(cbView, pos, limitPos - pos, charStartSearch);
-					if (pos < 0) {
-						break;
-					}
-					if (SplitMatch(cbView, pos + 1, suffix) && MatchesWordOptions(word, wordStart, pos, lengthFind)) {
+	const bool forward = minPos <= maxPos;
+	const int increment = forward ? 1 : -1;
+
+	// Range endpoints should not be inside DBCS characters, but just in case, move them.
+	const Sci::Position startPos = MovePositionOutsideChar(minPos, increment, false);
+	const Sci::Position endPos = MovePositionOutsideChar(maxPos, increment, false);
+
+	//Platform::DebugPrintf("Find %d %d %s %d\n", startPos, endPos, ft->lpstrText, lengthFind);
+	// Matches may not extend past limitPos which moves back to each match found when searching backwards
+	Sci::Position limitPos = std::max(startPos, endPos);
+	Sci::Position pos = startPos;
+	if (!forward) {
+		// Back all of a character
+		pos = NextPosition(pos, increment);
+	}
+	if (caseSensitive) {
+		const Sci::Position endSearch = (startPos <= endPos) ? endPos - lengthFind + 1 : endPos;
+		const unsigned char charStartSearch =  search[0];
+		if (forward && ((0 == dbcsCodePage) || (CpUtf8 == dbcsCodePage && !UTF8IsTrailByte(charStartSearch)))) {
+			// This is a fast case where there is no need to test byte values to iterate
+			// so becomes the equivalent of a memchr+memcmp loop.
+			// UTF-8 search will not be self-synchronizing when starts with trail byte
+			const std::string_view suffix(search + 1, lengthFind - 1);
+			while (pos < endSearch) {
+				pos = SplitFindChar(cbView, pos, limitPos - pos, charStartSearch);
+				if (pos < 0) {
+					break;
+				}
+				if (SplitMatch(cbView, pos + 1, suffix) && MatchesWordOptions(word, wordStart, pos, lengthFind)) {
+					if (report(pos, lengthFind)) {
 						return pos;
 					}
-					pos++;
+					pos += lengthFind;
+					continue;
 				}
-			} else {
-				while (forward ? (pos < endSearch) : (pos >= endSearch)) {
-					const unsigned char leadByte = cbView.CharAt(pos);
-					if (leadByte == charStartSearch) {
-						bool found = (pos + lengthFind) <= limitPos;
-						// SplitMatch could be called here but it is slower with g++ -O2
-						for (int indexSearch = 1; (indexSearch < lengthFind) && found; indexSearch++) {
-							found = cbView.CharAt(pos + indexSearch) == search[indexSearch];
-						}
-						if (found && MatchesWordOptions(word, wordStart, pos, lengthFind)) {
+				pos++;
+			}
+		} else {
+			while (forward ? (pos < endSearch) : (pos >= endSearch)) {
+				const unsigned char leadByte = cbView.CharAt(pos);
+				if (leadByte == charStartSearch) {
+					bool found = (pos + lengthFind) <= limitPos;
+					// SplitMatch could be called here but it is slower with g++ -O2
+					for (int indexSearch = 1; (indexSearch < lengthFind) && found; indexSearch++) {
+						found = cbView.CharAt(pos + indexSearch) == search[indexSearch];
+					}
+					if (found && MatchesWordOptions(word, wordStart, pos, lengthFind)) {
+						if (report(pos, lengthFind)) {
 							return pos;
 						}
-					}
-					if (forward && UTF8IsAscii(leadByte)) {
-						pos++;
-					} else {
-						if (dbcsCodePage) {
-							if (!NextCharacter(pos, increment)) {
-								break;
-							}
-						} else {
-							pos += increment;
+						if (forward) {
+							pos += lengthFind;
+							continue;
 						}
+						limitPos = pos;
 					}
 				}
-			}
-		} else if (CpUtf8 == dbcsCodePage) {
-			constexpr size_t maxFoldingExpansion = 4;
-			std::vector<char> searchThing((lengthFind+1) * UTF8MaxBytes * maxFoldingExpansion + 1);
-			const size_t lenSearch =
-				pcf->Fold(searchThing.data(), searchThing.size(), search, lengthFind);
-			while (forward ? (pos < endPos) : (pos >= endPos)) {
-				int widthFirstCharacter = 1;
-				Sci::Position posIndexDocument = pos;
-				size_t indexSearch = 0;
-				bool characterMatches = true;
-				while (indexSearch < lenSearch) {
-					const unsigned char leadByte = cbView.CharAt(posIndexDocument);
-					int widthChar = 1;
-					size_t lenFlat = 1;
-					if (UTF8IsAscii(leadByte)) {
-						if ((posIndexDocument + 1) > limitPos) {
+				if (forward && UTF8IsAscii(leadByte)) {
+					pos++;
+				} else {
+					if (dbcsCodePage) {
+						if (!NextCharacter(pos, increment)) {
 							break;
 						}
-						characterMatches = searchThing[indexSearch] == MakeLowerCase(leadByte);
 					} else {
-						char bytes[UTF8MaxBytes]{ static_cast<char>(leadByte) };
-						const int widthCharBytes = UTF8BytesOfLead[leadByte];
-						for (int b = 1; b < widthCharBytes; b++) {
-							bytes[b] = cbView.CharAt(posIndexDocument + b);
-						}
-						widthChar = UTF8Classify(bytes, widthCharBytes) & UTF8MaskWidth;
-						if (!indexSearch) {	// First character
-							widthFirstCharacter = widthChar;
-						}
-						if ((posIndexDocument + widthChar) > limitPos) {
-							break;
-						}
-						char folded[UTF8MaxBytes * maxFoldingExpansion + 1];
-						lenFlat = pcf->Fold(folded, sizeof(folded), bytes, widthChar);
-						// memcmp may examine lenFlat bytes in both arguments so assert it doesn't read past end of searchThing
-						assert((indexSearch + lenFlat) <= searchThing.size());
-						// Does folded match the buffer
-						characterMatches = 0 == memcmp(folded, searchThing.data() + indexSearch, lenFlat);
-					}
-					if (!characterMatches) {
-						break;
+						pos += increment;
 					}
-					posIndexDocument += widthChar;
-					indexSearch += lenFlat;
 				}
-				if (characterMatches && (indexSearch == lenSearch)) {
-					if (MatchesWordOptions(word, wordStart, pos, posIndexDocument - pos)) {
-						*length = posIndexDocument - pos;
-						return pos;
-					}
+			}
+		}
+	} else if (CpUtf8 == dbcsCodePage) {
+		constexpr size_t maxFoldingExpansion = 4;
+		std::vector<char> searchThing((lengthFind+1) * UTF8MaxBytes * maxFoldingExpansion + 1);
+		const size_t lenSearch =
+			pcf->Fold(searchThing.data(), searchThing.size(), search, lengthFind);
+		std::optional<ByteSet> candidates;
+		if (forward && (lenSearch > 0)) {
+			// Only check positions where a character may fold to the first byte of the search
+			if (foldStarts.empty()) {
+				CalculateFoldStarts();
+			}
+			candidates.emplace(foldStarts, static_cast<unsigned char>(searchThing[0]) * 0x100);
+		}
+		while (forward ? (pos < endPos) : (pos >= endPos)) {
+			if (candidates) {
+				pos = SplitFindByteSet(cbView, pos, endPos - pos, *candidates);
+				if (pos < 0) {
+					break;
 				}
-				if (forward) {
-					pos += widthFirstCharacter;
-				} else {
-					if (!NextCharacter(pos, increment)) {
-						break;
-					}
+				if (UTF8IsTrailByte(cbView.CharAt(pos)) && (MovePositionOutsideChar(pos, -1, false) != pos)) {
+					// Inside a character
+					pos++;
+					continue;
 				}
 			}
-		} else if (dbcsCodePage) {
-			constexpr size_t maxBytesCharacter = 2;
-			constexpr size_t maxFoldingExpansion = 4;
-			std::vector<char> searchThing((lengthFind+1) * maxBytesCharacter * maxFoldingExpansion + 1);
-			const size_t lenSearch = pcf->Fold(searchThing.data(), searchThing.size(), search, lengthFind);
-			while (forward ? (pos < endPos) : (pos >= endPos)) {
-				int widthFirstCharacter = 0;
-				Sci::Position indexDocument = 0;
-				size_t indexSearch = 0;
-				bool characterMatches = true;
-				while (((pos + indexDocument) < limitPos) &&
-					(indexSearch < lenSearch)) {
-					const unsigned char leadByte = cbView.CharAt(pos + indexDocument);
-					const int widthChar = (!UTF8IsAscii(leadByte) && IsDBCSLeadByteNoExcept(leadByte)) ? 2 : 1;
-					if (!widthFirstCharacter) {
-						widthFirstCharacter = widthChar;
-					}
-					if ((pos + indexDocument + widthChar) > limitPos) {
+			int widthFirstCharacter = 1;
+			Sci::Position posIndexDocument = pos;
+			size_t indexSearch = 0;
+			bool characterMatches = true;
+			while (indexSearch < lenSearch) {
+				const unsigned char leadByte = cbView.CharAt(posIndexDocument);
+				int widthChar = 1;
+				size_t lenFlat = 1;
+				if (UTF8IsAscii(leadByte)) {
+					if ((posIndexDocument + 1) > limitPos) {
 						break;
 					}
-					size_t lenFlat = 1;
-					if (widthChar == 1) {
-						characterMatches = searchThing[indexSearch] == MakeLowerCase(leadByte);
-					} else {
-						const char bytes[maxBytesCharacter + 1] {
-							static_cast<char>(leadByte),
-							cbView.CharAt(pos + indexDocument + 1)
-						};
-						char folded[maxBytesCharacter * maxFoldingExpansion + 1];
-						lenFlat = pcf->Fold(folded, sizeof(folded), bytes, widthChar);
-						// memcmp may examine lenFlat bytes in both arguments so assert it doesn't read past end of searchThing
-						assert((indexSearch + lenFlat) <= searchThing.size());
-						// Does folded match the buffer
-						characterMatches = 0 == memcmp(folded, searchThing.data() + indexSearch, lenFlat);
+					characterMatches = searchThing[indexSearch] == MakeLowerCase(leadByte);
+				} else {
+					char bytes[UTF8MaxBytes]{ static_cast<char>(leadByte) };
+					const int widthCharBytes = UTF8BytesOfLead[leadByte];
+					for (int b = 1; b < widthCharBytes; b++) {
+						bytes[b] = cbView.CharAt(posIndexDocument + b);
 					}
-					if (!characterMatches) {
+					widthChar = UTF8Classify(bytes, widthCharBytes) & UTF8MaskWidth;
+					if (!indexSearch) {	// First character
+						widthFirstCharacter = widthChar;
+					}
+					if ((posIndexDocument + widthChar) > limitPos) {
 						break;
 					}
-					indexDocument += widthChar;
-					indexSearch += lenFlat;
+					char folded[UTF8MaxBytes * maxFoldingExpansion + 1];
+					lenFlat = pcf->Fold(folded, sizeof(folded), bytes, widthChar);
+					// memcmp may examine lenFlat bytes in both arguments so assert it doesn't read past end of searchThing
+					assert((indexSearch + lenFlat) <= searchThing.size());
+					// Does folded match the buffer
+					characterMatches = 0 == memcmp(folded, searchThing.data() + indexSearch, lenFlat);
+				}
+				if (!characterMatches) {
+					break;
 				}
-				if (characterMatches && (indexSearch == lenSearch)) {
-					if (MatchesWordOptions(word, wordStart, pos, indexDocument)) {
-						*length = indexDocument;
+				posIndexDocument += widthChar;
+				indexSearch += lenFlat;
+			}
+			if (characterMatches && (indexSearch == lenSearch)) {
+				if (MatchesWordOptions(word, wordStart, pos, posIndexDocument - pos)) {
+					if (report(pos, posIndexDocument - pos)) {
 						return pos;
 					}
+					if (!forward) {
+						limitPos = pos;
+					} else if (posIndexDocument > pos) {
+						pos = posIndexDocument;
+						continue;
+					}
 				}
-				if (forward) {
-					pos += widthFirstCharacter;
+			}
+			if (forward) {
+				pos += widthFirstCharacter;
+			} else {
+				if (!NextCharacter(pos, increment)) {
+					break;
+				}
+			}
+		}
+	} else if (dbcsCodePage) {
+		constexpr size_t maxBytesCharacter = 2;
+		constexpr size_t maxFoldingExpansion = 4;
+		std::vector<char> searchThing((lengthFind+1) * maxBytesCharacter * maxFoldingExpansion + 1);
+		const size_t lenSearch = pcf->Fold(searchThing.data(), searchThing.size(), search, lengthFind);
+		while (forward ? (pos < endPos) : (pos >= endPos)) {
+			int widthFirstCharacter = 0;
+			Sci::Position indexDocument = 0;
+			size_t indexSearch = 0;
+			bool characterMatches = true;
+			while (((pos + indexDocument) < limitPos) &&
+				(indexSearch < lenSearch)) {
+				const unsigned char leadByte = cbView.CharAt(pos + indexDocument);
+				const int widthChar = (!UTF8IsAscii(leadByte) && IsDBCSLeadByteNoExcept(leadByte)) ? 2 : 1;
+				if (!widthFirstCharacter) {
+					widthFirstCharacter = widthChar;
+				}
+				if ((pos + indexDocument + widthChar) > limitPos) {
+					break;
+				}
+				size_t lenFlat = 1;
+				if (widthChar == 1) {
+					characterMatches = searchThing[indexSearch] == MakeLowerCase(leadByte);
 				} else {
-					if (!NextCharacter(pos, increment)) {
-						break;
-					}
+					const char bytes[maxBytesCharacter + 1] {
+						static_cast<char>(leadByte),
+						cbView.CharAt(pos + indexDocument + 1)
+					};
+					char folded[maxBytesCharacter * maxFoldingExpansion + 1];
+					lenFlat = pcf->Fold(folded, sizeof(folded), bytes, widthChar);
+					// memcmp may examine lenFlat bytes in both arguments so assert it doesn't read past end of searchThing
+					assert((indexSearch + lenFlat) <= searchThing.size());
+					// Does folded match the buffer
+					characterMatches = 0 == memcmp(folded, searchThing.data() + indexSearch, lenFlat);
 				}
+				if (!characterMatches) {
+					break;
+				}
+				indexDocument += widthChar;
+				indexSearch += lenFlat;
 			}
-		} else {
-			const Sci::Position endSearch = (startPos <= endPos) ? endPos - lengthFind + 1 : endPos;
-			std::vector<char> searchThing(lengthFind + 1);
-			pcf->Fold(searchThing.data(), searchThing.size(), search, lengthFind);
-			while (forward ? (pos < endSearch) : (pos >= endSearch)) {
-				bool found = (pos + lengthFind) <= limitPos;
-				for (int indexSearch = 0; (indexSearch < lengthFind) && found; indexSearch++) {
-					const char ch = cbView.CharAt(pos + indexSearch);
-					const char chTest = searchThing[indexSearch];
-					if (UTF8IsAscii(ch)) {
-						found = chTest == MakeLowerCase(ch);
-					} else {
-						char folded[2];
-						pcf->Fold(folded, sizeof(folded), &ch, 1);
-						found = folded[0] == chTest;
+			if (characterMatches && (indexSearch == lenSearch)) {
+				if (MatchesWordOptions(word, wordStart, pos, indexDocument)) {
+					if (report(pos, indexDocument)) {
+						return pos;
 					}
+					if (!forward) {
+						limitPos = pos;
+					} else if (indexDocument > 0) {
+						pos += indexDocument;
+						continue;
+					}
+				}
+			}
+			if (forward) {
+				pos += widthFirstCharacter;
+			} else {
+				if (!NextCharacter(pos, increment)) {
+					break;
 				}
-				if (found && MatchesWordOptions(word, wordStart, pos, lengthFind)) {
+			}
+		}
+	} else {
+		const Sci::Position endSearch = (startPos <= endPos) ? endPos - lengthFind + 1 : endPos;
+		std::vector<char> searchThing(lengthFind + 1);
+		pcf->Fold(searchThing.data(), searchThing.size(), search, lengthFind);
+		while (forward ? (pos < endSearch) : (pos >= endSearch)) {
+			bool found = (pos + lengthFind) <= limitPos;
+			for (int indexSearch = 0; (indexSearch < lengthFind) && found; indexSearch++) {
+				const char ch = cbView.CharAt(pos + indexSearch);
+				const char chTest = searchThing[indexSearch];
+				if (UTF8IsAscii(ch)) {
+					found = chTest == MakeLowerCase(ch);
+				} else {
+					char folded[2];
+					pcf->Fold(folded, sizeof(folded), &ch, 1);
+					found = folded[0] == chTest;
+				}
+			}
+			if (found && MatchesWordOptions(word, wordStart, pos, lengthFind)) {
+				if (report(pos, lengthFind)) {
 					return pos;
 				}
-				pos += increment;
+				if (forward) {
+					pos += lengthFind;
+					continue;
+				}
+				limitPos = pos;
 			}
+			pos += increment;
 		}
 	}
 	//Platform::DebugPrintf("Not found\n");
 	return -1;
 }
 
+template <typename Report>
+Sci::Position Document::ScanText(Sci::Position minPos, Sci::Position maxPos, const char *search,
+	FindOption flags, Sci::Position lengthFind, Report report) {
+	if (cb.IsPieceTree()) {
+		return ScanView(PieceView { cb }, minPos, maxPos, search, flags, lengthFind, report);
+	}
+	return ScanView(cb.AllView(), minPos, maxPos, search, flags, lengthFind, report);
+}
+
+/**
+ * Find text in document, supporting both forward and backward
+ * searches (just pass minPos > maxPos to do a backward search)
+ * Has not been tested with backwards DBCS searches yet.
+ */
+Sci::Position Document::FindText(Sci::Position minPos, Sci::Position maxPos, const char *search,
+                        FindOption flags, Sci::Position *length) {
+	if (*length <= 0)
+		return minPos;
+	if (ParallelSearch(minPos, maxPos, flags)) {
+		return FindTextParallel(minPos, maxPos, search, flags, length);
+	}
+	if (FlagSet(flags, FindOption::RegExp)) {
+		if (!regex)
+			regex = std::unique_ptr<RegexSearchBase>(CreateRegexSearch(&charClass));
+		const bool caseSensitive = FlagSet(flags, FindOption::MatchCase);
+		const bool word = FlagSet(flags, FindOption::WholeWord);
+		const bool wordStart = FlagSet(flags, FindOption::WordStart);
+		return regex->FindText(this, minPos, maxPos, search, caseSensitive, word, wordStart, flags, length);
+	}
+	return ScanText(minPos, maxPos, search, flags, *length,
+		[length](Sci::Position, Sci::Position lengthFound) {
+			*length = lengthFound;
+			return true;
+		});
+}
+
+/**
+ * Find every match in a range, searching forwards, and return how many there are.
+ * When found is not null, the range of each match is appended to it.
+ * Searching stops after maxMatches unless it is 0.
+ */
+Sci::Position Document::FindAll(Sci::Position minPos, Sci::Position maxPos, const char *search, FindOption flags,
+	Sci::Position length, Sci::Position maxMatches, std::vector<Range> *found) {
+	if (length <= 0) {
+		return 0;
+	}
+	if (minPos > maxPos) {
+		std::swap(minPos, maxPos);
+	}
+	if (ParallelSearch(minPos, maxPos, flags)) {
+		return FindAllParallel(minPos, maxPos, search, flags, length, maxMatches, found);
+	}
+	if (!FlagSet(flags, FindOption::RegExp)) {
+		// Literal text is found in one scan instead of setting up a search for each match
+		Sci::Position matches = 0;
+		ScanText(minPos, maxPos, search, flags, length,
+			[&](Sci::Position posFound, Sci::Position lengthFound) {
+				matches++;
+				if (found) {
+					found->emplace_back(posFound, posFound + lengthFound);
+				}
+				return maxMatches && (matches >= maxMatches);
+			});
+		return matches;
+	}
+	return FindEach(this, minPos, maxPos, length, maxMatches,
+		[&](Sci::Position pos, Sci::Position *lengthFound) {
+			return FindText(pos, maxPos, search, flags, lengthFound);
+		},
+		[found](Sci::Position posFound, Sci::Position lengthFound) {
+			if (found) {
+				found->emplace_back(posFound, posFound + lengthFound);
+			}
+		});
+}
+
+bool Document::ParallelSearch(Sci::Position minPos, Sci::Position maxPos, FindOption flags) const noexcept {
+	// Chunks of a piece tree may be copied together by RangePointer which modifies the tree
+	// so piece trees are searched on one thread.
+	// std::regex matches may cross line ends so can not be divided into lines.
+	return FlagSet(flags, FindOption::Parallel) && !cb.IsPieceTree() &&
+		!(FlagSet(flags, FindOption::RegExp) && FlagSet(flags, FindOption::Cxx11RegEx)) &&
+		(std::abs(maxPos - minPos) >= searchChunkSize * searchChunksMinimum);
+}
+
+void Document::PrepareParallelSearch(bool regExp, bool caseSensitive, Sci::Position gapTarget) {
+	if (!searchPool) {
+		searchPool = std::make_unique<ThreadPool>();
+		searchPool->SetThreads(std::thread::hardware_concurrency());
+	}
+	// Perform any lazy initialization that would otherwise modify the document from several threads
+	if (!caseSensitive && (CpUtf8 == dbcsCodePage) && foldStarts.empty()) {
+		CalculateFoldStarts();
+	}
+	if (regExp && (gapTarget < cb.GapPosition())) {
+		// Move the gap to a chunk boundary so RangePointer does not need to move it
+		cb.RangePointer(gapTarget, cb.GapPosition() - gapTarget + 1);
+	}
+}
+
+/**
+ * Search a large range by dividing it into chunks and searching a batch of chunks
+ * together, in the direction of the search, until one contains a match.
+ * Finds the same match as searching sequentially.
+ */
+Sci::Position Document::FindTextParallel(Sci::Position minPos, Sci::Position maxPos, const char *search,
+	FindOption flags, Sci::Position *length) {
+	const bool caseSensitive = FlagSet(flags, FindOption::MatchCase);
+	const bool word = FlagSet(flags, FindOption::WholeWord);
+	const bool wordStart = FlagSet(flags, FindOption::WordStart);
+	const bool regExp = FlagSet(flags, FindOption::RegExp);
+	const FindOption flagsChunk = static_cast<FindOption>(static_cast<int>(flags) & ~static_cast<int>(FindOption::Parallel));
+	const bool forward = minPos <= maxPos;
+	const Sci::Position rangeEnd = std::max(minPos, maxPos);
+	// Case insensitive matches may be longer than the search text as characters may fold to shorter text
+	constexpr Sci::Position maxFoldingExpansion = 4;
+	const Sci::Position overlap = caseSensitive ? *length : *length * UTF8MaxBytes * maxFoldingExpansion;
+	const std::vector<SearchChunk> chunks = SearchChunks(this, std::min(minPos, maxPos), rangeEnd, overlap, regExp);
+	PrepareParallelSearch(regExp, caseSensitive, ChunkStartContaining(this, chunks, cb.GapPosition(), regExp));
+
+	auto findInChunk = [&](const SearchChunk &chunk, RegexSearchBase *chunkRegex, Sci::Position *lengthFound) {
+		const Sci::Position chunkMin = forward ? chunk.start : chunk.limit;
+		const Sci::Position chunkMax = forward ? chunk.limit : chunk.start;
+		if (chunkRegex) {
+			return chunkRegex->FindText(this, chunkMin, chunkMax, search, caseSensitive, word, wordStart, flagsChunk, lengthFound);
+		}
+		return FindText(chunkMin, chunkMax, search, flagsChunk, lengthFound);
+	};
+
+	const size_t batch = searchPool->Threads();
+	std::vector<Sci::Position> positions;
+	std::vector<Sci::Position> lengths;
+	for (size_t first = 0; first < chunks.size(); first += batch) {
+		const size_t count = std::min(batch, chunks.size() - first);
+		positions.assign(count, -1);
+		lengths.assign(count, 0);
+		auto chunkAt = [&](size_t index) -> const SearchChunk & {
+			return chunks[forward ? first + index : chunks.size() - 1 - first - index];
+		};
+		searchPool->Run(count, [&](size_t index) {
+			const SearchChunk &chunk = chunkAt(index);
+			std::unique_ptr<RegexSearchBase> chunkRegex;
+			if (regExp) {
+				chunkRegex.reset(CreateRegexSearch(&charClass));
+			}
+			Sci::Position lengthFound = *length;
+			const Sci::Position pos = findInChunk(chunk, chunkRegex.get(), &lengthFound);
+			// Matches starting after the chunk are found by the following chunk
+			if ((pos >= 0) && ((pos < chunk.end) || (chunk.end == rangeEnd))) {
+				positions[index] = pos;
+				lengths[index] = lengthFound;
+			}
+		});
+		for (size_t index = 0; index < count; index++) {
+			if (positions[index] >= 0) {
+				if (regExp) {
+					// Search the chunk again so the match is available to SubstituteByPosition
+					if (!regex) {
+						regex = std::unique_ptr<RegexSearchBase>(CreateRegexSearch(&charClass));
+					}
+					Sci::Position lengthFound = *length;
+					[[maybe_unused]] const Sci::Position pos = findInChunk(chunkAt(index), regex.get(), &lengthFound);
+					assert(pos == positions[index]);
+				}
+				*length = lengths[index];
+				return positions[index];
+			}
+		}
+	}
+	return -1;
+}
+
+/**
+ * Find every match in a large range by searching chunks in parallel.
+ * When a match crosses into the following chunk, that chunk is searched again from the end of the match.
+ */
+Sci::Position Document::FindAllParallel(Sci::Position minPos, Sci::Position maxPos, const char *search, FindOption flags,
+	Sci::Position length, Sci::Position maxMatches, std::vector<Range> *found) {
+	const bool caseSensitive = FlagSet(flags, FindOption::MatchCase);
+	const bool word = FlagSet(flags, FindOption::WholeWord);
+	const bool wordStart = FlagSet(flags, FindOption::WordStart);
+	const bool regExp = FlagSet(flags, FindOption::RegExp);
+	const FindOption flagsChunk = static_cast<FindOption>(static_cast<int>(flags) & ~static_cast<int>(FindOption::Parallel));
+	constexpr Sci::Position maxFoldingExpansion = 4;
+	const Sci::Position overlap = caseSensitive ? length : length * UTF8MaxBytes * maxFoldingExpansion;
+	const std::vector<SearchChunk> chunks = SearchChunks(this, minPos, maxPos, overlap, regExp);
+	PrepareParallelSearch(regExp, caseSensitive, ChunkStartContaining(this, chunks, cb.GapPosition(), regExp));
+
+	auto findAllInChunk = [&](const SearchChunk &chunk, Sci::Position from) {
+		const Sci::Position chunkEnd = (chunk.end == maxPos) ? chunk.end + 1 : chunk.end;
+		std::vector<Range> ranges;
+		if (!regExp) {
+			ScanText(from, chunk.limit, search, flagsChunk, length,
+				[&](Sci::Position posFound, Sci::Position lengthFound) {
+					// Matches starting after the chunk are found by the following chunk
+					if (posFound >= chunkEnd) {
+						return true;
+					}
+					ranges.emplace_back(posFound, posFound + lengthFound);
+					return maxMatches && (static_cast<Sci::Position>(ranges.size()) >= maxMatches);
+				});
+			return ranges;
+		}
+		const std::unique_ptr<RegexSearchBase> chunkRegex(CreateRegexSearch(&charClass));
+		FindEach(this, from, chunk.limit, length, maxMatches,
+			[&](Sci::Position pos, Sci::Position *lengthFound) -> Sci::Position {
+				const Sci::Position posFound =
+					chunkRegex->FindText(this, pos, chunk.limit, search, caseSensitive, word, wordStart, flagsChunk, lengthFound);
+				// Matches starting after the chunk are found by the following chunk
+				return (posFound < chunkEnd) ? posFound : -1;
+			},
+			[&ranges](Sci::Position posFound, Sci::Position lengthFound) {
+				ranges.emplace_back(posFound, posFound + lengthFound);
+			});
+		return ranges;
+	};
+
+	std::vector<std::vector<Range>> chunkRanges(chunks.size());
+	searchPool->Run(chunks.size(), [&](size_t index) {
+		chunkRanges[index] = findAllInChunk(chunks[index], chunks[index].start);
+	});
+
+	Sci::Position matches = 0;
+	Sci::Position lastEnd = minPos;
+	for (size_t index = 0; index < chunks.size(); index++) {
+		if (lastEnd > chunks[index].start) {
+			chunkRanges[index] = findAllInChunk(chunks[index], lastEnd);
+		}
+		for (const Range &range : chunkRanges[index]) {
+			matches++;
+			if (found) {
+				found->push_back(range);
+			}
+			if (maxMatches && (matches >= maxMatches)) {
+				return matches;
+			}
+			lastEnd = range.end;
+		}
+	}
+	return matches;
+}
+
 const char *Document::SubstituteByPosition(const char *text, Sci::Position *length) {
 	if (regex) {
 		return regex->SubstituteByPosition(this, text, length);
@@ -2563,10 +3244,16 @@ void Document::AllocateLines(Sci::Line lines) {
 
 void Document::SetDefaultCharClasses(bool includeWordClass) {
 	charClass.SetDefaultCharClasses(includeWordClass);
+	if (regex) {
+		regex->ClearCache();
+	}
 }
 
 void Document::SetCharClasses(const unsigned char *chars, CharacterClass newCharClass) {
 	charClass.SetCharClasses(chars, newCharClass);
+	if (regex) {
+		regex->ClearCache();
+	}
 }
 
 int Document::GetCharsOfClass(CharacterClass characterClass, unsigned char *buffer) const {
@@ -2621,8 +3308,12 @@ void Document::EnsureStyledTo(Sci::Position pos) {
 	if ((enteredStyling == 0) && (pos > GetEndStyled())) {
 		IncrementStyleClock();
 		if (pli && !pli->UseContainerLexing()) {
-			const Sci::Position endStyledTo = LineStartPosition(GetEndStyled());
-			pli->Colourise(endStyledTo, pos);
+			// Lexer is needed on this thread so background styling must stop
+			pli->StopBackgroundStyling();
+			if (pos > GetEndStyled()) {
+				const Sci::Position endStyledTo = LineStartPosition(GetEndStyled());
+				pli->Colourise(endStyledTo, pos);
+			}
 		} else {
 			// Ask the watchers to style, and stop as soon as one responds.
 			for (std::vector<WatcherWithUserData>::iterator it = watchers.begin();
@@ -2640,6 +3331,68 @@ void Document::StyleToAdjustingLineDuration(Sci::Position pos) {
 	durationStyleOneByte.AddSample(pos - stylingStart, epStyling.Duration());
 }
 
+bool Document::StyleInBackground(bool wait) {
+	if ((enteredStyling != 0) || !pli || pli->UseContainerLexing()) {
+		return false;
+	}
+	const Sci::Position endStyledBefore = GetEndStyled();
+	const bool styling = pli->StyleInBackground(wait);
+	if (GetEndStyled() != endStyledBefore) {
+		IncrementStyleClock();
+	}
+	return styling;
+}
+
+// Copy the document for a lexer to run on another thread.
+std::unique_ptr<StyleSnapshot> Document::SnapshotForStyling() const {
+	std::unique_ptr<StyleSnapshot> snapshot = std::make_unique<StyleSnapshot>();
+	UpdateSnapshot(*snapshot, 0);
+	return snapshot;
+}
+
+// Replace the text, styles, and per-line values of a snapshot from start, which is a line
+// start that the document has not changed before, so edits only copy what follows them.
+void Document::UpdateSnapshot(StyleSnapshot &snapshot, Sci::Position start) const {
+	const Sci::Position length = LengthNoExcept();
+	start = std::clamp<Sci::Position>(start, 0, std::min<Sci::Position>(snapshot.text.length(), length));
+	snapshot.text.resize(start);
+	snapshot.text.resize(length);
+	cb.GetCharRange(snapshot.text.data() + start, start, length - start);
+	snapshot.styles.resize(start);
+	snapshot.styles.resize(length);
+	cb.GetStyleRange(reinterpret_cast<unsigned char *>(snapshot.styles.data() + start), start, length - start);
+	const Sci::Line lineStart = SciLineFromPosition(start);
+	const Sci::Line lines = LinesTotal();
+	snapshot.lineStarts.resize(lineStart);
+	snapshot.levels.resize(lineStart);
+	snapshot.lineStates.resize(lineStart);
+	snapshot.lineStarts.reserve(lines + 1);
+	snapshot.levels.reserve(lines);
+	snapshot.lineStates.reserve(lines);
+	for (Sci::Line line = lineStart; line < lines; line++) {
+		snapshot.lineStarts.push_back(cb.LineStart(line));
+		snapshot.levels.push_back(GetLevel(line));
+		snapshot.lineStates.push_back(GetLineState(line));
+	}
+	snapshot.lineStarts.push_back(length);
+	snapshot.codePage = dbcsCodePage;
+	snapshot.unicodeLineEnds = GetLineEndTypesActive() == LineEndType::Unicode;
+	snapshot.tabInChars = tabInChars;
+}
+
+// Copy styles and per-line values for [start, end) into a snapshot of unchanged text.
+void Document::RefreshSnapshot(StyleSnapshot &snapshot, Sci::Position start, Sci::Position end) const {
+	if (start >= end) {
+		return;
+	}
+	cb.GetStyleRange(reinterpret_cast<unsigned char *>(snapshot.styles.data() + start), start, end - start);
+	const Sci::Line lineLast = std::min(SciLineFromPosition(end), LinesTotal() - 1);
+	for (Sci::Line line = SciLineFromPosition(start); line <= lineLast; line++) {
+		snapshot.levels[line] = GetLevel(line);
+		snapshot.lineStates[line] = GetLineState(line);
+	}
+}
+
 LexInterface *Document::GetLexInterface() const noexcept {
 	return pli.get();
 }
@@ -3055,12 +3808,46 @@ Sci::Position Document::BraceMatch(Sci::Position position, Sci::Position /*maxRe
 	return -1;
 }
 
+namespace {
+
+/**
+* RegexKey identifies a compiled pattern so that repeated searches, such as
+* find next or replace all, do not compile the same pattern again.
+*/
+struct RegexKey {
+	std::string pattern;
+	bool caseSensitive = false;
+	bool posix = false;
+	int codePage = 0;
+	bool operator==(const RegexKey &other) const noexcept {
+		return (pattern == other.pattern) && (caseSensitive == other.caseSensitive) &&
+			(posix == other.posix) && (codePage == other.codePage);
+	}
+	bool operator!=(const RegexKey &other) const noexcept {
+		return !(*this == other);
+	}
+};
+
+#ifndef NO_CXX11_REGEX
+
+struct Cxx11Pattern {
+	std::optional<RegexKey> key;
+	std::regex regexp;
+	std::wregex wregexp;
+};
+
+#endif
+
+class RESearchRange;
+
+}
+
 /**
  * Implementation of RegexSearchBase for the default built-in regular expression engine
  */
 class BuiltinRegex : public RegexSearchBase {
 public:
-	explicit BuiltinRegex(CharClassify *charClassTable) : search(charClassTable) {}
+	explicit BuiltinRegex(CharClassify *charClassTable) : search(charClassTable), linear(charClassTable) {}
 
 	Sci::Position FindText(Document *doc, Sci::Position minPos, Sci::Position maxPos, const char *s,
                         bool caseSensitive, bool word, bool wordStart, FindOption flags,
@@ -3068,9 +3855,20 @@ public:
 
 	const char *SubstituteByPosition(Document *doc, const char *text, Sci::Position *length) override;
 
+	void ClearCache() noexcept override;
+
 private:
 	RESearch search;
+	std::optional<RegexKey> keySearch;
+	LinearRegex linear;
+	std::optional<RegexKey> keyLinear;
+	const char *errorLinear = nullptr;
+#ifndef NO_CXX11_REGEX
+	Cxx11Pattern cxx11;
+#endif
 	std::string substituted;
+
+	Sci::Position LinearFindText(Document *doc, const RESearchRange &resr, Sci::Position *length);
 };
 
 namespace {
@@ -3416,7 +4214,7 @@ bool MatchOnLines(const Document *doc, const Regex &regexp, const RESearchRange
 }
 
 Sci::Position Cxx11RegexFindText(const Document *doc, Sci::Position minPos, Sci::Position maxPos, const char *s,
-	bool caseSensitive, Sci::Position *length, RESearch &search) {
+	bool caseSensitive, Sci::Position *length, RESearch &search, Cxx11Pattern &compiled) {
 	const RESearchRange resr(doc, minPos, maxPos);
 	try {
 		//ElapsedPeriod ep;
@@ -3430,19 +4228,26 @@ Sci::Position Cxx11RegexFindText(const Document *doc, Sci::Position minPos, Sci:
 		flagsRe = flagsRe | std::regex::multiline;
 #endif
 
+		// Constructing a std::regex is expensive so only do so when the pattern changes
+		const RegexKey key { s, caseSensitive, false, doc->dbcsCodePage };
+		if (compiled.key != key) {
+			compiled.key.reset();
+			if (CpUtf8 == doc->dbcsCodePage) {
+				compiled.wregexp.assign(WStringFromUTF8(s), flagsRe);
+			} else {
+				compiled.regexp.assign(s, flagsRe);
+			}
+			compiled.key = key;
+		}
+
 		// Clear the RESearch so can fill in matches
 		search.Clear();
 
 		bool matched = false;
 		if (CpUtf8 == doc->dbcsCodePage) {
-			const std::wstring ws = WStringFromUTF8(s);
-			std::wregex regexp;
-			regexp.assign(ws, flagsRe);
-			matched = MatchOnLines<UTF8Iterator>(doc, regexp, resr, search);
+			matched = MatchOnLines<UTF8Iterator>(doc, compiled.wregexp, resr, search);
 		} else {
-			std::regex regexp;
-			regexp.assign(s, flagsRe);
-			matched = MatchOnLines<ByteIterator>(doc, regexp, resr, search);
+			matched = MatchOnLines<ByteIterator>(doc, compiled.regexp, resr, search);
 		}
 
 		Sci::Position posMatch = -1;
@@ -3476,7 +4281,7 @@ Sci::Position BuiltinRegex::FindText(Document *doc, Sci::Position minPos, Sci::P
 #ifndef NO_CXX11_REGEX
 	if (FlagSet(flags, FindOption::Cxx11RegEx)) {
 			return Cxx11RegexFindText(doc, minPos, maxPos, s,
-			caseSensitive, length, search);
+			caseSensitive, length, search, cxx11);
 	}
 #endif
 
@@ -3484,9 +4289,34 @@ Sci::Position BuiltinRegex::FindText(Document *doc, Sci::Position minPos, Sci::P
 
 	const bool posix = FlagSet(flags, FindOption::Posix);
 
-	const char *errmsg = search.Compile(s, *length, caseSensitive, posix);
-	if (errmsg) {
-		return -1;
+	const RegexKey key { std::string(s, *length), caseSensitive, posix, doc->dbcsCodePage };
+
+	// The linear engine reads memory directly so can not handle DBCS and can not
+	// perform back references so these fall back to RESearch.
+	if (FlagSet(flags, FindOption::LinearRegEx) && *length &&
+		((doc->dbcsCodePage == 0) || (doc->dbcsCodePage == CpUtf8))) {
+		if (keyLinear != key) {
+			keyLinear.reset();
+			errorLinear = linear.Compile(key.pattern, caseSensitive, posix, doc->dbcsCodePage == CpUtf8);
+			keyLinear = key;
+		}
+		if (!errorLinear) {
+			return LinearFindText(doc, resr, length);
+		} else if (errorLinear != LinearRegex::unsupportedBackReference) {
+			return -1;
+		}
+	}
+
+	// An empty pattern reuses the previous pattern
+	if (!*length || (keySearch != key)) {
+		keySearch.reset();
+		const char *errmsg = search.Compile(s, *length, caseSensitive, posix);
+		if (errmsg) {
+			return -1;
+		}
+		if (*length) {
+			keySearch = key;
+		}
 	}
 	// Find a variable in a property file: \$(\([A-Za-z0-9_.]+\))
 	// Replace first '.' with '-' in each property file variable reference:
@@ -3561,6 +4391,60 @@ Sci::Position BuiltinRegex::FindText(Document *doc, Sci::Position minPos, Sci::P
 	return pos;
 }
 
+Sci::Position BuiltinRegex::LinearFindText(Document *doc, const RESearchRange &resr, Sci::Position *length) {
+	// Matches do not cross line ends so search blocks of whole lines, from the end
+	// of the range when searching backwards, to stop early and to limit the text
+	// that RangePointer has to make contiguous.
+	constexpr Sci::Position blockSize = 0x10000;
+	const bool forward = resr.increment == 1;
+	const Sci::Position rangeStart = forward ? resr.startPos : resr.endPos;
+	const Sci::Position rangeEnd = forward ? resr.endPos : resr.startPos;
+	const Sci::Line lineFirst = forward ? resr.lineRangeStart : resr.lineRangeEnd;
+	const Sci::Line lineLast = forward ? resr.lineRangeEnd : resr.lineRangeStart;
+	Sci::Line line = forward ? lineFirst : lineLast;
+	while ((line >= lineFirst) && (line <= lineLast)) {
+		Sci::Line blockFirst = line;
+		Sci::Line blockLast = line;
+		if (forward) {
+			while ((blockLast < lineLast) && (doc->LineStart(blockLast + 1) - doc->LineStart(blockFirst) < blockSize)) {
+				blockLast++;
+			}
+		} else {
+			while ((blockFirst > lineFirst) && (doc->LineEnd(blockLast) - doc->LineStart(blockFirst - 1) < blockSize)) {
+				blockFirst--;
+			}
+		}
+		const Sci::Position textStart = doc->LineStart(blockFirst);
+		const Sci::Position textEnd = doc->LineEnd(blockLast);
+		const std::string_view text(doc->RangePointer(textStart, textEnd - textStart), textEnd - textStart);
+		const Sci::Position start = std::max(rangeStart, textStart) - textStart;
+		const Sci::Position end = std::min(rangeEnd, textEnd) - textStart;
+		if (linear.Execute(text, start, end, !forward)) {
+			// Copy into RESearch so SubstituteByPosition can be shared
+			search.Clear();
+			for (int tag = 0; tag < LinearRegex::MAXTAG; tag++) {
+				if (linear.bopat[tag] != LinearRegex::NOTFOUND) {
+					search.bopat[tag] = linear.bopat[tag] + textStart;
+					search.eopat[tag] = linear.eopat[tag] + textStart;
+				}
+			}
+			*length = search.eopat[0] - search.bopat[0];
+			return search.bopat[0];
+		}
+		line = forward ? blockLast + 1 : blockFirst - 1;
+	}
+	*length = 0;
+	return -1;
+}
+
+void BuiltinRegex::ClearCache() noexcept {
+	keySearch.reset();
+	keyLinear.reset();
+#ifndef NO_CXX11_REGEX
+	cxx11.key.reset();
+#endif
+}
+
 const char *BuiltinRegex::SubstituteByPosition(Document *doc, const char *text, Sci::Position *length) {
 	substituted.clear();
 	for (Sci::Position j = 0; j < *length; j++) {
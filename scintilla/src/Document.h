@@ -17,6 +17,9 @@ class LineMarkers;
 class LineLevels;
 class LineState;
 class LineAnnotation;
+class StyleSnapshot;
+class BackgroundStyling;
+class ThreadPool;
 
 enum class EncodingFamily { eightBit, unicode, dbcs };
 
@@ -105,6 +108,9 @@ public:
 
 	///@return String with the substitutions, must remain valid until the next call or destruction
 	virtual const char *SubstituteByPosition(Document *doc, const char *text, Sci::Position *length) = 0;
+
+	/// Forget compiled patterns as they may depend on character classes
+	virtual void ClearCache() noexcept {}
 };
 
 /// Factory function for RegexSearchBase
@@ -214,6 +220,11 @@ protected:
 	Document *pdoc;
 	LexerInstance instance;
 	bool performingStyle;	///< Prevent reentrance
+	std::unique_ptr<BackgroundStyling> background;
+	bool backgroundStale;	///< Document changed since background styling started
+	Sci::Position backgroundChangeStart;	///< Lowest position changed when backgroundStale
+	Sci::Position backgroundApplied;	///< End of the background styling applied to the document
+	void CommitBackgroundStyling(bool wait);
 public:
 	explicit LexInterface(Document *pdoc_) noexcept;
 	// Deleted so LexInterface objects can not be copied.
@@ -224,6 +235,9 @@ public:
 	virtual ~LexInterface() noexcept;
 	void SetInstance(ILexer5 *instance_) noexcept;
 	void Colourise(Sci::Position start, Sci::Position end);
+	bool StyleInBackground(bool wait);
+	void StopBackgroundStyling();
+	void InvalidateBackgroundStyling(Sci::Position position) noexcept;
 	virtual Scintilla::LineEndType LineEndTypesSupported();
 	bool UseContainerLexing() const noexcept;
 };
@@ -301,6 +315,12 @@ private:
 	CharClassify charClass;
 	CharacterCategoryMap charMap;
 	std::unique_ptr<CaseFolder> pcf;
+	// Whether a character with a lead byte can fold to text starting with a byte,
+	// indexed by folded byte * 256 + lead byte. Filled by the first case
+	// insensitive UTF-8 search with the current case folder.
+	std::vector<bool> foldStarts;
+	// Threads for FindOption::Parallel searches, created by the first such search
+	std::unique_ptr<ThreadPool> searchPool;
 	Sci::Position endStyled;
 	int styleClock;
 	int enteredModification;
@@ -321,6 +341,18 @@ private:
 	LineAnnotation *Margins() const noexcept;
 	LineAnnotation *Annotations() const noexcept;
 	LineAnnotation *EOLAnnotations() const noexcept;
+	void CalculateFoldStarts();
+	template <typename View, typename Report>
+	Sci::Position ScanView(const View &cbView, Sci::Position minPos, Sci::Position maxPos, const char *search,
+		Scintilla::FindOption flags, Sci::Position lengthFind, Report report);
+	template <typename Report>
+	Sci::Position ScanText(Sci::Position minPos, Sci::Position maxPos, const char *search, Scintilla::FindOption flags,
+		Sci::Position lengthFind, Report report);
+	bool ParallelSearch(Sci::Position minPos, Sci::Position maxPos, Scintilla::FindOption flags) const noexcept;
+	void PrepareParallelSearch(bool regExp, bool caseSensitive, Sci::Position gapTarget);
+	Sci::Position FindTextParallel(Sci::Position minPos, Sci::Position maxPos, const char *search, Scintilla::FindOption flags, Sci::Position *length);
+	Sci::Position FindAllParallel(Sci::Position minPos, Sci::Position maxPos, const char *search, Scintilla::FindOption flags,
+		Sci::Position length, Sci::Position maxMatches, std::vector<Range> *found);
 
 	std::unique_ptr<RegexSearchBase> regex;
 	std::unique_ptr<LexInterface> pli;
@@ -359,6 +391,7 @@ public:
 	void InsertLine(Sci::Line line) override;
 	void InsertLines(Sci::Line line, Sci::Line lines) override;
 	void RemoveLine(Sci::Line line) override;
+	void RemoveLines(Sci::Line line, Sci::Line lines) override;
 
 	Scintilla::LineEndType LineEndTypesSupported() const;
 	bool SetDBCSCodePage(int dbcsCodePage_);
@@ -535,6 +568,8 @@ public:
 	bool HasCaseFolder() const noexcept;
 	void SetCaseFolder(std::unique_ptr<CaseFolder> pcf_) noexcept;
 	Sci::Position FindText(Sci::Position minPos, Sci::Position maxPos, const char *search, Scintilla::FindOption flags, Sci::Position *length);
+	Sci::Position FindAll(Sci::Position minPos, Sci::Position maxPos, const char *search, Scintilla::FindOption flags,
+		Sci::Position length, Sci::Position maxMatches, std::vector<Range> *found);
 	const char *SubstituteByPosition(const char *text, Sci::Position *length);
 	Scintilla::LineCharacterIndexType LineCharacterIndex() const noexcept;
 	void AllocateLineCharacterIndex(Scintilla::LineCharacterIndexType lineCharacterIndex);
@@ -553,6 +588,10 @@ public:
 	Sci::Position GetEndStyled() const noexcept { return endStyled; }
 	void EnsureStyledTo(Sci::Position pos);
 	void StyleToAdjustingLineDuration(Sci::Position pos);
+	bool StyleInBackground(bool wait);
+	std::unique_ptr<StyleSnapshot> SnapshotForStyling() const;
+	void UpdateSnapshot(StyleSnapshot &snapshot, Sci::Position start) const;
+	void RefreshSnapshot(StyleSnapshot &snapshot, Sci::Position start, Sci::Position end) const;
 	int GetStyleClock() const noexcept { return styleClock; }
 	void IncrementStyleClock() noexcept;
 	void SCI_METHOD DecorationSetCurrentIndicator(int indicator) override;
@@ -14,6 +14,7 @@
 #include <cmath>
 
 #include <stdexcept>
+#include <exception>
 #include <utility>
 #include <string>
 #include <string_view>
@@ -25,11 +26,13 @@
 #include <optional>
 #include <algorithm>
 #include <iterator>
+#include <functional>
 #include <memory>
 #include <chrono>
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
 #include <thread>
-#include <future>
 
 #include "ScintillaTypes.h"
 #include "ScintillaMessages.h"
@@ -67,6 +70,7 @@
 #include "MarginView.h"
 #include "EditView.h"
 #include "ElapsedPeriod.h"
+#include "ThreadPool.h"
 
 using namespace Scintilla;
 using namespace Scintilla::Internal;
@@ -96,6 +100,10 @@ int WidthStyledText(Surface *surface, const ViewStyle &vs, int styleOffset,
 	return width;
 }
 
+constexpr bool InPaintExtent(const std::optional<Interval> &paintExtent, Interval horizontal) noexcept {
+	return !paintExtent || paintExtent->Intersects(horizontal);
+}
+
 }
 
 namespace Scintilla::Internal {
@@ -181,6 +189,76 @@ void DrawStyledText(Surface *surface, const ViewStyle &vs, int styleOffset, PRec
 
 }
 
+void LineBitmapCache::SetSize(size_t size_) {
+	size = size_;
+	if (entries.size() > size) {
+		entries.resize(size);
+	}
+}
+
+size_t LineBitmapCache::GetSize() const noexcept {
+	return size;
+}
+
+void LineBitmapCache::Clear() noexcept {
+	entries.clear();
+}
+
+void LineBitmapCache::Invalidate(Sci::Line lineFirst, Sci::Line lineLast) noexcept {
+	if (lineFirst > lineLast) {
+		std::swap(lineFirst, lineLast);
+	}
+	for (Entry &entry : entries) {
+		if ((entry.lineDoc >= lineFirst) && (entry.lineDoc <= lineLast)) {
+			entry.lineDoc = -1;
+		}
+	}
+}
+
+Surface *LineBitmapCache::Find(Sci::Line lineDoc, int subLine, int xOffset, XYPOSITION &width) noexcept {
+	for (Entry &entry : entries) {
+		if ((entry.lineDoc == lineDoc) && (entry.subLine == subLine) && (entry.xOffset == xOffset)) {
+			entry.lastUsed = ++clock;
+			width = entry.width;
+			return entry.pixmap.get();
+		}
+	}
+	return nullptr;
+}
+
+void LineBitmapCache::Store(Surface &source, int widthPixmap, int heightPixmap,
+	Sci::Line lineDoc, int subLine, int xOffset, XYPOSITION width) {
+	if (size == 0) {
+		return;
+	}
+	// Reuse an invalidated entry, or else the least recently used, if the cache is full.
+	Entry *target = nullptr;
+	if (entries.size() < size) {
+		target = &entries.emplace_back();
+	} else {
+		target = &entries.front();
+		for (Entry &entry : entries) {
+			if (entry.lineDoc < 0) {
+				target = &entry;
+				break;
+			}
+			if (entry.lastUsed < target->lastUsed) {
+				target = &entry;
+			}
+		}
+	}
+	if (!target->pixmap) {
+		target->pixmap = source.AllocatePixMap(widthPixmap, heightPixmap);
+	}
+	target->pixmap->Copy(PRectangle::FromInts(0, 0, widthPixmap, heightPixmap), Point(), source);
+	target->pixmap->FlushDrawing();
+	target->lineDoc = lineDoc;
+	target->subLine = subLine;
+	target->xOffset = xOffset;
+	target->width = width;
+	target->lastUsed = ++clock;
+}
+
 EditView::EditView() {
 	tabWidthMinimumPixels = 2; // needed for calculating tab stops for fractional proportional fonts
 	drawOverstrikeCaret = true;
@@ -193,7 +271,10 @@ EditView::EditView() {
 	llc.SetLevel(LineCache::Caret);
 	posCache = CreatePositionCache();
 	posCache->SetSize(positionCacheDefaultSize);
+	posCacheShared = false;
 	maxLayoutThreads = 1;
+	chunkedLayoutLength = 0;
+	threadPool = std::make_unique<ThreadPool>();
 	tabArrowHeight = 4;
 	customDrawTabArrow = nullptr;
 	customDrawWrapMarker = nullptr;
@@ -221,12 +302,37 @@ bool EditView::LinesOverlap() const noexcept {
 
 void EditView::SetLayoutThreads(unsigned int threads) noexcept {
 	maxLayoutThreads = std::clamp(threads, 1U, std::thread::hardware_concurrency());
+	threadPool->SetThreads(maxLayoutThreads);
 }
 
 unsigned int EditView::GetLayoutThreads() const noexcept {
 	return maxLayoutThreads;
 }
 
+void EditView::SetPositionCacheShared(bool shared) {
+	if (shared != posCacheShared) {
+		if (shared) {
+			posCache = SharedPositionCache();
+		} else {
+			posCache = CreatePositionCache();
+			posCache->SetSize(positionCacheDefaultSize);
+		}
+		posCacheShared = shared;
+	}
+}
+
+bool EditView::GetPositionCacheShared() const noexcept {
+	return posCacheShared;
+}
+
+void EditView::ClearPositionCache() noexcept {
+	// Entries are keyed by the font parameters so the shared cache is not cleared
+	// when one view changes its styles.
+	if (!posCacheShared) {
+		posCache->Clear();
+	}
+}
+
 void EditView::ClearAllTabstops() noexcept {
 	ldTabstops.reset();
 }
@@ -271,6 +377,7 @@ void EditView::LinesAddedOrRemoved(Sci::Line lineOfPos, Sci::Line linesAdded) {
 }
 
 void EditView::DropGraphics() noexcept {
+	lineBitmapCache.Clear();
 	pixmapLine.reset();
 	pixmapIndentGuide.reset();
 	pixmapIndentGuideHighlight.reset();
@@ -336,6 +443,8 @@ void LayoutSegments(IPositionCache *pCache,
 	Surface *surface,
 	const ViewStyle &vstyle,
 	LineLayout *ll,
+	XYPOSITION *positionsRange,
+	int rangeStart,
 	const std::vector<TextSegment> &segments,
 	std::atomic<uint32_t> &nextIndex,
 	const bool textUnicode,
@@ -347,7 +456,7 @@ void LayoutSegments(IPositionCache *pCache,
 		}
 		const TextSegment &ts = segments[i];
 		const unsigned int styleSegment = ll->styles[ts.start];
-		XYPOSITION *positions = &ll->positions[ts.start + 1];
+		XYPOSITION *positions = &positionsRange[ts.start - rangeStart + 1];
 		if (vstyle.styles[styleSegment].visible) {
 			if (ts.representation) {
 				XYPOSITION representationWidth = 0.0;
@@ -390,6 +499,177 @@ void LayoutSegments(IPositionCache *pCache,
 
 }
 
+/**
+* Measure the characters in @a range of a line into @a positionsRange which starts at range.start
+* and must be zero on entry. Positions are relative to @a xOrigin, the x position of range.start,
+* which is needed to find tab stops.
+* Returns whether the last segment is italic.
+*/
+bool EditView::MeasureRange(const EditModel &model, Surface *surface, const ViewStyle &vstyle, LineLayout *ll, Range range,
+	XYPOSITION *positionsRange, XYPOSITION xOrigin, bool callerMultiThreaded) {
+	const Sci::Line line = ll->LineNumber();
+	const Sci::Position posLineStart = model.pdoc->LineStart(line);
+
+	std::vector<TextSegment> segments;
+	BreakFinder bfLayout(ll, nullptr, range, posLineStart, 0, BreakFinder::BreakFor::Text, model.pdoc, model.reprs.get(), nullptr);
+	while (bfLayout.More()) {
+		segments.push_back(bfLayout.Next());
+	}
+
+	if (!segments.empty()) {
+
+		const size_t threadsForLength = std::max<Sci::Position>(1, range.Length() / bytesPerLayoutThread);
+		size_t threads = std::min<size_t>({ segments.size(), threadsForLength, maxLayoutThreads });
+		if (!surface->SupportsFeature(Supports::ThreadSafeMeasureWidths) || callerMultiThreaded) {
+			threads = 1;
+		}
+
+		std::atomic<uint32_t> nextIndex = 0;
+
+		const bool textUnicode = CpUtf8 == model.pdoc->dbcsCodePage;
+		const bool multiThreaded = threads > 1;
+		const bool multiThreadedContext = multiThreaded || callerMultiThreaded;
+		IPositionCache *pCache = posCache.get();
+
+		// If only 1 thread needed then use the main thread, else share with the pool's workers
+		// Find relative positions of everything except for tabs
+		const int rangeStart = static_cast<int>(range.start);
+		threadPool->Run(threads,
+			[pCache, surface, &vstyle, &ll, positionsRange, rangeStart, &segments, &nextIndex, textUnicode, multiThreadedContext](size_t) {
+			LayoutSegments(pCache, surface, vstyle, ll, positionsRange, rangeStart, segments, nextIndex, textUnicode, multiThreadedContext);
+		});
+	}
+
+	// Accumulate positions from relative positions within segments and expand tabs
+	XYPOSITION xPosition = positionsRange[0];
+	size_t iByte = 1;
+	for (const TextSegment &ts : segments) {
+		if (vstyle.styles[ll->styles[ts.start]].visible &&
+			ts.representation &&
+			ll->chars[ts.start] == '\t' && vstyle.tabDrawMode != TabDrawMode::ControlChar) {
+			// Simple visible tab, go to next tab stop
+			const XYPOSITION startTab = positionsRange[ts.start - range.start];
+			const XYPOSITION nextTab = NextTabstopPos(line, xOrigin + startTab, vstyle.tabWidth) - xOrigin;
+			xPosition += nextTab - startTab;
+		}
+		const XYPOSITION xBeginSegment = xPosition;
+		for (int i = 0; i < ts.length; i++) {
+			xPosition = positionsRange[iByte] + xBeginSegment;
+			positionsRange[iByte++] = xPosition;
+		}
+	}
+
+	if (!segments.empty()) {
+		// Not quite the same as before which would effectively ignore trailing invisible segments
+		const TextSegment &ts = segments.back();
+		return (!ts.representation) && ((ll->chars[ts.end() - 1] != ' ') && vstyle.styles[ll->styles[ts.start]].italic);
+	}
+	return false;
+}
+
+/**
+* Divide a very long line into chunks, aligned to character boundaries, that are measured
+* by LayoutChunks. Chunk bases are estimated from average character widths.
+*/
+void EditView::EstimatePositions(const EditModel &model, const ViewStyle &vstyle, LineLayout *ll, int numCharsInLine) {
+	const Sci::Line line = ll->LineNumber();
+	const Sci::Position posLineStart = model.pdoc->LineStart(line);
+	ll->ClearChunks();
+	ll->chunkStarts.push_back(0);
+	for (int start = bytesPerLayoutChunk; start < numCharsInLine; start += bytesPerLayoutChunk) {
+		const int chunkStart = static_cast<int>(
+			model.pdoc->MovePositionOutsideChar(posLineStart + start, 1, false) - posLineStart);
+		if ((chunkStart > ll->chunkStarts.back()) && (chunkStart < numCharsInLine)) {
+			ll->chunkStarts.push_back(chunkStart);
+		}
+	}
+	ll->chunkStarts.push_back(numCharsInLine);
+
+	const bool utf8 = CpUtf8 == model.pdoc->dbcsCodePage;
+	ll->chunkBases.reserve(ll->chunkStarts.size());
+	XYPOSITION xPosition = 0.0;
+	size_t chunk = 0;
+	for (int i = 0; i < numCharsInLine; i++) {
+		if (i == ll->chunkStarts[chunk]) {
+			ll->chunkBases.push_back(xPosition);
+			chunk++;
+		}
+		const unsigned char ch = ll->chars[i];
+		const Style &style = vstyle.styles[ll->styles[i]];
+		if (style.visible) {
+			if (ch == '\t' && vstyle.tabDrawMode != TabDrawMode::ControlChar) {
+				xPosition = NextTabstopPos(line, xPosition, vstyle.tabWidth);
+			} else if (!(utf8 && UTF8IsTrailByte(ch))) {
+				xPosition += style.aveCharWidth;
+			}
+		}
+	}
+	ll->chunkBases.push_back(xPosition);
+	ll->chunkPositions.resize(ll->chunkStarts.size() - 1);
+}
+
+/**
+* Measure a chunk of a long line then move the chunks after it by any change in the chunk's width.
+* Chunks after it that contain tabs have to be measured again as their tab stops may differ.
+*/
+void EditView::MeasureChunk(const EditModel &model, Surface *surface, const ViewStyle &vstyle, LineLayout *ll, size_t chunk) {
+	const int start = ll->chunkStarts[chunk];
+	const int end = ll->chunkStarts[chunk + 1];
+	const XYPOSITION base = ll->chunkBases[chunk];
+	// Extra position allocated as sometimes the Windows
+	// GetTextExtentExPoint API writes an extra element.
+	ll->chunkPositions[chunk] = std::make_unique<XYPOSITION[]>(end - start + 2);
+	MeasureRange(model, surface, vstyle, ll, Range(start, end), ll->chunkPositions[chunk].get(), base, false);
+	const XYPOSITION delta = ll->chunkPositions[chunk][end - start] - (ll->chunkBases[chunk + 1] - base);
+	if (delta != 0.0) {
+		for (size_t chunkAfter = chunk + 1; chunkAfter < ll->chunkBases.size(); chunkAfter++) {
+			ll->chunkBases[chunkAfter] += delta;
+			if ((chunkAfter < ll->chunkPositions.size()) && ll->chunkPositions[chunkAfter]) {
+				const int startAfter = ll->chunkStarts[chunkAfter];
+				const int lengthAfter = ll->chunkStarts[chunkAfter + 1] - startAfter;
+				if (std::memchr(&ll->chars[startAfter], '\t', lengthAfter)) {
+					ll->chunkPositions[chunkAfter].reset();
+				}
+			}
+		}
+	}
+}
+
+/**
+* Measure the chunks of a line laid out by EstimatePositions that overlap the @a horizontal range
+* and free the positions of chunks far from it. The widths of chunks that were measured are kept.
+* Measuring a chunk moves the chunks after it so the range is found again after each chunk.
+*/
+void EditView::LayoutChunks(const EditModel &model, Surface *surface, const ViewStyle &vstyle, LineLayout *ll, Interval horizontal) {
+	if (!ll || !ll->Chunked() || (ll->validity < LineLayout::ValidLevel::positions)) {
+		return;
+	}
+	auto ChunkFromX = [ll](XYPOSITION x) noexcept -> size_t {
+		const auto it = std::upper_bound(ll->chunkBases.begin(), ll->chunkBases.end() - 1, x);
+		return std::clamp<ptrdiff_t>(it - ll->chunkBases.begin() - 1, 0, static_cast<ptrdiff_t>(ll->chunkPositions.size()) - 1);
+	};
+	bool measured = true;
+	while (measured) {
+		measured = false;
+		const size_t last = ChunkFromX(horizontal.right);
+		for (size_t chunk = ChunkFromX(horizontal.left); chunk <= last; chunk++) {
+			if (!ll->chunkPositions[chunk]) {
+				MeasureChunk(model, surface, vstyle, ll, chunk);
+				measured = true;
+				break;
+			}
+		}
+	}
+	constexpr size_t chunksRetained = 4;
+	const size_t first = ChunkFromX(horizontal.left);
+	const size_t last = ChunkFromX(horizontal.right);
+	for (size_t chunk = 0; chunk < ll->chunkPositions.size(); chunk++) {
+		if ((chunk + chunksRetained < first) || (chunk > last + chunksRetained)) {
+			ll->chunkPositions[chunk].reset();
+		}
+	}
+}
+
 /**
 * Fill in the LineLayout data for the given line.
 * Copy the given @a line and its styles from the document into local arrays.
@@ -407,6 +687,11 @@ void EditView::LayoutLine(const EditModel &model, Surface *surface, const ViewSt
 	constexpr int minimumWidth = 20;
 	width = std::max(width, minimumWidth);
 
+	if (ll->Chunked() && ((width != LineLayout::wrapWidthInfinite) || model.BidirectionalEnabled())) {
+		// Estimated positions are not good enough for wrapping or bidirectional text
+		ll->Invalidate(LineLayout::ValidLevel::invalid);
+	}
+
 	if (ll->validity == LineLayout::ValidLevel::checkTextAndStyle) {
 		Sci::Position lineLength = posLineEnd - posLineStart;
 		if (!vstyle.viewEOL) {
@@ -473,73 +758,14 @@ void EditView::LayoutLine(const EditModel &model, Surface *surface, const ViewSt
 
 		// Layout the line, determining the position of each character,
 		// with an extra element at the end for the end of the line.
-		ll->positions[0] = 0;
 		bool lastSegItalics = false;
-
-		std::vector<TextSegment> segments;
-		BreakFinder bfLayout(ll, nullptr, Range(0, numCharsInLine), posLineStart, 0, BreakFinder::BreakFor::Text, model.pdoc, model.reprs.get(), nullptr);
-		while (bfLayout.More()) {
-			segments.push_back(bfLayout.Next());
-		}
-
-		ll->ClearPositions();
-
-		if (!segments.empty()) {
-
-			const size_t threadsForLength = std::max(1, numCharsInLine / bytesPerLayoutThread);
-			size_t threads = std::min<size_t>({ segments.size(), threadsForLength, maxLayoutThreads });
-			if (!surface->SupportsFeature(Supports::ThreadSafeMeasureWidths) || callerMultiThreaded) {
-				threads = 1;
-			}
-
-			std::atomic<uint32_t> nextIndex = 0;
-
-			const bool textUnicode = CpUtf8 == model.pdoc->dbcsCodePage;
-			const bool multiThreaded = threads > 1;
-			const bool multiThreadedContext = multiThreaded || callerMultiThreaded;
-			IPositionCache *pCache = posCache.get();
-
-			// If only 1 thread needed then use the main thread, else spin up multiple
-			const std::launch policy = (multiThreaded) ? std::launch::async : std::launch::deferred;
-
-			std::vector<std::future<void>> futures;
-			for (size_t th = 0; th < threads; th++) {
-				// Find relative positions of everything except for tabs
-				std::future<void> fut = std::async(policy,
-					[pCache, surface, &vstyle, &ll, &segments, &nextIndex, textUnicode, multiThreadedContext]() {
-					LayoutSegments(pCache, surface, vstyle, ll, segments, nextIndex, textUnicode, multiThreadedContext);
-				});
-				futures.push_back(std::move(fut));
-			}
-			for (const std::future<void> &f : futures) {
-				f.wait();
-			}
-		}
-
-		// Accumulate absolute positions from relative positions within segments and expand tabs
-		XYPOSITION xPosition = 0.0;
-		size_t iByte = 0;
-		ll->positions[iByte++] = xPosition;
-		for (const TextSegment &ts : segments) {
-			if (vstyle.styles[ll->styles[ts.start]].visible &&
-				ts.representation &&
-				ll->chars[ts.start] == '\t' && vstyle.tabDrawMode != TabDrawMode::ControlChar) {
-				// Simple visible tab, go to next tab stop
-				const XYPOSITION startTab = ll->positions[ts.start];
-				const XYPOSITION nextTab = NextTabstopPos(line, startTab, vstyle.tabWidth);
-				xPosition += nextTab - startTab;
-			}
-			const XYPOSITION xBeginSegment = xPosition;
-			for (int i = 0; i < ts.length; i++) {
-				xPosition = ll->positions[iByte] + xBeginSegment;
-				ll->positions[iByte++] = xPosition;
-			}
-		}
-
-		if (!segments.empty()) {
-			// Not quite the same as before which would effectively ignore trailing invisible segments
-			const TextSegment &ts = segments.back();
-			lastSegItalics = (!ts.representation) && ((ll->chars[ts.end() - 1] != ' ') && vstyle.styles[ll->styles[ts.start]].italic);
+		if ((chunkedLayoutLength > 0) && (numCharsInLine >= chunkedLayoutLength) &&
+			(width == LineLayout::wrapWidthInfinite) && !model.BidirectionalEnabled()) {
+			// Very long line: estimate positions now and measure chunks as they become visible
+			EstimatePositions(model, vstyle, ll, numCharsInLine);
+		} else {
+			ll->ClearPositions();
+			lastSegItalics = MeasureRange(model, surface, vstyle, ll, Range(0, numCharsInLine), ll->positions.get(), 0.0, callerMultiThreaded);
 		}
 
 		// Small hack to make lines that end with italics not cut off the edge of the last character
@@ -644,6 +870,11 @@ Point EditView::LocationFromPosition(Surface *surface, const EditModel &model, S
 	if (surface && ll) {
 		LayoutLine(model, surface, vs, ll.get(), model.wrapWidth);
 		const int posInLine = static_cast<int>(pos.Position() - posLineStart);
+		if (ll->Chunked() && (posInLine <= ll->numCharsInLine)) {
+			// Measure around the position so the caret is not placed at an estimate
+			const XYPOSITION xEstimated = ll->XPosition(posInLine);
+			LayoutChunks(model, surface, vs, ll.get(), Interval{ xEstimated, xEstimated });
+		}
 		pt = ll->PointFromPosition(posInLine, vs.lineHeight, pe);
 		pt.x += vs.textStart - model.xOffset;
 
@@ -718,7 +949,7 @@ SelectionPosition EditView::SPositionFromLocation(Surface *surface, const EditMo
 		const int subLine = static_cast<int>(visibleLine - lineStartSet);
 		if (subLine < ll->lines) {
 			const Range rangeSubLine = ll->SubLineRange(subLine, LineLayout::Scope::visibleOnly);
-			const XYPOSITION subLineStart = ll->positions[rangeSubLine.start];
+			const XYPOSITION subLineStart = ll->XPosition(rangeSubLine.start);
 			if (subLine > 0)	// Wrapped
 				pt.x -= ll->wrapIndent;
 			Sci::Position positionInLine = 0;
@@ -740,11 +971,11 @@ SelectionPosition EditView::SPositionFromLocation(Surface *surface, const EditMo
 			if (virtualSpace) {
 				const XYPOSITION spaceWidth = vs.styles[ll->EndLineStyle()].spaceWidth;
 				const int spaceOffset = static_cast<int>(
-					(pt.x + subLineStart - ll->positions[rangeSubLine.end] + spaceWidth / 2) / spaceWidth);
+					(pt.x + subLineStart - ll->XPosition(rangeSubLine.end) + spaceWidth / 2) / spaceWidth);
 				return SelectionPosition(rangeSubLine.end + posLineStart, spaceOffset);
 			}
 			if (canReturnInvalid) {
-				if (pt.x < (ll->positions[rangeSubLine.end] - subLineStart)) {
+				if (pt.x < (ll->XPosition(rangeSubLine.end) - subLineStart)) {
 					return SelectionPosition(model.pdoc->MovePositionOutsideChar(rangeSubLine.end + posLineStart, 1));
 				}
 			} else {
@@ -768,14 +999,14 @@ SelectionPosition EditView::SPositionFromLineX(Surface *surface, const EditModel
 		const Sci::Position posLineStart = model.pdoc->LineStart(lineDoc);
 		LayoutLine(model, surface, vs, ll.get(), model.wrapWidth);
 		const Range rangeSubLine = ll->SubLineRange(0, LineLayout::Scope::visibleOnly);
-		const XYPOSITION subLineStart = ll->positions[rangeSubLine.start];
+		const XYPOSITION subLineStart = ll->XPosition(rangeSubLine.start);
 		const Sci::Position positionInLine = ll->FindPositionFromX(x + subLineStart, rangeSubLine, false);
 		if (positionInLine < rangeSubLine.end) {
 			return SelectionPosition(model.pdoc->MovePositionOutsideChar(positionInLine + posLineStart, 1));
 		}
 		const XYPOSITION spaceWidth = vs.styles[ll->EndLineStyle()].spaceWidth;
 		const int spaceOffset = static_cast<int>(
-			(x + subLineStart - ll->positions[rangeSubLine.end] + spaceWidth / 2) / spaceWidth);
+			(x + subLineStart - ll->XPosition(rangeSubLine.end) + spaceWidth / 2) / spaceWidth);
 		return SelectionPosition(rangeSubLine.end + posLineStart, spaceOffset);
 	}
 	return SelectionPosition(0);
@@ -1009,7 +1240,7 @@ void EditView::DrawEOL(Surface *surface, const EditModel &model, const ViewStyle
 	const Sci::Position virtualSpaces = lastSubLine ? model.VirtualSpaceForLine(line) : 0;
 	const XYPOSITION spaceWidth = lastSubLine ? vsDraw.styles[ll->EndLineStyle()].spaceWidth : 0;
 	const XYPOSITION virtualSpace = static_cast<XYPOSITION>(virtualSpaces) * spaceWidth;
-	const XYPOSITION xEol = ll->positions[lineEnd] - subLineStart;
+	const XYPOSITION xEol = ll->XPosition(lineEnd) - subLineStart;
 
 	// Fill the virtual space and show selections within it
 	if (virtualSpace > 0.0f) {
@@ -1023,9 +1254,9 @@ void EditView::DrawEOL(Surface *surface, const EditModel &model, const ViewStyle
 			for (size_t r = 0; r<model.sel.Count(); r++) {
 				const SelectionSegment portion = model.sel.Range(r).Intersect(virtualSpaceRange);
 				if (!portion.Empty()) {
-					rcSegment.left = xStart + ll->positions[portion.start.Position() - posLineStart] -
+					rcSegment.left = xStart + ll->XPosition(portion.start.Position() - posLineStart) -
 						subLineStart + portion.start.VirtualSpaceWidth(spaceWidth);
-					rcSegment.right = xStart + ll->positions[portion.end.Position() - posLineStart] -
+					rcSegment.right = xStart + ll->XPosition(portion.end.Position() - posLineStart) -
 						subLineStart + portion.end.VirtualSpaceWidth(spaceWidth);
 					rcSegment.left = (rcSegment.left > rcLine.left) ? rcSegment.left : rcLine.left;
 					rcSegment.right = (rcSegment.right < rcLine.right) ? rcSegment.right : rcLine.right;
@@ -1181,7 +1412,7 @@ void EditView::DrawFoldDisplayText(Surface *surface, const EditModel &model, con
 
 	const XYPOSITION spaceWidth = vsDraw.styles[ll->EndLineStyle()].spaceWidth;
 	const XYPOSITION virtualSpace = static_cast<XYPOSITION>(model.VirtualSpaceForLine(line)) * spaceWidth;
-	rcSegment.left = xStart + ll->positions[ll->numCharsInLine] - subLineStart + virtualSpace + vsDraw.aveCharWidth;
+	rcSegment.left = xStart + ll->XPosition(ll->numCharsInLine) - subLineStart + virtualSpace + vsDraw.aveCharWidth;
 	rcSegment.right = rcSegment.left + static_cast<XYPOSITION>(widthFoldDisplayText);
 
 	const ColourOptional background = vsDraw.Background(model.GetMark(line), model.caret.active, ll->containsCaret);
@@ -1260,7 +1491,7 @@ void EditView::DrawEOLAnnotationText(Surface *surface, const EditModel &model, c
 	const XYPOSITION spaceWidth = vsDraw.styles[ll->EndLineStyle()].spaceWidth;
 	const XYPOSITION virtualSpace = static_cast<XYPOSITION>(model.VirtualSpaceForLine(line)) * spaceWidth;
 	rcSegment.left = xStart +
-		ll->positions[ll->numCharsInLine] - subLineStart
+		ll->XPosition(ll->numCharsInLine) - subLineStart
 		+ virtualSpace + vsDraw.aveCharWidth;
 
 	const char *textFoldDisplay = model.GetFoldDisplayText(line);
@@ -1427,7 +1658,7 @@ void DrawBlockCaret(Surface *surface, const EditModel &model, const ViewStyle &v
 	Sci::Position offsetFirstChar = offset;
 	Sci::Position offsetLastChar = offset + (posAfter - posCaret);
 	while ((posBefore > 0) && ((offsetLastChar - numCharsToDraw) >= lineStart)) {
-		if ((ll->positions[offsetLastChar] - ll->positions[offsetLastChar - numCharsToDraw]) > 0) {
+		if ((ll->XPosition(offsetLastChar) - ll->XPosition(offsetLastChar - numCharsToDraw)) > 0) {
 			// The char does not share horizontal space
 			break;
 		}
@@ -1449,7 +1680,7 @@ void DrawBlockCaret(Surface *surface, const EditModel &model, const ViewStyle &v
 		posBefore = posAfter;
 		posAfter = model.pdoc->MovePositionOutsideChar(posAfter + 1, 1);
 		offsetLastChar = offset + (posAfter - posCaret);
-		if ((ll->positions[offsetLastChar] - ll->positions[offsetLastChar - (posAfter - posBefore)]) > 0) {
+		if ((ll->XPosition(offsetLastChar) - ll->XPosition(offsetLastChar - (posAfter - posBefore))) > 0) {
 			// The char does not share horizontal space
 			break;
 		}
@@ -1458,8 +1689,8 @@ void DrawBlockCaret(Surface *surface, const EditModel &model, const ViewStyle &v
 	}
 
 	// We now know what to draw, update the caret drawing rectangle
-	rcCaret.left = ll->positions[offsetFirstChar] - ll->positions[lineStart] + xOrigin;
-	rcCaret.right = ll->positions[offsetFirstChar + numCharsToDraw] - ll->positions[lineStart] + xOrigin;
+	rcCaret.left = ll->XPosition(offsetFirstChar) - ll->XPosition(lineStart) + xOrigin;
+	rcCaret.right = ll->XPosition(offsetFirstChar + numCharsToDraw) - ll->XPosition(lineStart) + xOrigin;
 
 	// Adjust caret position to take into account any word wrapping symbols.
 	if ((ll->wrapIndent != 0) && (lineStart != 0)) {
@@ -1503,7 +1734,7 @@ void EditView::DrawCarets(Surface *surface, const EditModel &model, const ViewSt
 		const XYPOSITION spaceWidth = vsDraw.styles[ll->EndLineStyle()].spaceWidth;
 		const XYPOSITION virtualOffset = posCaret.VirtualSpaceWidth(spaceWidth);
 		if (ll->InLine(offset, subLine) && offset <= ll->numCharsBeforeEOL) {
-			XYPOSITION xposCaret = ll->positions[offset] + virtualOffset - ll->positions[ll->LineStart(subLine)];
+			XYPOSITION xposCaret = ll->XPosition(offset) + virtualOffset - ll->XPosition(ll->LineStart(subLine));
 			if (model.BidirectionalEnabled() && (posCaret.VirtualSpace() == 0)) {
 				// Get caret point
 				const ScreenLine screenLine(ll, subLine, vsDraw, rcLine.right, tabWidthMinimumPixels);
@@ -1538,7 +1769,7 @@ void EditView::DrawCarets(Surface *surface, const EditModel &model, const ViewSt
 					widthOverstrikeCaret = vsDraw.aveCharWidth;
 				} else {
 					const int widthChar = model.pdoc->LenChar(posCaret.Position());
-					widthOverstrikeCaret = ll->positions[offset + widthChar] - ll->positions[offset];
+					widthOverstrikeCaret = ll->XPosition(offset + widthChar) - ll->XPosition(offset);
 				}
 				// Make sure block caret visible
 				constexpr XYPOSITION minimumBlockCaretWidth = 3.0f;
@@ -1641,11 +1872,11 @@ InSelection CharacterInCursesSelection(Sci::Position iDoc, const EditModel &mode
 
 void DrawBackground(Surface *surface, const EditModel &model, const ViewStyle &vsDraw, const LineLayout *ll,
 	int xStart, PRectangle rcLine, int subLine, Range lineRange, Sci::Position posLineStart,
-	ColourOptional background) {
+	ColourOptional background, const std::optional<Interval> &paintExtent) {
 
 	const bool selBackDrawn = vsDraw.SelectionBackgroundDrawn();
 	bool inIndentation = subLine == 0;	// Do not handle indentation except on first subline.
-	const XYPOSITION subLineStart = ll->positions[lineRange.start];
+	const XYPOSITION subLineStart = ll->XPosition(lineRange.start);
 	const XYPOSITION horizontalOffset = xStart - subLineStart;
 	// Does not take margin into account but not significant
 	const XYPOSITION xStartVisible = subLineStart - xStart;
@@ -1663,9 +1894,13 @@ void DrawBackground(Surface *surface, const EditModel &model, const ViewStyle &v
 		const Sci::Position iDoc = i + posLineStart;
 
 		const Interval horizontal = ll->Span(ts.start, ts.end()).Offset(horizontalOffset);
+		if (!model.BidirectionalEnabled() && (horizontal.left > rcLine.right)) {
+			// Segments are in order so the rest of a long line can not be visible either
+			break;
+		}
 		// Only try to draw if really visible - enhances performance by not calling environment to
 		// draw strings that are completely past the right side of the window.
-		if (!horizontal.Empty() && rcLine.Intersects(horizontal)) {
+		if (!horizontal.Empty() && rcLine.Intersects(horizontal) && InPaintExtent(paintExtent, horizontal)) {
 			const PRectangle rcSegment = Intersection(rcLine, horizontal);
 
 			InSelection inSelection = vsDraw.selection.visible ? model.sel.CharacterInSelection(iDoc) : InSelection::inNone;
@@ -1759,7 +1994,7 @@ void DrawTranslucentSelection(Surface *surface, const EditModel &model, const Vi
 	Sci::Line line, int xStart, PRectangle rcLine, int subLine, Range lineRange, int tabWidthMinimumPixels, Layer layer) {
 	if (vsDraw.selection.layer == layer) {
 		const Sci::Position posLineStart = model.pdoc->LineStart(line);
-		const XYPOSITION subLineStart = ll->positions[lineRange.start];
+		const XYPOSITION subLineStart = ll->XPosition(lineRange.start);
 		const XYPOSITION horizontalOffset = xStart - subLineStart;
 		// For each selection draw
 		const Sci::Position virtualSpaces = (subLine == (ll->lines - 1)) ?
@@ -1793,7 +2028,7 @@ void DrawTranslucentSelection(Surface *surface, const EditModel &model, const Vi
 					}
 
 					if (portion.end.VirtualSpace()) {
-						const XYPOSITION xStartVirtual = ll->positions[lineRange.end] + horizontalOffset;
+						const XYPOSITION xStartVirtual = ll->XPosition(lineRange.end) + horizontalOffset;
 						const PRectangle rcSegment = rcLine.WithHorizontalBounds(intervalVirtual.Offset(xStartVirtual));
 						surface->FillRectangleAligned(rcSegment, selectionBack);
 					}
@@ -1920,7 +2155,7 @@ void DrawIndicator(int indicNum, Sci::Position startPos, Sci::Position endPos, S
 	const LineLayout *ll, int xStart, PRectangle rcLine, Sci::Position secondCharacter, int subLine, Indicator::State state,
 	int value, bool bidiEnabled, int tabWidthMinimumPixels) {
 
-	const XYPOSITION subLineStart = ll->positions[ll->LineStart(subLine)];
+	const XYPOSITION subLineStart = ll->XPosition(ll->LineStart(subLine));
 	const XYPOSITION horizontalOffset = xStart - subLineStart;
 
 	std::vector<PRectangle> rectangles;
@@ -2112,7 +2347,7 @@ void EditView::DrawForeground(Surface *surface, const EditModel &model, const Vi
 	const bool drawWhitespaceBackground = vsDraw.WhitespaceBackgroundDrawn() && !background;
 	bool inIndentation = subLine == 0;	// Do not handle indentation except on first subline.
 
-	const XYPOSITION subLineStart = ll->positions[lineRange.start];
+	const XYPOSITION subLineStart = ll->XPosition(lineRange.start);
 	const XYPOSITION horizontalOffset = xStart - subLineStart;
 	const XYPOSITION indentWidth = model.pdoc->IndentSize() * vsDraw.spaceWidth;
 
@@ -2137,9 +2372,13 @@ void EditView::DrawForeground(Surface *surface, const EditModel &model, const Vi
 		const Sci::Position iDoc = i + posLineStart;
 
 		const Interval horizontal = ll->Span(ts.start, ts.end()).Offset(horizontalOffset);
+		if (!model.BidirectionalEnabled() && (horizontal.left > rcLine.right)) {
+			// Segments are in order so the rest of a long line can not be visible either
+			break;
+		}
 		// Only try to draw if really visible - enhances performance by not calling environment to
 		// draw strings that are completely past the right side of the window.
-		if (rcLine.Intersects(horizontal)) {
+		if (rcLine.Intersects(horizontal) && InPaintExtent(paintExtent, horizontal)) {
 			const PRectangle rcSegment = rcLine.WithHorizontalBounds(horizontal);
 			const int styleMain = ll->styles[i];
 			ColourRGBA textFore = vsDraw.styles[styleMain].fore;
@@ -2322,7 +2561,7 @@ void EditView::DrawIndentGuidesOverEmpty(Surface *surface, const EditModel &mode
 		&& (subLine == 0)) {
 		const Sci::Position posLineStart = model.pdoc->LineStart(line);
 		int indentSpace = model.pdoc->GetLineIndentation(line);
-		int xStartText = static_cast<int>(ll->positions[model.pdoc->GetLineIndentPosition(line) - posLineStart]);
+		int xStartText = static_cast<int>(ll->XPosition(model.pdoc->GetLineIndentPosition(line) - posLineStart));
 
 		// Find the most recent line with some text
 
@@ -2394,7 +2633,7 @@ void EditView::DrawLine(Surface *surface, const EditModel &model, const ViewStyl
 
 	const Range lineRange = ll->SubLineRange(subLine, LineLayout::Scope::visibleOnly);
 	const Range lineRangeIncludingEnd = ll->SubLineRange(subLine, LineLayout::Scope::includeEnd);
-	const XYPOSITION subLineStart = ll->positions[lineRange.start];
+	const XYPOSITION subLineStart = ll->XPosition(lineRange.start);
 
 	if ((ll->wrapIndent != 0) && (subLine > 0)) {
 		if (FlagSet(phase, DrawPhase::back)) {
@@ -2407,7 +2646,7 @@ void EditView::DrawLine(Surface *surface, const EditModel &model, const ViewStyl
 		if (FlagSet(phase, DrawPhase::back)) {
 			DrawBackground(surface, model, vsDraw, ll,
 				xStart, rcLine, subLine, lineRange, posLineStart,
-				background);
+				background, paintExtent);
 			DrawFoldDisplayText(surface, model, vsDraw, ll, line, xStart, rcLine, subLine, subLineStart, DrawPhase::back);
 			DrawEOLAnnotationText(surface, model, vsDraw, ll, line, xStart, rcLine, subLine, subLineStart, DrawPhase::back);
 			// Remove drawBack to not draw again in DrawFoldDisplayText
@@ -2508,6 +2747,21 @@ void EditView::PaintText(Surface *surfaceWindow, const EditModel &model, const V
 		// Remove selection margin from drawing area so text will not be drawn
 		// on it in unbuffered mode.
 		const bool clipping = !bufferedDraw && vsDraw.marginInside;
+
+		// When only part of the width is invalid, such as for a blinking caret or a changed
+		// indicator, skip text runs outside that part. Glyphs may overhang their run so
+		// allow a line height of slack on each side.
+		const XYPOSITION slack = static_cast<XYPOSITION>(vsDraw.lineHeight);
+		paintExtent = Interval{ rcArea.left - slack, rcArea.right + slack };
+		const int copyLeft = std::max(vsDraw.textStart - leftTextOverlap, static_cast<int>(std::floor(rcArea.left)));
+		const int copyRight = std::min(static_cast<int>(rcClient.right - vsDraw.rightMarginWidth),
+			static_cast<int>(std::ceil(rcArea.right)));
+
+		// Retained line images can be reused whenever buffered but can only be stored
+		// when the whole width of the line is drawn.
+		const bool retainLines = bufferedDraw && (lineBitmapCache.GetSize() > 0);
+		const bool storeLines = retainLines && (copyLeft == vsDraw.textStart - leftTextOverlap) &&
+			(copyRight == static_cast<int>(rcClient.right - vsDraw.rightMarginWidth));
 		if (clipping) {
 			PRectangle rcClipText = rcTextArea;
 			rcClipText.left -= leftTextOverlap;
@@ -2547,9 +2801,23 @@ void EditView::PaintText(Surface *surfaceWindow, const EditModel &model, const V
 #if defined(TIME_PAINTING)
 				ElapsedPeriod ep;
 #endif
-				if (lineDoc != lineDocPrevious) {
+				XYPOSITION widthRetained = 0;
+				Surface *pixmapRetained = retainLines ?
+					lineBitmapCache.Find(lineDoc, subLine, model.xOffset, widthRetained) : nullptr;
+				if (pixmapRetained) {
+					const Point from = Point::FromInts(copyLeft, 0);
+					const PRectangle rcCopyArea = PRectangle::FromInts(copyLeft, yposScreen,
+						copyRight, yposScreen + vsDraw.lineHeight);
+					if (!rcCopyArea.Empty()) {
+						surfaceWindow->Copy(rcCopyArea, from, *pixmapRetained);
+					}
+					UpdateMaxWidth(widthRetained);
+				} else if (lineDoc != lineDocPrevious) {
 					ll = RetrieveLineLayout(lineDoc, model);
 					LayoutLine(model, surface, vsDraw, ll.get(), model.wrapWidth);
+					// Long lines are only measured where they are visible
+					LayoutChunks(model, surface, vsDraw, ll.get(),
+						Interval{ static_cast<XYPOSITION>(model.xOffset), static_cast<XYPOSITION>(model.xOffset) + rcClient.Width() });
 					lineDocPrevious = lineDoc;
 					if (ll && model.BidirectionalEnabled()) {
 						// Fill the line bidi data
@@ -2559,7 +2827,7 @@ void EditView::PaintText(Surface *surfaceWindow, const EditModel &model, const V
 #if defined(TIME_PAINTING)
 				durLayout += ep.Duration(true);
 #endif
-				if (ll) {
+				if (ll && !pixmapRetained) {
 					ll->containsCaret = vsDraw.selection.visible && (lineDoc == lineCaret)
 						&& (ll->lines == 1 || !vsDraw.caretLine.subLine || ll->InLine(caretOffset, subLine));
 
@@ -2598,15 +2866,21 @@ void EditView::PaintText(Surface *surfaceWindow, const EditModel &model, const V
 					}
 
 					if (bufferedDraw) {
-						const Point from = Point::FromInts(vsDraw.textStart - leftTextOverlap, 0);
-						const PRectangle rcCopyArea = PRectangle::FromInts(vsDraw.textStart - leftTextOverlap, yposScreen,
-							static_cast<int>(rcClient.right - vsDraw.rightMarginWidth),
-							yposScreen + vsDraw.lineHeight);
+						// Only copy the invalid part of the line as the rest of the pixmap may be stale.
+						const Point from = Point::FromInts(copyLeft, 0);
+						const PRectangle rcCopyArea = PRectangle::FromInts(copyLeft, yposScreen,
+							copyRight, yposScreen + vsDraw.lineHeight);
 						pixmapLine->FlushDrawing();
-						surfaceWindow->Copy(rcCopyArea, from, *pixmapLine);
+						if (!rcCopyArea.Empty()) {
+							surfaceWindow->Copy(rcCopyArea, from, *pixmapLine);
+						}
+						if (storeLines) {
+							lineBitmapCache.Store(*pixmapLine, static_cast<int>(rcClient.Width()), vsDraw.lineHeight,
+								lineDoc, subLine, model.xOffset, ll->XPosition(ll->numCharsInLine));
+						}
 					}
 
-					UpdateMaxWidth(ll->positions[ll->numCharsInLine]);
+					UpdateMaxWidth(ll->XPosition(ll->numCharsInLine));
 #if defined(TIME_PAINTING)
 					durCopy += ep.Duration(true);
 #endif
@@ -2626,6 +2900,7 @@ void EditView::PaintText(Surface *surfaceWindow, const EditModel &model, const V
 			phase = static_cast<DrawPhase>(static_cast<int>(phase) * 2);
 		}
 		ll.reset();
+		paintExtent.reset();
 #if defined(TIME_PAINTING)
 		if (durPaint < 0.00000001)
 			durPaint = 0.00000001;
@@ -2671,8 +2946,10 @@ void EditView::PaintText(Surface *surfaceWindow, const EditModel &model, const V
 
 Sci::Position EditView::FormatRange(bool draw, CharacterRangeFull chrg, Rectangle rc, Surface *surface, Surface *surfaceMeasure,
 	const EditModel &model, const ViewStyle &vs) {
-	// Can't use measurements cached for screen
-	posCache->Clear();
+	// Can't use measurements cached for screen so measure with a separate cache
+	std::shared_ptr<IPositionCache> posCacheScreen = std::move(posCache);
+	posCache = CreatePositionCache();
+	posCache->SetSize(positionCacheDefaultSize);
 
 	ViewStyle vsPrint(vs);
 	vsPrint.technology = Technology::Default;
@@ -2781,6 +3058,7 @@ Sci::Position EditView::FormatRange(bool draw, CharacterRangeFull chrg, Rectangl
 		// and determine the x position at which each character starts.
 		LineLayout ll(lineDoc, static_cast<int>(model.pdoc->LineStart(lineDoc + 1) - model.pdoc->LineStart(lineDoc) + 1));
 		LayoutLine(model, surfaceMeasure, vsPrint, &ll, widthPrint);
+		LayoutChunks(model, surfaceMeasure, vsPrint, &ll, Interval{ 0.0, static_cast<XYPOSITION>(rc.right - rc.left) });
 
 		ll.containsCaret = false;
 
@@ -2847,8 +3125,8 @@ Sci::Position EditView::FormatRange(bool draw, CharacterRangeFull chrg, Rectangl
 		++lineDoc;
 	}
 
-	// Clear cache so measurements are not used for screen
-	posCache->Clear();
+	// Printer measurements are discarded so they are not used for screen
+	posCache = std::move(posCacheScreen);
 
 	return nPrintPos;
 }
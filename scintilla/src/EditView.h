@@ -44,7 +44,36 @@ void DrawStyledText(Surface *surface, const ViewStyle &vs, int styleOffset, PRec
 typedef void (*DrawTabArrowFn)(Surface *surface, PRectangle rcTab, int ymid,
 	const ViewStyle &vsDraw, Stroke stroke);
 
+/**
+* Retains images of lines painted with buffered drawing so that lines scrolled back into
+* view can be copied to the window instead of being laid out and drawn again.
+* Images are keyed by document line and sub-line so must be invalidated whenever anything
+* drawn on those lines changes or lines are inserted or removed.
+*/
+class LineBitmapCache {
+	struct Entry {
+		Sci::Line lineDoc = -1;
+		int subLine = 0;
+		int xOffset = 0;
+		XYPOSITION width = 0;	// Width of the line's text for tracking the scroll width
+		unsigned int lastUsed = 0;
+		std::unique_ptr<Surface> pixmap;
+	};
+	std::vector<Entry> entries;
+	size_t size = 0;
+	unsigned int clock = 0;
+public:
+	void SetSize(size_t size_);
+	size_t GetSize() const noexcept;
+	void Clear() noexcept;
+	void Invalidate(Sci::Line lineFirst, Sci::Line lineLast) noexcept;
+	Surface *Find(Sci::Line lineDoc, int subLine, int xOffset, XYPOSITION &width) noexcept;
+	void Store(Surface &source, int widthPixmap, int heightPixmap,
+		Sci::Line lineDoc, int subLine, int xOffset, XYPOSITION width);
+};
+
 class LineTabstops;
+class ThreadPool;
 
 /**
 * EditView draws the main text area.
@@ -79,11 +108,20 @@ public:
 	std::unique_ptr<Surface> pixmapIndentGuideHighlight;
 
 	LineLayoutCache llc;
-	std::unique_ptr<IPositionCache> posCache;
+	LineBitmapCache lineBitmapCache;
+	// Either owned by this view or the process-wide SharedPositionCache
+	std::shared_ptr<IPositionCache> posCache;
+	bool posCacheShared;
 
 	unsigned int maxLayoutThreads;
+	// Persistent threads sized by maxLayoutThreads shared by layout and wrapping
+	std::unique_ptr<ThreadPool> threadPool;
 	static constexpr int bytesPerLayoutThread = 1000;
 
+	// Lines at least this long are measured in chunks when visible. 0 measures whole lines.
+	Sci::Position chunkedLayoutLength;
+	static constexpr int bytesPerLayoutChunk = 4096;
+
 	int tabArrowHeight; // draw arrow heads this many pixels above/below line midpoint
 	/** Some platforms, notably PLAT_CURSES, do not support Scintilla's native
 	 * DrawTabArrow function for drawing tab characters. Allow those platforms to
@@ -107,6 +145,10 @@ public:
 	void SetLayoutThreads(unsigned int threads) noexcept;
 	unsigned int GetLayoutThreads() const noexcept;
 
+	void SetPositionCacheShared(bool shared);
+	bool GetPositionCacheShared() const noexcept;
+	void ClearPositionCache() noexcept;
+
 	void ClearAllTabstops() noexcept;
 	XYPOSITION NextTabstopPos(Sci::Line line, XYPOSITION x, XYPOSITION tabWidth) const noexcept;
 	bool ClearTabstops(Sci::Line line) noexcept;
@@ -120,6 +162,8 @@ public:
 	std::shared_ptr<LineLayout> RetrieveLineLayout(Sci::Line lineNumber, const EditModel &model);
 	void LayoutLine(const EditModel &model, Surface *surface, const ViewStyle &vstyle,
 		LineLayout *ll, int width, bool callerMultiThreaded=false);
+	void LayoutChunks(const EditModel &model, Surface *surface, const ViewStyle &vstyle,
+		LineLayout *ll, Interval horizontal);
 
 	static void UpdateBidiData(const EditModel &model, const ViewStyle &vstyle, LineLayout *ll);
 
@@ -133,7 +177,15 @@ public:
 	Sci::Position StartEndDisplayLine(Surface *surface, const EditModel &model, Sci::Position pos, bool start, const ViewStyle &vs);
 
 private:
+	// Horizontal extent of the area being painted by PaintText, so runs of text
+	// that can not reach the area are not drawn. Unset when not painting.
+	std::optional<Interval> paintExtent;
+
 	void UpdateMaxWidth(XYPOSITION width) noexcept;
+	bool MeasureRange(const EditModel &model, Surface *surface, const ViewStyle &vstyle,
+		LineLayout *ll, Range range, XYPOSITION *positionsRange, XYPOSITION xOrigin, bool callerMultiThreaded);
+	void EstimatePositions(const EditModel &model, const ViewStyle &vstyle, LineLayout *ll, int numCharsInLine);
+	void MeasureChunk(const EditModel &model, Surface *surface, const ViewStyle &vstyle, LineLayout *ll, size_t chunk);
 	void DrawEOL(Surface *surface, const EditModel &model, const ViewStyle &vsDraw, const LineLayout *ll,
 		Sci::Line line, int xStart, PRectangle rcLine, int subLine, Sci::Position lineEnd, XYPOSITION subLineStart, ColourOptional background);
 	void DrawFoldDisplayText(Surface *surface, const EditModel &model, const ViewStyle &vsDraw, const LineLayout *ll,
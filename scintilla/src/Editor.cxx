@@ -14,6 +14,7 @@
 #include <cmath>
 
 #include <stdexcept>
+#include <exception>
 #include <utility>
 #include <string>
 #include <string_view>
@@ -24,12 +25,13 @@
 #include <optional>
 #include <algorithm>
 #include <iterator>
+#include <functional>
 #include <memory>
 #include <chrono>
 #include <atomic>
 #include <mutex>
+#include <condition_variable>
 #include <thread>
-#include <future>
 
 #include "ScintillaTypes.h"
 #include "ScintillaMessages.h"
@@ -69,6 +71,7 @@
 #include "EditView.h"
 #include "Editor.h"
 #include "ElapsedPeriod.h"
+#include "ThreadPool.h"
 
 using namespace Scintilla;
 using namespace Scintilla::Internal;
@@ -197,6 +200,7 @@ Editor::Editor() : durationWrapOneByte(0.000001, 0.00000001, 0.00001) {
 	paintAbandonedByStyling = false;
 	paintingAllText = false;
 	willRedrawAll = false;
+	scrollingVertically = false;
 	idleStyling = IdleStyling::None;
 	needIdleStyling = false;
 
@@ -208,6 +212,8 @@ Editor::Editor() : durationWrapOneByte(0.000001, 0.00000001, 0.00001) {
 	recordingMacro = false;
 	foldAutomatic = AutomaticFold::None;
 
+	idleWrapping = IdleWrapping::Incremental;
+	estimateWrapHeights = false;
 	insideWrapScroll = false;
 
 	convertPastes = true;
@@ -238,7 +244,7 @@ void Editor::InvalidateStyleData() noexcept {
 	vs.technology = technology;
 	DropGraphics();
 	view.llc.Invalidate(LineLayout::ValidLevel::invalid);
-	view.posCache->Clear();
+	view.ClearPositionCache();
 }
 
 void Editor::InvalidateStyleRedraw() {
@@ -436,6 +442,7 @@ void Editor::RedrawRect(PRectangle rc) {
 
 	// Clip the redraw rectangle into the client area
 	const PRectangle rcClient = GetClientRectangle();
+	InvalidateLineBitmaps(rc, rcClient);
 	if (rc.top < rcClient.top)
 		rc.top = rcClient.top;
 	if (rc.bottom > rcClient.bottom)
@@ -450,11 +457,28 @@ void Editor::RedrawRect(PRectangle rc) {
 	}
 }
 
+// Retained images of the lines that are to be redrawn are out of date.
+void Editor::InvalidateLineBitmaps(PRectangle rc, PRectangle rcClient) noexcept {
+	if (rc.Contains(rcClient)) {
+		view.lineBitmapCache.Clear();
+	} else if (rc.bottom > rc.top) {
+		const Sci::Line lineLastDisplayed = pcs->LinesDisplayed() - 1;
+		const Sci::Line displayFirst = std::clamp<Sci::Line>(
+			topLine + static_cast<Sci::Line>(std::floor(rc.top / vs.lineHeight)), 0, lineLastDisplayed);
+		const Sci::Line displayLast = std::clamp<Sci::Line>(
+			topLine + static_cast<Sci::Line>(std::ceil(rc.bottom / vs.lineHeight)) - 1, 0, lineLastDisplayed);
+		view.lineBitmapCache.Invalidate(pcs->DocFromDisplay(displayFirst), pcs->DocFromDisplay(displayLast));
+	}
+}
+
 void Editor::DiscardOverdraw() {
 	// Overridden on platforms that may draw outside visible area.
 }
 
 void Editor::Redraw() {
+	if (!scrollingVertically) {
+		view.lineBitmapCache.Clear();
+	}
 	if (redrawPendingText) {
 		return;
 	}
@@ -544,12 +568,44 @@ PRectangle Editor::RectangleFromRange(Range r, int overlap) {
 }
 
 void Editor::InvalidateRange(Sci::Position start, Sci::Position end) {
+	// Retained line images may be for lines outside the window
+	view.lineBitmapCache.Invalidate(pdoc->SciLineFromPosition(start), pdoc->SciLineFromPosition(end));
 	if (redrawPendingText) {
 		return;
 	}
 	RedrawRect(RectangleFromRange(Range(start, end), view.LinesOverlap() ? vs.lineOverlap : 0));
 }
 
+// Invalidate only the part of a line between start and end, widened by padding on each side.
+// When the span may cover more than one screen line, invalidate whole lines instead.
+void Editor::InvalidateSpan(Surface *surface, SelectionPosition start, SelectionPosition end, XYPOSITION padding) {
+	if (redrawPendingText) {
+		return;
+	}
+	const Sci::Line lineDoc = pdoc->SciLineFromPosition(start.Position());
+	view.lineBitmapCache.Invalidate(lineDoc, lineDoc);
+	if (!surface || Wrapping() || BidirectionalEnabled() || (end.Position() > pdoc->LineEnd(lineDoc))) {
+		InvalidateRange(start.Position(), end.Position());
+		return;
+	}
+	const Sci::Line lineDisplay = pcs->DisplayFromDoc(lineDoc);
+	if (!pcs->GetVisible(lineDoc) || (lineDisplay < topLine - 1) || (lineDisplay > topLine + LinesOnScreen())) {
+		// Off screen so nothing to redraw
+		return;
+	}
+	const PRectangle rcText = GetTextRectangle();
+	const Point ptStart = view.LocationFromPosition(surface, *this, start, topLine, vs, PointEnd::start, rcText);
+	const Point ptEnd = view.LocationFromPosition(surface, *this, end, topLine, vs, PointEnd::start, rcText);
+	const int overlap = view.LinesOverlap() ? vs.lineOverlap : 0;
+	const int leftTextOverlap = ((xOffset == 0) && (vs.leftMarginWidth > 0)) ? 1 : 0;
+	PRectangle rc;
+	rc.left = std::max(std::floor(ptStart.x - padding), static_cast<XYPOSITION>(vs.textStart - leftTextOverlap));
+	rc.right = std::ceil(ptEnd.x + padding);
+	rc.top = ptStart.y - overlap;
+	rc.bottom = ptStart.y + vs.lineHeight + overlap;
+	RedrawRect(rc);
+}
+
 Sci::Position Editor::CurrentPosition() const noexcept {
 	return sel.MainCaret();
 }
@@ -985,11 +1041,14 @@ void Editor::ScrollTo(Sci::Line line, bool moveThumb) {
 		StyleAreaBounded(GetClientRectangle(), true);
 #ifndef UNDER_CE
 		// Perform redraw rather than scroll if many lines would be redrawn anyway.
+		// Only the position of lines has changed so retained line images are still valid.
+		scrollingVertically = true;
 		if (performBlit) {
 			ScrollText(linesToMove);
 		} else {
 			Redraw();
 		}
+		scrollingVertically = false;
 		willRedrawAll = false;
 #else
 		Redraw();
@@ -1498,6 +1557,39 @@ void Editor::InvalidateCaret() {
 	UpdateSystemCaret();
 }
 
+// Blinking only changes the carets themselves, so redraw just around each caret instead of
+// the whole of their lines. The caret line background does not blink.
+void Editor::RedrawCarets() {
+	RefreshStyleData();
+	AutoSurface surface(this);
+	// Block carets cover the following character and carets at the end of a selection may be
+	// drawn over the preceding character.
+	const XYPOSITION padding = std::max(vs.aveCharWidth, static_cast<XYPOSITION>(vs.caret.width)) + 1;
+	auto redrawAround = [&](SelectionPosition pos) {
+		const Sci::Position position = pos.Position();
+		const Sci::Line lineDoc = pdoc->SciLineFromPosition(position);
+		SelectionPosition posBefore = pos;
+		if (pos.VirtualSpace() > 0) {
+			posBefore.SetVirtualSpace(pos.VirtualSpace() - 1);
+		} else if (position > pdoc->LineStart(lineDoc)) {
+			posBefore = SelectionPosition(pdoc->MovePositionOutsideChar(position - 1, -1));
+		}
+		SelectionPosition posAfter = pos;
+		if ((pos.VirtualSpace() == 0) && (position < pdoc->LineEnd(lineDoc))) {
+			posAfter = SelectionPosition(pdoc->MovePositionOutsideChar(position + 1, 1));
+		}
+		InvalidateSpan(surface, posBefore, posAfter, padding);
+	};
+	if (posDrag.IsValid()) {
+		redrawAround(posDrag);
+	} else {
+		for (size_t r=0; r<sel.Count(); r++) {
+			redrawAround(sel.Range(r).caret);
+		}
+	}
+	UpdateSystemCaret();
+}
+
 void Editor::NotifyCaretMove() {
 }
 
@@ -1558,9 +1650,7 @@ bool Editor::WrapBlock(Surface *surface, Sci::Line lineToWrap, Sci::Line lineToW
 
 	// Wrap all the short lines in multiple threads
 
-	// If only 1 thread needed then use the main thread, else spin up multiple
-	const std::launch policy = multiThreaded ? std::launch::async : std::launch::deferred;
-
+	// If only 1 thread needed then use the main thread, else share with the pool's workers
 	std::atomic<size_t> nextIndex = 0;
 
 	// Lines that are less likely to be re-examined should not be read from or written to the cache.
@@ -1574,39 +1664,31 @@ bool Editor::WrapBlock(Surface *surface, Sci::Line lineToWrap, Sci::Line lineToW
 	// Protect the line layout cache from being accessed from multiple threads simultaneously
 	std::mutex mutexRetrieve;
 
-	std::vector<std::future<void>> futures;
-	for (size_t th = 0; th < threads; th++) {
-		std::future<void> fut = std::async(policy,
-			[=, &surface, &nextIndex, &linesAfterWrap, &mutexRetrieve]() {
-			// llTemporary is reused for non-significant lines, avoiding allocation costs.
-			std::shared_ptr<LineLayout> llTemporary = std::make_shared<LineLayout>(-1, 200);
-			while (true) {
-				const size_t i = nextIndex.fetch_add(1, std::memory_order_acq_rel);
-				if (i >= linesBeingWrapped) {
-					break;
-				}
-				const Sci::Line lineNumber = lineToWrap + i;
-				const Range rangeLine = pdoc->LineRange(lineNumber);
-				const Sci::Position lengthLine = rangeLine.Length();
-				if (lengthLine < lengthToMultiThread) {
-					std::shared_ptr<LineLayout> ll;
-					if (significantLines.LineMayCache(lineNumber)) {
-						std::lock_guard<std::mutex> guard(mutexRetrieve);
-						ll = view.RetrieveLineLayout(lineNumber, *this);
-					} else {
-						ll = llTemporary;
-						ll->ReSet(lineNumber, lengthLine);
-					}
-					view.LayoutLine(*this, surface, vs, ll.get(), wrapWidth, multiThreaded);
-					linesAfterWrap[i] = ll->lines;
+	view.threadPool->Run(threads, [=, &surface, &nextIndex, &linesAfterWrap, &mutexRetrieve](size_t) {
+		// llTemporary is reused for non-significant lines, avoiding allocation costs.
+		std::shared_ptr<LineLayout> llTemporary = std::make_shared<LineLayout>(-1, 200);
+		while (true) {
+			const size_t i = nextIndex.fetch_add(1, std::memory_order_acq_rel);
+			if (i >= linesBeingWrapped) {
+				break;
+			}
+			const Sci::Line lineNumber = lineToWrap + i;
+			const Range rangeLine = pdoc->LineRange(lineNumber);
+			const Sci::Position lengthLine = rangeLine.Length();
+			if (lengthLine < lengthToMultiThread) {
+				std::shared_ptr<LineLayout> ll;
+				if (significantLines.LineMayCache(lineNumber)) {
+					std::lock_guard<std::mutex> guard(mutexRetrieve);
+					ll = view.RetrieveLineLayout(lineNumber, *this);
+				} else {
+					ll = llTemporary;
+					ll->ReSet(lineNumber, lengthLine);
 				}
+				view.LayoutLine(*this, surface, vs, ll.get(), wrapWidth, multiThreaded);
+				linesAfterWrap[i] = ll->lines;
 			}
-		});
-		futures.push_back(std::move(fut));
-	}
-	for (const std::future<void> &f : futures) {
-		f.wait();
-	}
+		}
+	});
 	// End of multiple threads
 
 	// Multiply duration by number of threads to produce (near) equivalence to duration if single threaded
@@ -1656,10 +1738,35 @@ bool Editor::WrapBlock(Surface *surface, Sci::Line lineToWrap, Sci::Line lineToW
 	return wrapsDone > 0;
 }
 
+// Give lines that are waiting to be wrapped a height estimated from their length in bytes
+// so the scroll range is close to its final size while they are wrapped in idle time.
+// Return true if any height changed.
+bool Editor::EstimateWrapHeights(Sci::Line lineStart, Sci::Line lineEnd) {
+	if ((wrapWidth == LineLayout::wrapWidthInfinite) || (vs.aveCharWidth <= 0)) {
+		return false;
+	}
+	const double charsPerSubLine = std::max(1.0, wrapWidth / vs.aveCharWidth);
+	const bool annotations = vs.annotationVisible != AnnotationVisible::Hidden;
+	lineEnd = std::min(lineEnd, pdoc->LinesTotal());
+	bool changed = false;
+	for (Sci::Line line = lineStart; line < lineEnd; line++) {
+		const Sci::Position lengthLine = pdoc->LineEnd(line) - pdoc->LineStart(line);
+		int linesWrapped = std::max(1, static_cast<int>(std::ceil(lengthLine / charsPerSubLine)));
+		if (annotations) {
+			linesWrapped += pdoc->AnnotationLines(line);
+		}
+		if (pcs->SetHeight(line, linesWrapped)) {
+			changed = true;
+		}
+	}
+	return changed;
+}
+
 // Perform  wrapping for a subset of the lines needing wrapping.
 // wsAll: wrap all lines which need wrapping in this single call
 // wsVisible: wrap currently visible lines
 // wsIdle: wrap one page + 100 lines
+// wsBackground: wrap a large block over all the layout threads and report progress
 // Return true if wrapping occurred.
 bool Editor::WrapLines(WrapScope ws) {
 	Sci::Line goodTopLine = topLine;
@@ -1677,6 +1784,7 @@ bool Editor::WrapLines(WrapScope ws) {
 			wrapOccurred = true;
 		}
 		wrapPending.Reset();
+		estimatePending.Reset();
 
 	} else if (wrapPending.NeedsWrap()) {
 		wrapPending.start = std::min(wrapPending.start, pdoc->LinesTotal());
@@ -1726,6 +1834,14 @@ bool Editor::WrapLines(WrapScope ws) {
 				durationWrapOneByte.ActionsInAllowedTime(secondsAllowed),
 				0x200, 0x20000);
 			lineToWrapEnd = pdoc->LineFromPositionAfter(lineToWrap, actionsInAllowedTime);
+		} else if (ws == WrapScope::wsBackground) {
+			// Durations are measured as if single threaded so allow more for each thread
+			// while still returning to the event loop often enough to respond to the user.
+			const double secondsAllowed = 0.05 * view.maxLayoutThreads;
+			const size_t actionsInAllowedTime = std::clamp<Sci::Line>(
+				durationWrapOneByte.ActionsInAllowedTime(secondsAllowed),
+				0x2000, 0x1000000);
+			lineToWrapEnd = pdoc->LineFromPositionAfter(lineToWrap, actionsInAllowedTime);
 		}
 		const Sci::Line lineEndNeedWrap = std::min(wrapPending.end, pdoc->LinesTotal());
 		lineToWrapEnd = std::min(lineToWrapEnd, lineEndNeedWrap);
@@ -1738,13 +1854,38 @@ bool Editor::WrapLines(WrapScope ws) {
 			PRectangle rcTextArea = GetClientRectangle();
 			rcTextArea.left = static_cast<XYPOSITION>(vs.textStart);
 			rcTextArea.right -= vs.rightMarginWidth;
+			const int wrapWidthPrevious = wrapWidth;
 			wrapWidth = static_cast<int>(rcTextArea.Width());
 			RefreshStyleData();
 			AutoSurface surface(this);
 			if (surface) {
 //Platform::DebugPrintf("Wraplines: scope=%0d need=%0d..%0d perform=%0d..%0d\n", ws, wrapPending.start, wrapPending.end, lineToWrap, lineToWrapEnd);
 
-				wrapOccurred = WrapBlock(surface, lineToWrap, lineToWrapEnd);
+				if (estimateWrapHeights && (wrapWidth != wrapWidthPrevious)) {
+					// Wrap mode or width changed so every pending line is likely to change height
+					estimatePending.Reset();
+					estimatePending.AddRange(wrapPending.start, lineEndNeedWrap);
+				}
+				if ((ws != WrapScope::wsAll) && estimatePending.NeedsWrap()) {
+					// Estimate a bounded block of lines each time so a new width does not stall
+					// on huge documents. Lines before wrapPending.start already have exact
+					// heights and lines on screen are wrapped exactly so are skipped.
+					constexpr Sci::Line linesEstimatedEachTime = 0x8000;
+					const Sci::Line estimateStart = std::max(estimatePending.start, wrapPending.start);
+					const Sci::Line estimateEnd = std::min({estimatePending.end, lineEndNeedWrap,
+						estimateStart + linesEstimatedEachTime});
+					const Sci::Line lineDocBottom = lineDocTop + LinesOnScreen() + 1;
+					if (EstimateWrapHeights(estimateStart, std::min(estimateEnd, lineDocTop))) {
+						wrapOccurred = true;
+					}
+					if (EstimateWrapHeights(std::max(estimateStart, lineDocBottom), estimateEnd)) {
+						wrapOccurred = true;
+					}
+					estimatePending.start = estimateEnd;
+				}
+				if (WrapBlock(surface, lineToWrap, lineToWrapEnd)) {
+					wrapOccurred = true;
+				}
 
 				goodTopLine = pcs->DisplayFromDocSub(lineScrollTo.lineDoc, lineScrollTo.subLine);
 			}
@@ -1753,8 +1894,13 @@ bool Editor::WrapLines(WrapScope ws) {
 		// If wrapping is done, bring it to resting position
 		if (wrapPending.start >= lineEndNeedWrap) {
 			wrapPending.Reset();
+			estimatePending.Reset();
 			scrollToAfterWrap.reset();
 		}
+
+		if (ws == WrapScope::wsBackground) {
+			NotifyWrapProgress();
+		}
 	}
 
 	if (wrapOccurred) {
@@ -2640,11 +2786,15 @@ void Editor::NotifyHotSpotReleaseClick(Sci::Position position, KeyMod modifiers)
 
 bool Editor::NotifyUpdateUI() {
 	if (needUpdateUI != Update::None) {
+		// The container may change anything so any redraw it causes is not just for scrolling
+		const bool scrollingBefore = scrollingVertically;
+		scrollingVertically = false;
 		NotificationData scn = {};
 		scn.nmhdr.code = Notification::UpdateUI;
 		scn.updated = needUpdateUI;
 		NotifyParent(scn);
 		needUpdateUI = Update::None;
+		scrollingVertically = scrollingBefore;
 		return true;
 	}
 	return false;
@@ -2743,6 +2893,17 @@ void Editor::NotifyZoom() {
 	NotifyParent(scn);
 }
 
+void Editor::NotifyWrapProgress() {
+	const Sci::Line linesTotal = pdoc->LinesTotal();
+	const Sci::Line linesPending = wrapPending.NeedsWrap() ?
+		std::min(wrapPending.end, linesTotal) - wrapPending.start : 0;
+	NotificationData scn = {};
+	scn.nmhdr.code = Notification::WrapProgress;
+	scn.position = (linesTotal - linesPending) * 100 / linesTotal;
+	scn.line = wrapPending.NeedsWrap() ? wrapPending.start : linesTotal;
+	NotifyParent(scn);
+}
+
 // Notifications from document
 void Editor::NotifyModifyAttempt(Document *, void *) {
 	//Platform::DebugPrintf("** Modify Attempt\n");
@@ -2766,7 +2927,18 @@ void Editor::CheckModificationForWrap(DocModification mh) {
 					wrapPending.end += mh.linesAdded;
 				}
 			}
+			if (estimatePending.NeedsWrap()) {
+				if (lineDoc < estimatePending.start) {
+					estimatePending.start = std::max(lineDoc, estimatePending.start + mh.linesAdded);
+				}
+				if (lineDoc < estimatePending.end) {
+					estimatePending.end += mh.linesAdded;
+				}
+			}
 			NeedWrapping(lineDoc, lineDoc + lines + 1);
+			if (estimateWrapHeights && (lines > 0)) {
+				EstimateWrapHeights(lineDoc + 1, lineDoc + lines + 1);
+			}
 		}
 		RefreshStyleData();
 		// Fix up annotation heights
@@ -2801,6 +2973,17 @@ constexpr Sci::Position MovePositionForDeletion(Sci::Position position, Sci::Pos
 
 void Editor::NotifyModified(Document *, DocModification mh, void *) {
 	ContainerNeedsUpdate(Update::Content);
+	if (mh.linesAdded != 0) {
+		// Retained line images are keyed by line so are out of place
+		view.lineBitmapCache.Clear();
+	} else {
+		view.lineBitmapCache.Invalidate(pdoc->SciLineFromPosition(mh.position),
+			pdoc->SciLineFromPosition(mh.position + mh.length));
+		if (FlagSet(mh.modificationType, ModificationFlags::ChangeMarker | ModificationFlags::ChangeFold)) {
+			// Fold lines are drawn at the boundary between lines
+			view.lineBitmapCache.Invalidate(mh.line - 1, mh.line + 1);
+		}
+	}
 	if (paintState == PaintState::painting) {
 		CheckForChangeOutsidePaint(Range(mh.position, mh.position + mh.length));
 	}
@@ -2834,6 +3017,12 @@ void Editor::NotifyModified(Document *, DocModification mh, void *) {
 			if (mh.position < pdoc->LineStart(lineDocTop)) {
 				// Styling performed before this view
 				Redraw();
+			} else if (!FlagSet(mh.modificationType, ModificationFlags::ChangeStyle)) {
+				// Indicators only change the appearance of their range but some, like
+				// INDIC_POINT, draw a little outside it.
+				AutoSurface surface(this);
+				InvalidateSpan(surface, SelectionPosition(mh.position),
+					SelectionPosition(mh.position + mh.length), static_cast<XYPOSITION>(vs.lineHeight));
 			} else {
 				InvalidateRange(mh.position, mh.position + mh.length);
 			}
@@ -4445,6 +4634,23 @@ Sci::Position Editor::SearchInTarget(const char *text, Sci::Position length) {
 	}
 }
 
+Sci::Position Editor::SearchAllInTarget(const char *text, Sci::Position maxMatches, bool remember) {
+	if (remember) {
+		foundRanges.clear();
+	}
+
+	if (!pdoc->HasCaseFolder())
+		pdoc->SetCaseFolder(CaseFolderForEncoding());
+	try {
+		return pdoc->FindAll(targetRange.start.Position(), targetRange.end.Position(), text,
+			searchFlags, strlen(text), maxMatches, remember ? &foundRanges : nullptr);
+	} catch (RegexError &) {
+		errorStatus = Status::RegEx;
+		foundRanges.clear();
+		return 0;
+	}
+}
+
 void Editor::GoToLine(Sci::Line lineNo) {
 	if (lineNo > pdoc->LinesTotal())
 		lineNo = pdoc->LinesTotal();
@@ -5299,7 +5505,7 @@ bool Editor::Idle() {
 
 	if (needWrap) {
 		// Wrap lines during idle.
-		WrapLines(WrapScope::wsIdle);
+		WrapLines((idleWrapping == IdleWrapping::Background) ? WrapScope::wsBackground : WrapScope::wsIdle);
 		// No more wrapping
 		needWrap = wrapPending.NeedsWrap();
 	} else if (needIdleStyling) {
@@ -5321,7 +5527,7 @@ void Editor::TickFor(TickReason reason) {
 		case TickReason::caret:
 			caret.on = !caret.on;
 			if (caret.active) {
-				InvalidateCaret();
+				RedrawCarets();
 			}
 			break;
 		case TickReason::scroll:
@@ -5446,7 +5652,7 @@ Sci::Position Editor::PositionAfterMaxStyling(Sci::Position posMax, bool scrolli
 }
 
 void Editor::StartIdleStyling(bool truncatedLastStyling) {
-	if (AnyOf(idleStyling, IdleStyling::All, IdleStyling::AfterVisible)) {
+	if (AnyOf(idleStyling, IdleStyling::All, IdleStyling::AfterVisible, IdleStyling::Background)) {
 		if (pdoc->GetEndStyled() < pdoc->Length()) {
 			// Style remainder of document in idle time
 			needIdleStyling = true;
@@ -5466,8 +5672,10 @@ void Editor::StyleAreaBounded(PRectangle rcArea, bool scrolling) {
 	const Sci::Position posAfterMax = PositionAfterMaxStyling(posAfterArea, scrolling);
 	if (posAfterMax < posAfterArea) {
 		// Idle styling may be performed before current visible area
-		// Style a bit now then style further in idle time
-		pdoc->StyleToAdjustingLineDuration(posAfterMax);
+		// Style a bit now then style further in idle time unless a worker thread is styling
+		if ((idleStyling != IdleStyling::Background) || !pdoc->StyleInBackground(false)) {
+			pdoc->StyleToAdjustingLineDuration(posAfterMax);
+		}
 	} else {
 		// Can style all wanted now.
 		StyleToPositionInView(posAfterArea);
@@ -5476,6 +5684,10 @@ void Editor::StyleAreaBounded(PRectangle rcArea, bool scrolling) {
 }
 
 void Editor::IdleStyle() {
+	if ((idleStyling == IdleStyling::Background) && pdoc->StyleInBackground(true)) {
+		// Worker thread is styling and its results are applied here
+		return;
+	}
 	const Sci::Position posAfterArea = PositionAfterArea(GetClientRectangle());
 	const Sci::Position endGoal = (idleStyling >= IdleStyling::AfterVisible) ?
 		pdoc->Length() : posAfterArea;
@@ -5524,6 +5736,10 @@ bool Editor::PaintContainsMargin() {
 }
 
 void Editor::CheckForChangeOutsidePaint(Range r) {
+	if (r.Valid()) {
+		// Even when inside the paint, retained images of the range's lines are out of date
+		view.lineBitmapCache.Invalidate(pdoc->SciLineFromPosition(r.start), pdoc->SciLineFromPosition(r.end));
+	}
 	if (paintState == PaintState::painting && !paintingAllText) {
 		//Platform::DebugPrintf("Checking range in paint %d-%d\n", r.start, r.end);
 		if (!r.Valid())
@@ -6591,6 +6807,24 @@ sptr_t Editor::WndProc(Message iMessage, uptr_t wParam, sptr_t lParam) {
 		PLATFORM_ASSERT(lParam);
 		return SearchInTarget(ConstCharPtrFromSPtr(lParam), PositionFromUPtr(wParam));
 
+	case Message::FindAllInTarget:
+		PLATFORM_ASSERT(lParam);
+		return SearchAllInTarget(ConstCharPtrFromSPtr(lParam), PositionFromUPtr(wParam), true);
+
+	case Message::CountAllInTarget:
+		PLATFORM_ASSERT(lParam);
+		return SearchAllInTarget(ConstCharPtrFromSPtr(lParam), PositionFromUPtr(wParam), false);
+
+	case Message::GetFoundStart:
+		if (wParam < foundRanges.size())
+			return foundRanges[wParam].start;
+		return Sci::invalidPosition;
+
+	case Message::GetFoundEnd:
+		if (wParam < foundRanges.size())
+			return foundRanges[wParam].end;
+		return Sci::invalidPosition;
+
 	case Message::SetSearchFlags:
 		searchFlags = static_cast<FindOption>(wParam);
 		break;
@@ -7280,6 +7514,20 @@ sptr_t Editor::WndProc(Message iMessage, uptr_t wParam, sptr_t lParam) {
 	case Message::GetWrapMode:
 		return static_cast<sptr_t>(vs.wrap.state);
 
+	case Message::SetIdleWrapping:
+		idleWrapping = static_cast<IdleWrapping>(wParam);
+		break;
+
+	case Message::GetIdleWrapping:
+		return static_cast<sptr_t>(idleWrapping);
+
+	case Message::SetEstimateWrapHeights:
+		estimateWrapHeights = wParam != 0;
+		break;
+
+	case Message::GetEstimateWrapHeights:
+		return estimateWrapHeights;
+
 	case Message::SetWrapVisualFlags:
 		if (vs.SetWrapVisualFlags(static_cast<WrapVisualFlag>(wParam))) {
 			InvalidateStyleRedraw();
@@ -7335,6 +7583,51 @@ sptr_t Editor::WndProc(Message iMessage, uptr_t wParam, sptr_t lParam) {
 	case Message::GetPositionCache:
 		return view.posCache->GetSize();
 
+	case Message::SetPositionCacheShared:
+		view.SetPositionCacheShared(wParam != 0);
+		break;
+
+	case Message::GetPositionCacheShared:
+		return view.GetPositionCacheShared();
+
+	case Message::SetLineBitmapCache:
+		view.lineBitmapCache.SetSize(wParam);
+		break;
+
+	case Message::GetLineBitmapCache:
+		return view.lineBitmapCache.GetSize();
+
+	case Message::SetChunkedLayoutLength: {
+			const Sci::Position length = std::max<Sci::Position>(PositionFromUPtr(wParam), 0);
+			if (view.chunkedLayoutLength != length) {
+				view.chunkedLayoutLength = length;
+				view.llc.Invalidate(LineLayout::ValidLevel::invalid);
+				Redraw();
+			}
+		}
+		break;
+
+	case Message::GetChunkedLayoutLength:
+		return view.chunkedLayoutLength;
+
+	case Message::GetPositionCacheStatistic: {
+			const PositionCacheStatistics statistics = view.posCache->Statistics();
+			switch (static_cast<PositionCacheStatistic>(wParam)) {
+			case PositionCacheStatistic::Hits:
+				return statistics.hits;
+			case PositionCacheStatistic::Misses:
+				return statistics.misses;
+			case PositionCacheStatistic::Evictions:
+				return statistics.evictions;
+			default:
+				return 0;
+			}
+		}
+
+	case Message::ClearPositionCacheStatistics:
+		view.posCache->ClearStatistics();
+		break;
+
 	case Message::SetLayoutThreads:
 		view.SetLayoutThreads(static_cast<unsigned int>(wParam));
 		break;
@@ -7342,6 +7635,28 @@ sptr_t Editor::WndProc(Message iMessage, uptr_t wParam, sptr_t lParam) {
 	case Message::GetLayoutThreads:
 		return view.GetLayoutThreads();
 
+	case Message::GetLayoutThreadStatistic: {
+			const ThreadPoolStatistics statistics = view.threadPool->Statistics();
+			switch (static_cast<LayoutThreadStatistic>(wParam)) {
+			case LayoutThreadStatistic::Runs:
+				return statistics.runs;
+			case LayoutThreadStatistic::Tasks:
+				return statistics.tasks;
+			case LayoutThreadStatistic::WorkerTasks:
+				return statistics.workerTasks;
+			case LayoutThreadStatistic::ThreadsCreated:
+				return statistics.threadsCreated;
+			case LayoutThreadStatistic::IdleMicroseconds:
+				return static_cast<sptr_t>(statistics.idle.count());
+			default:
+				return 0;
+			}
+		}
+
+	case Message::ClearLayoutThreadStatistics:
+		view.threadPool->ClearStatistics();
+		break;
+
 	case Message::SetScrollWidth:
 		PLATFORM_ASSERT(wParam > 0);
 		if ((wParam > 0) && (wParam != static_cast<unsigned int>(scrollWidth))) {
@@ -8275,6 +8590,14 @@ sptr_t Editor::WndProc(Message iMessage, uptr_t wParam, sptr_t lParam) {
 			pdoc->decorations->GetCurrentValue(), lParam);
 		break;
 
+	case Message::IndicatorFillFound: {
+			const int value = pdoc->decorations->GetCurrentValue();
+			for (const Range &range : foundRanges) {
+				pdoc->DecorationFillRange(range.start, value, range.end - range.start);
+			}
+		}
+		break;
+
 	case Message::IndicatorClearRange:
 		pdoc->DecorationFillRange(PositionFromUPtr(wParam), 0,
 			lParam);
@@ -8981,7 +9304,7 @@ sptr_t Editor::WndProc(Message iMessage, uptr_t wParam, sptr_t lParam) {
 
 	case Message::SetAdditionalCaretsBlink:
 		view.additionalCaretsBlink = wParam != 0;
-		InvalidateCaret();
+		RedrawCarets();
 		break;
 
 	case Message::GetAdditionalCaretsBlink:
@@ -8989,7 +9312,7 @@ sptr_t Editor::WndProc(Message iMessage, uptr_t wParam, sptr_t lParam) {
 
 	case Message::SetAdditionalCaretsVisible:
 		view.additionalCaretsVisible = wParam != 0;
-		InvalidateCaret();
+		RedrawCarets();
 		break;
 
 	case Message::GetAdditionalCaretsVisible:
@@ -257,6 +257,7 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 	Sci::Position wordSelectInitialCaretPos;
 	SelectionSegment targetRange;
 	Scintilla::FindOption searchFlags;
+	std::vector<Range> foundRanges;	// Matches from FindAllInTarget
 	Sci::Line topLine;
 	Sci::Position posTopLine;
 	Sci::Position lengthForEncode;
@@ -268,6 +269,7 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 	PRectangle rcPaint;
 	bool paintingAllText;
 	bool willRedrawAll;
+	bool scrollingVertically;
 	WorkNeeded workNeeded;
 	Scintilla::IdleStyling idleStyling;
 	bool needIdleStyling;
@@ -289,6 +291,9 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 
 	// Wrapping support
 	WrapPending wrapPending;
+	Scintilla::IdleWrapping idleWrapping;
+	bool estimateWrapHeights;
+	WrapPending estimatePending;	// Lines waiting to be wrapped that have not yet had a height estimated
 	ActionDuration durationWrapOneByte;
 	bool insideWrapScroll;
 	struct LineDocSub {
@@ -342,11 +347,13 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 
 	virtual bool AbandonPaint();
 	virtual void RedrawRect(PRectangle rc);
+	void InvalidateLineBitmaps(PRectangle rc, PRectangle rcClient) noexcept;
 	virtual void DiscardOverdraw();
 	virtual void Redraw();
 	void RedrawSelMargin(Sci::Line line=-1, bool allAfter=false);
 	PRectangle RectangleFromRange(Range r, int overlap);
 	void InvalidateRange(Sci::Position start, Sci::Position end);
+	void InvalidateSpan(Surface *surface, SelectionPosition start, SelectionPosition end, XYPOSITION padding);
 
 	bool UserVirtualSpace() const noexcept {
 		return (FlagSet(virtualSpaceOptions, Scintilla::VirtualSpace::UserAccessible));
@@ -412,6 +419,7 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 	void DropCaret();
 	void CaretSetPeriod(int period);
 	void InvalidateCaret();
+	void RedrawCarets();
 	virtual void NotifyCaretMove();
 	virtual void UpdateSystemCaret();
 
@@ -419,7 +427,8 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 	void NeedWrapping(Sci::Line docLineStart=0, Sci::Line docLineEnd=WrapPending::lineLarge);
 	bool WrapOneLine(Surface *surface, Sci::Line lineToWrap);
 	bool WrapBlock(Surface *surface, Sci::Line lineToWrap, Sci::Line lineToWrapEnd);
-	enum class WrapScope {wsAll, wsVisible, wsIdle};
+	bool EstimateWrapHeights(Sci::Line lineStart, Sci::Line lineEnd);
+	enum class WrapScope {wsAll, wsVisible, wsIdle, wsBackground};
 	bool WrapLines(WrapScope ws);
 	void LinesJoin();
 	void LinesSplit(int pixelWidth);
@@ -490,6 +499,7 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 	void NotifyNeedShown(Sci::Position pos, Sci::Position len);
 	void NotifyDwelling(Point pt, bool state);
 	void NotifyZoom();
+	void NotifyWrapProgress();
 
 	void NotifyModifyAttempt(Document *document, void *userData) override;
 	void NotifySavePoint(Document *document, void *userData, bool atSavePoint) override;
@@ -537,6 +547,7 @@ protected:	// ScintillaBase subclass needs access to much of Editor
 	void SearchAnchor() noexcept;
 	Sci::Position SearchText(Scintilla::Message iMessage, Scintilla::uptr_t wParam, Scintilla::sptr_t lParam);
 	Sci::Position SearchInTarget(const char *text, Sci::Position length);
+	Sci::Position SearchAllInTarget(const char *text, Sci::Position maxMatches, bool remember);
 	void GoToLine(Sci::Line lineNo);
 
 	virtual void CopyToClipboard(const SelectionText &selectedText) = 0;
@@ -0,0 +1,685 @@
+// Scintilla source code edit control
+/** @file LinearRegex.cxx
+ ** Regular expression search that takes time proportional to the length of the text.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <cstddef>
+#include <cstring>
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <algorithm>
+
+#include "Position.h"
+#include "CharClassify.h"
+#include "UniConversion.h"
+#include "LinearRegex.h"
+
+using namespace Scintilla::Internal;
+
+namespace {
+
+// Bytes that are not valid UTF-8 are treated as characters above the Unicode range.
+constexpr int invalidBase = 0x110000;
+constexpr int maxUnicode = 0x10FFFF;
+
+// Limits memory and time used by very large patterns
+constexpr size_t maxInstructions = 20000;
+
+constexpr bool IsLineEnd(int ch) noexcept {
+	return ch == '\r' || ch == '\n';
+}
+
+constexpr int EscapeValue(char ch) noexcept {
+	switch (ch) {
+	case 'a':	return '\a';
+	case 'b':	return '\b';
+	case 'f':	return '\f';
+	case 'n':	return '\n';
+	case 'r':	return '\r';
+	case 't':	return '\t';
+	case 'v':	return '\v';
+	default:	break;
+	}
+	return -1;
+}
+
+constexpr int HexValue(char ch) noexcept {
+	if (ch >= '0' && ch <= '9')
+		return ch - '0';
+	if (ch >= 'A' && ch <= 'F')
+		return ch - 'A' + 10;
+	if (ch >= 'a' && ch <= 'f')
+		return ch - 'a' + 10;
+	return -1;
+}
+
+// Read one character from text at position, returning its value and setting width.
+int CharacterAt(std::string_view text, size_t position, bool utf8, int &width) noexcept {
+	const unsigned char uch = text[position];
+	width = 1;
+	if (!utf8 || UTF8IsAscii(uch)) {
+		return uch;
+	}
+	const unsigned char *us = reinterpret_cast<const unsigned char *>(text.data() + position);
+	const int utf8Status = UTF8Classify(us, text.length() - position);
+	if (utf8Status & UTF8MaskInvalid) {
+		return invalidBase + uch;
+	}
+	width = utf8Status & UTF8MaskWidth;
+	return UnicodeFromUTF8(us);
+}
+
+}
+
+const char *const LinearRegex::unsupportedBackReference = "Back references not supported";
+
+bool LinearRegex::CharacterSet::Contains(int ch) const noexcept {
+	if (IsLineEnd(ch)) {
+		// Matches are confined to a line
+		return false;
+	}
+	bool inSet = false;
+	if (ch < static_cast<int>(bytes.size())) {
+		inSet = bytes[ch];
+	} else {
+		inSet = std::any_of(ranges.begin(), ranges.end(), [ch](const std::pair<int, int> &range) noexcept {
+			return ch >= range.first && ch <= range.second;
+		});
+	}
+	return inSet != negated;
+}
+
+struct LinearRegex::Node {
+	enum class Kind { character, any, set, group, assertion };
+	enum class Quantifier { one, star, plus, question };
+	Kind kind = Kind::character;
+	int value = 0;	// Character, set index, tag, or assertion
+	Quantifier quantifier = Quantifier::one;
+	bool lazy = false;
+	std::vector<Node> children;
+};
+
+// Recursive descent parser turning a pattern into a tree of nodes.
+class LinearRegex::Parser {
+	LinearRegex &re;
+	std::string_view pattern;
+	bool caseSensitive;
+	bool posix;
+	size_t position = 0;
+	int tags = 1;
+	const char *error = nullptr;
+
+	[[nodiscard]] bool AtEnd() const noexcept {
+		return position >= pattern.length();
+	}
+	[[nodiscard]] char Peek(size_t offset=0) const noexcept {
+		return (position + offset < pattern.length()) ? pattern[position + offset] : '\0';
+	}
+	int ReadCharacter() noexcept {
+		int width = 1;
+		const int ch = CharacterAt(pattern, position, re.utf8, width);
+		position += width;
+		return ch;
+	}
+	// Limit of bytes that are single characters
+	[[nodiscard]] int ByteLimit() const noexcept {
+		return re.utf8 ? 0x80 : 0x100;
+	}
+
+	void AddCharacter(CharacterSet &set, int ch) const {
+		AddRange(set, ch, ch);
+	}
+	void AddRange(CharacterSet &set, int first, int last) const {
+		const int byteLimit = ByteLimit();
+		for (int ch = first; ch <= std::min(last, byteLimit - 1); ch++) {
+			set.bytes[ch] = true;
+			if (!caseSensitive) {
+				if (ch >= 'a' && ch <= 'z') {
+					set.bytes[ch - 'a' + 'A'] = true;
+				} else if (ch >= 'A' && ch <= 'Z') {
+					set.bytes[ch - 'A' + 'a'] = true;
+				}
+			}
+		}
+		if (last >= byteLimit) {
+			set.ranges.emplace_back(std::max(first, byteLimit), last);
+		}
+	}
+	// Add \d, \s, \w or their complements.
+	void AddClass(CharacterSet &set, char escape) const {
+		const int byteLimit = ByteLimit();
+		const bool complement = (escape >= 'A') && (escape <= 'Z');
+		const char kind = complement ? static_cast<char>(escape - 'A' + 'a') : escape;
+		for (int ch = 0; ch < byteLimit; ch++) {
+			bool member = false;
+			if (kind == 'd') {
+				member = ch >= '0' && ch <= '9';
+			} else if (kind == 's') {
+				member = (ch == ' ') || (ch >= 0x09 && ch <= 0x0D);
+			} else {
+				member = re.charClass->IsWord(static_cast<unsigned char>(ch));
+			}
+			if (member != complement) {
+				set.bytes[ch] = true;
+			}
+		}
+		if (re.utf8) {
+			// Characters above ASCII are words when their lead bytes are treated as words
+			// since RESearch examines bytes.
+			const bool highMember = (kind == 'w') && re.charClass->IsWord(0xC3);
+			if (highMember != complement) {
+				set.ranges.emplace_back(0x80, maxUnicode);
+				set.ranges.emplace_back(invalidBase + 0x80, invalidBase + 0xFF);
+			}
+		}
+	}
+
+	Node SetNode(CharacterSet &&set) {
+		Node node;
+		node.kind = Node::Kind::set;
+		node.value = static_cast<int>(re.sets.size());
+		re.sets.push_back(std::move(set));
+		return node;
+	}
+
+	Node CharacterNode(int ch) {
+		if (!caseSensitive && ch < 0x80 && ((ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z'))) {
+			CharacterSet set;
+			AddCharacter(set, ch);
+			return SetNode(std::move(set));
+		}
+		Node node;
+		node.kind = Node::Kind::character;
+		node.value = ch;
+		return node;
+	}
+
+	// Read a character that may be escaped inside a set. Returns -1 for class escapes.
+	int SetCharacter(CharacterSet &set) {
+		if (Peek() == '\\' && position + 1 < pattern.length()) {
+			position++;
+			const char escaped = Peek();
+			if (std::strchr("dDsSwW", escaped)) {
+				position++;
+				AddClass(set, escaped);
+				return -1;
+			}
+			const int value = EscapeValue(escaped);
+			if (value >= 0) {
+				position++;
+				return value;
+			}
+			if (escaped == 'x' && HexValue(Peek(1)) >= 0 && HexValue(Peek(2)) >= 0) {
+				const int byte = HexValue(Peek(1)) * 16 + HexValue(Peek(2));
+				position += 3;
+				return (re.utf8 && byte >= 0x80) ? invalidBase + byte : byte;
+			}
+		}
+		return ReadCharacter();
+	}
+
+	Node ParseSet() {
+		CharacterSet set;
+		if (Peek() == '^') {
+			set.negated = true;
+			position++;
+		}
+		bool first = true;
+		while (!AtEnd() && (first || Peek() != ']')) {
+			first = false;
+			const int ch = SetCharacter(set);
+			if (ch < 0) {
+				continue;
+			}
+			if (Peek() == '-' && Peek(1) != ']' && position + 1 < pattern.length()) {
+				const size_t dash = position;
+				position++;
+				const int last = SetCharacter(set);
+				if (last < 0) {
+					// [\d-a] form where dash is literal after a class
+					AddCharacter(set, ch);
+					AddCharacter(set, '-');
+					continue;
+				}
+				if (last < ch) {
+					position = dash;
+					error = "Invalid range in [ ]";
+					return {};
+				}
+				AddRange(set, ch, last);
+			} else {
+				AddCharacter(set, ch);
+			}
+		}
+		if (AtEnd()) {
+			error = "Missing ]";
+			return {};
+		}
+		position++;	// Skip ]
+		return SetNode(std::move(set));
+	}
+
+	[[nodiscard]] bool AtGroupEnd() const noexcept {
+		return posix ? (Peek() == ')') : (Peek() == '\\' && Peek(1) == ')');
+	}
+
+	// Parse a sequence up to the end of the pattern or the end of a group.
+	std::vector<Node> ParseSequence(bool inGroup) {
+		std::vector<Node> sequence;
+		while (!AtEnd() && !error) {
+			if (AtGroupEnd()) {
+				if (!inGroup) {
+					error = "Unmatched )";
+				}
+				break;
+			}
+			const char ch = Peek();
+			const bool quantifier = ch == '*' || ch == '+' || ch == '?';
+			// Quantifiers with nothing to repeat are literal
+			if (quantifier && !sequence.empty() && sequence.back().quantifier == Node::Quantifier::one &&
+				sequence.back().kind != Node::Kind::assertion) {
+				position++;
+				Node &previous = sequence.back();
+				previous.quantifier = (ch == '*') ? Node::Quantifier::star :
+					((ch == '+') ? Node::Quantifier::plus : Node::Quantifier::question);
+				if (Peek() == '?') {
+					previous.lazy = true;
+					position++;
+				}
+				continue;
+			}
+			if (ch == '^' && position == 0) {
+				position++;
+				Node node;
+				node.kind = Node::Kind::assertion;
+				node.value = static_cast<int>(Assertion::lineStart);
+				sequence.push_back(node);
+				continue;
+			}
+			if (ch == '$' && position == pattern.length() - 1) {
+				position++;
+				Node node;
+				node.kind = Node::Kind::assertion;
+				node.value = static_cast<int>(Assertion::lineEnd);
+				sequence.push_back(node);
+				continue;
+			}
+			if (ch == '.') {
+				position++;
+				Node node;
+				node.kind = Node::Kind::any;
+				sequence.push_back(node);
+				continue;
+			}
+			if (ch == '[') {
+				position++;
+				sequence.push_back(ParseSet());
+				continue;
+			}
+			const bool groupStart = posix ? (ch == '(') : (ch == '\\' && Peek(1) == '(');
+			if (groupStart) {
+				position += posix ? 1 : 2;
+				if (tags >= MAXTAG) {
+					error = "Too many \\(";
+					break;
+				}
+				Node node;
+				node.kind = Node::Kind::group;
+				node.value = tags++;
+				node.children = ParseSequence(true);
+				if (!error && !AtGroupEnd()) {
+					error = "Missing )";
+				}
+				position += posix ? 1 : 2;
+				sequence.push_back(std::move(node));
+				continue;
+			}
+			if (ch == '\\' && position + 1 < pattern.length()) {
+				const char escaped = Peek(1);
+				position += 2;
+				if (escaped >= '1' && escaped <= '9') {
+					error = unsupportedBackReference;
+					break;
+				}
+				if (escaped == '<' || escaped == '>') {
+					Node node;
+					node.kind = Node::Kind::assertion;
+					node.value = static_cast<int>((escaped == '<') ? Assertion::wordStart : Assertion::wordEnd);
+					sequence.push_back(node);
+					continue;
+				}
+				if (std::strchr("dDsSwW", escaped)) {
+					CharacterSet set;
+					AddClass(set, escaped);
+					sequence.push_back(SetNode(std::move(set)));
+					continue;
+				}
+				const int value = EscapeValue(escaped);
+				if (value >= 0) {
+					sequence.push_back(CharacterNode(value));
+					continue;
+				}
+				if (escaped == 'x' && HexValue(Peek()) >= 0 && HexValue(Peek(1)) >= 0) {
+					const int byte = HexValue(Peek()) * 16 + HexValue(Peek(1));
+					position += 2;
+					sequence.push_back(CharacterNode((re.utf8 && byte >= 0x80) ? invalidBase + byte : byte));
+					continue;
+				}
+				position--;	// Escaped character may be multiple bytes
+			}
+			sequence.push_back(CharacterNode(ReadCharacter()));
+		}
+		return sequence;
+	}
+
+public:
+	Parser(LinearRegex &re_, std::string_view pattern_, bool caseSensitive_, bool posix_) noexcept :
+		re(re_), pattern(pattern_), caseSensitive(caseSensitive_), posix(posix_) {
+	}
+	const char *Parse(Node &root) {
+		root.kind = Node::Kind::group;
+		root.value = 0;
+		root.children = ParseSequence(false);
+		return error;
+	}
+};
+
+LinearRegex::LinearRegex(const CharClassify *charClass_) noexcept : charClass(charClass_) {
+}
+
+void LinearRegex::ThreadList::Reset(size_t instructions) {
+	dense.clear();
+	captures.clear();
+	sparse.assign(instructions, 0);
+}
+
+bool LinearRegex::ThreadList::Contains(int pc) const noexcept {
+	const size_t index = sparse[pc];
+	return index < dense.size() && dense[index] == pc;
+}
+
+void LinearRegex::ThreadList::Add(int pc, const Captures &caps) {
+	sparse[pc] = static_cast<int>(dense.size());
+	dense.push_back(pc);
+	captures.push_back(caps);
+}
+
+void LinearRegex::Emit(const Node &node) {
+	const int start = static_cast<int>(program.size());
+	if (node.quantifier == Node::Quantifier::star || node.quantifier == Node::Quantifier::question) {
+		program.push_back({ Op::split, 0, 0 });
+	}
+	switch (node.kind) {
+	case Node::Kind::character:
+		program.push_back({ Op::character, node.value, 0 });
+		break;
+	case Node::Kind::any:
+		program.push_back({ Op::any, 0, 0 });
+		break;
+	case Node::Kind::set:
+		program.push_back({ Op::set, node.value, 0 });
+		break;
+	case Node::Kind::assertion:
+		program.push_back({ Op::assertion, node.value, 0 });
+		break;
+	case Node::Kind::group:
+		program.push_back({ Op::save, node.value * 2, 0 });
+		for (const Node &child : node.children) {
+			Emit(child);
+		}
+		program.push_back({ Op::save, node.value * 2 + 1, 0 });
+		break;
+	}
+	switch (node.quantifier) {
+	case Node::Quantifier::star: {
+			program.push_back({ Op::jump, start, 0 });
+			const int after = static_cast<int>(program.size());
+			program[start] = node.lazy ? Instruction { Op::split, after, start + 1 } : Instruction { Op::split, start + 1, after };
+		}
+		break;
+	case Node::Quantifier::question: {
+			const int after = static_cast<int>(program.size());
+			program[start] = node.lazy ? Instruction { Op::split, after, start + 1 } : Instruction { Op::split, start + 1, after };
+		}
+		break;
+	case Node::Quantifier::plus: {
+			const int after = static_cast<int>(program.size()) + 1;
+			program.push_back(node.lazy ? Instruction { Op::split, after, start } : Instruction { Op::split, start, after });
+		}
+		break;
+	case Node::Quantifier::one:
+		break;
+	}
+}
+
+const char *LinearRegex::Compile(std::string_view pattern, bool caseSensitive, bool posix, bool utf8_) {
+	utf8 = utf8_;
+	program.clear();
+	sets.clear();
+	firstByte = -1;
+
+	Node root;
+	Parser parser(*this, pattern, caseSensitive, posix);
+	const char *error = parser.Parse(root);
+	if (error) {
+		program.clear();
+		return error;
+	}
+	Emit(root);
+	program.push_back({ Op::match, 0, 0 });
+	if (program.size() > maxInstructions) {
+		program.clear();
+		return "Pattern too complex";
+	}
+
+	// When the first instruction after saving the match start is a character, only
+	// positions with its first byte need be tried.
+	size_t pc = 0;
+	while (pc < program.size() && program[pc].op == Op::save) {
+		pc++;
+	}
+	if (pc < program.size() && program[pc].op == Op::character) {
+		const int ch = program[pc].x;
+		if (ch >= invalidBase) {
+			firstByte = ch - invalidBase;
+		} else if (ch < ((utf8) ? 0x80 : 0x100)) {
+			firstByte = ch;
+		} else {
+			char bytes[UTF8MaxBytes + 1] {};
+			UTF8FromUTF32Character(ch, bytes);
+			firstByte = static_cast<unsigned char>(bytes[0]);
+		}
+	}
+
+	current.Reset(program.size());
+	next.Reset(program.size());
+	return nullptr;
+}
+
+bool LinearRegex::IsWord(std::string_view text, Sci::Position position, Sci::Position end) const noexcept {
+	// Like RESearch, treat text after the end of the range as not part of a word
+	if (position < 0 || position >= end || position >= static_cast<Sci::Position>(text.length())) {
+		return false;
+	}
+	return charClass->IsWord(static_cast<unsigned char>(text[position]));
+}
+
+bool LinearRegex::Asserted(Assertion assertion, std::string_view text, Sci::Position position, Sci::Position end) const noexcept {
+	const Sci::Position length = text.length();
+	switch (assertion) {
+	case Assertion::lineStart:
+		if (position == 0) {
+			return true;
+		} else {
+			const char chPrev = text[position - 1];
+			return (chPrev == '\n') || ((chPrev == '\r') && ((position >= length) || (text[position] != '\n')));
+		}
+	case Assertion::lineEnd:
+		if (position >= length) {
+			return true;
+		} else {
+			const char ch = text[position];
+			return (ch == '\r') || ((ch == '\n') && ((position == 0) || (text[position - 1] != '\r')));
+		}
+	case Assertion::wordStart:
+		return IsWord(text, position, end) && !IsWord(text, position - 1, end);
+	case Assertion::wordEnd:
+		return !IsWord(text, position, end) && IsWord(text, position - 1, end);
+	}
+	return false;
+}
+
+// Add the thread at pc and all threads reachable without consuming a character in priority order.
+// Instructions with a single successor update the top of the stack in place so captures
+// are only copied when a split creates a second thread.
+void LinearRegex::AddThread(ThreadList &list, int pc, const Captures &caps, std::string_view text, Sci::Position position, Sci::Position end) {
+	stack.clear();
+	stack.emplace_back(pc, caps);
+	while (!stack.empty()) {
+		auto &[pcTop, capsTop] = stack.back();
+		if (list.Contains(pcTop)) {
+			stack.pop_back();
+			continue;
+		}
+		list.Add(pcTop, capsTop);
+		const Instruction &instruction = program[pcTop];
+		switch (instruction.op) {
+		case Op::jump:
+			pcTop = instruction.x;
+			break;
+		case Op::split:
+			// Leave lower priority branch below so higher priority branch is explored first
+			pcTop = instruction.y;
+			stack.push_back(stack.back());
+			stack.back().first = instruction.x;
+			break;
+		case Op::save:
+			capsTop[instruction.x] = position;
+			pcTop++;
+			break;
+		case Op::assertion:
+			if (Asserted(static_cast<Assertion>(instruction.x), text, position, end)) {
+				pcTop++;
+			} else {
+				stack.pop_back();
+			}
+			break;
+		default:
+			stack.pop_back();
+			break;
+		}
+	}
+}
+
+// Find the leftmost match starting at or after start.
+bool LinearRegex::Next(std::string_view text, Sci::Position start, Sci::Position end, Captures &found) {
+	Captures initial;
+	initial.fill(NOTFOUND);
+	current.Clear();
+	bool matched = false;
+	Sci::Position position = start;
+	while (true) {
+		if (!matched) {
+			if (current.dense.empty() && firstByte >= 0) {
+				// No thread in progress so skip to where the first character may match
+				const void *hit = (position < end) ?
+					std::memchr(text.data() + position, firstByte, end - position) : nullptr;
+				if (!hit) {
+					return false;
+				}
+				position = static_cast<const char *>(hit) - text.data();
+			}
+			// Like RESearch, only start an empty match at the end of the range when it is a line end
+			if ((position < end) || Asserted(Assertion::lineEnd, text, position, end)) {
+				AddThread(current, 0, initial, text, position, end);
+			}
+		}
+		int width = 1;
+		int ch = 0;
+		if (position < end) {
+			ch = CharacterAt(text, position, utf8, width);
+			if (position + width > end) {
+				ch = '\n';	// Partial character can not be matched
+			}
+		}
+		next.Clear();
+		for (size_t thread = 0; thread < current.dense.size(); thread++) {
+			const int pc = current.dense[thread];
+			const Instruction &instruction = program[pc];
+			bool advance = false;
+			switch (instruction.op) {
+			case Op::match:
+				matched = true;
+				found = current.captures[thread];
+				// Lower priority threads can not produce a preferred match
+				thread = current.dense.size();
+				continue;
+			case Op::character:
+				advance = ch == instruction.x;
+				break;
+			case Op::any:
+				advance = !IsLineEnd(ch);
+				break;
+			case Op::set:
+				advance = sets[instruction.x].Contains(ch);
+				break;
+			default:
+				break;
+			}
+			if (advance && position < end) {
+				AddThread(next, pc + 1, current.captures[thread], text, position + width, end);
+			}
+		}
+		if (position >= end) {
+			break;
+		}
+		std::swap(current, next);
+		position += width;
+		if (matched && current.dense.empty()) {
+			break;
+		}
+	}
+	return matched;
+}
+
+bool LinearRegex::Execute(std::string_view text, Sci::Position start, Sci::Position end, bool findLast) {
+	bopat.fill(NOTFOUND);
+	eopat.fill(NOTFOUND);
+	if (program.empty()) {
+		return false;
+	}
+	Captures found {};
+	Captures last {};
+	bool matched = false;
+	Sci::Position position = start;
+	while (position <= end && Next(text, position, end, found)) {
+		last = found;
+		matched = true;
+		if (!findLast) {
+			break;
+		}
+		position = found[1];
+		if (found[1] == found[0]) {
+			// Step over empty match
+			if (position >= end) {
+				break;
+			}
+			int width = 1;
+			CharacterAt(text, position, utf8, width);
+			position += width;
+		}
+	}
+	if (matched) {
+		for (int tag = 0; tag < MAXTAG; tag++) {
+			bopat[tag] = last[tag * 2];
+			eopat[tag] = last[tag * 2 + 1];
+		}
+	}
+	return matched;
+}
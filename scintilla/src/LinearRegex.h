@@ -0,0 +1,91 @@
+// Scintilla source code edit control
+/** @file LinearRegex.h
+ ** Regular expression search that takes time proportional to the length of the text.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef LINEARREGEX_H
+#define LINEARREGEX_H
+
+namespace Scintilla::Internal {
+
+/**
+ * Compiles the same syntax as RESearch, apart from back references, into an automaton
+ * which is run by advancing every possible state together over each character.
+ * Unlike RESearch and std::regex there is no backtracking so patterns like \(a*\)*b
+ * can not take exponential time.
+ * Text is read from memory directly instead of through CharacterIndexer so
+ * is either single byte or UTF-8. As with RESearch, matches do not cross line ends.
+ */
+class LinearRegex {
+public:
+	static constexpr int MAXTAG = 10;
+	static constexpr Sci::Position NOTFOUND = -1;
+	// Returned by Compile for back references which require backtracking
+	static const char *const unsupportedBackReference;
+
+	using MatchPositions = std::array<Sci::Position, MAXTAG>;
+	MatchPositions bopat {};
+	MatchPositions eopat {};
+
+	explicit LinearRegex(const CharClassify *charClass_) noexcept;
+
+	// Returns nullptr on success or an error message.
+	const char *Compile(std::string_view pattern, bool caseSensitive, bool posix, bool utf8);
+
+	// Search text for the first match, or the last when findLast, starting in [start, end].
+	// Text before start and after end is only examined by ^, $, \< and \>.
+	// Text must start at a line start and end at a line end.
+	// Positions in bopat and eopat are relative to the start of text.
+	bool Execute(std::string_view text, Sci::Position start, Sci::Position end, bool findLast);
+
+private:
+	enum class Op { character, any, set, split, jump, save, assertion, match };
+	enum class Assertion { lineStart, lineEnd, wordStart, wordEnd };
+	struct Instruction {
+		Op op;
+		int x;
+		int y;
+	};
+	struct CharacterSet {
+		std::array<bool, 256> bytes {};
+		std::vector<std::pair<int, int>> ranges;	// Inclusive ranges of characters above 0x7F in UTF-8
+		bool negated = false;
+		[[nodiscard]] bool Contains(int ch) const noexcept;
+	};
+	struct Node;
+	class Parser;
+	using Captures = std::array<Sci::Position, MAXTAG * 2>;
+	struct ThreadList {
+		std::vector<int> dense;	// Instruction indices in priority order
+		std::vector<int> sparse;	// Position of each instruction in dense
+		std::vector<Captures> captures;
+		void Reset(size_t instructions);
+		void Clear() noexcept {
+			dense.clear();
+			captures.clear();
+		}
+		[[nodiscard]] bool Contains(int pc) const noexcept;
+		void Add(int pc, const Captures &caps);
+	};
+
+	const CharClassify *charClass;
+	bool utf8 = false;
+	std::vector<Instruction> program;
+	std::vector<CharacterSet> sets;
+	int firstByte = -1;	// When every match must start with this byte
+	ThreadList current;
+	ThreadList next;
+	std::vector<std::pair<int, Captures>> stack;	// Reused by AddThread
+
+	void Emit(const Node &node);
+	[[nodiscard]] bool IsWord(std::string_view text, Sci::Position position, Sci::Position end) const noexcept;
+	[[nodiscard]] bool Asserted(Assertion assertion, std::string_view text, Sci::Position position, Sci::Position end) const noexcept;
+	void AddThread(ThreadList &list, int pc, const Captures &caps, std::string_view text, Sci::Position position, Sci::Position end);
+	bool Next(std::string_view text, Sci::Position start, Sci::Position end, Captures &found);
+};
+
+}
+
+#endif
@@ -159,6 +159,17 @@ public:
 		body.Delete(partition);
 	}
 
+	void RemovePartitions(T partition, T count) {
+		if (partition > stepPartition) {
+			ApplyStep(partition);
+			stepPartition--;
+		} else {
+			// Partitions after the step that are removed no longer need it applied
+			stepPartition = std::max(partition - 1, stepPartition - count);
+		}
+		body.DeleteRange(partition, count);
+	}
+
 	T PositionFromPartition(T partition) const noexcept {
 		PLATFORM_ASSERT(partition >= 0);
 		PLATFORM_ASSERT(partition < body.Length());
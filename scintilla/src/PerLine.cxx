@@ -117,6 +117,24 @@ void LineMarkers::RemoveLine(Sci::Line line) {
 	}
 }
 
+void LineMarkers::RemoveLines(Sci::Line line, Sci::Line lines) {
+	if (markers.Length()) {
+		if (line > 0) {
+			for (Sci::Line lineRemove = line; lineRemove < line + lines; lineRemove++) {
+				if (markers[lineRemove]) {
+					if (!markers[line - 1])
+						markers[line - 1] = std::make_unique<MarkerHandleSet>();
+					markers[line - 1]->CombineWith(markers[lineRemove].get());
+				}
+			}
+		}
+		for (Sci::Line lineRemove = line; lineRemove < line + lines; lineRemove++) {
+			markers[lineRemove].reset();
+		}
+		markers.DeleteRange(line, lines);
+	}
+}
+
 Sci::Line LineMarkers::LineFromHandle(int markerHandle) const noexcept {
 	for (Sci::Line line = 0; line < markers.Length(); line++) {
 		if (markers[line] && markers[line]->Contains(markerHandle)) {
@@ -245,6 +263,21 @@ void LineLevels::RemoveLine(Sci::Line line) {
 	}
 }
 
+void LineLevels::RemoveLines(Sci::Line line, Sci::Line lines) {
+	if (levels.Length()) {
+		// Same as RemoveLine for each line so merge header flag from any removed line
+		int firstHeader = 0;
+		for (Sci::Line lineRemove = line; lineRemove < line + lines; lineRemove++) {
+			firstHeader |= levels[lineRemove] & static_cast<int>(Scintilla::FoldLevel::HeaderFlag);
+		}
+		levels.DeleteRange(line, lines);
+		if (line == levels.Length()-1) // Last line loses the header flag
+			levels[line-1] &= ~static_cast<int>(Scintilla::FoldLevel::HeaderFlag);
+		else if (line > 0)
+			levels[line-1] |= firstHeader;
+	}
+}
+
 void LineLevels::ExpandLevels(Sci::Line sizeNew) {
 	levels.InsertValue(levels.Length(), sizeNew - levels.Length(), static_cast<int>(Scintilla::FoldLevel::Base));
 }
@@ -316,6 +349,12 @@ void LineState::RemoveLine(Sci::Line line) {
 	}
 }
 
+void LineState::RemoveLines(Sci::Line line, Sci::Line lines) {
+	if (lineStates.Length() > line) {
+		lineStates.DeleteRange(line, std::min(lines, lineStates.Length() - line));
+	}
+}
+
 int LineState::SetLineState(Sci::Line line, int state, Sci::Line lines) {
 	int stateOld = state;
 	if ((line >= 0) && (line < lines)) {
@@ -390,6 +429,18 @@ void LineAnnotation::RemoveLine(Sci::Line line) {
 	}
 }
 
+void LineAnnotation::RemoveLines(Sci::Line line, Sci::Line lines) {
+	if (annotations.Length() && (line > 0) && (line <= annotations.Length())) {
+		// As RemoveLine, each removal drops the annotation of the line before
+		const Sci::Line lineFirst = line - 1;
+		const Sci::Line removals = std::min(lines, annotations.Length() - lineFirst);
+		for (Sci::Line lineRemove = lineFirst; lineRemove < lineFirst + removals; lineRemove++) {
+			annotations[lineRemove].reset();
+		}
+		annotations.DeleteRange(lineFirst, removals);
+	}
+}
+
 bool LineAnnotation::MultipleStyles(Sci::Line line) const noexcept {
 	if (annotations.Length() && (line >= 0) && (line < annotations.Length()) && annotations[line])
 		return reinterpret_cast<AnnotationHeader *>(annotations[line].get())->style == IndividualStyles;
@@ -510,6 +561,16 @@ void LineTabstops::RemoveLine(Sci::Line line) {
 	}
 }
 
+void LineTabstops::RemoveLines(Sci::Line line, Sci::Line lines) {
+	if (tabstops.Length() > line) {
+		const Sci::Line removals = std::min(lines, tabstops.Length() - line);
+		for (Sci::Line lineRemove = line; lineRemove < line + removals; lineRemove++) {
+			tabstops[lineRemove].reset();
+		}
+		tabstops.DeleteRange(line, removals);
+	}
+}
+
 bool LineTabstops::ClearTabstops(Sci::Line line) noexcept {
 	if (line < tabstops.Length()) {
 		TabstopList *tl = tabstops[line].get();
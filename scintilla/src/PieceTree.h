@@ -0,0 +1,516 @@
+// Scintilla source code edit control
+/** @file PieceTree.h
+ ** Array held as a balanced tree of pieces so that insertions and deletions
+ ** anywhere are fast for very large arrays.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef PIECETREE_H
+#define PIECETREE_H
+
+namespace Scintilla::Internal {
+
+/**
+ * Alternative to SplitVector for very large documents.
+ * Elements are held in append-only blocks and the array is the in-order sequence of
+ * pieces (runs of elements in a block) in a treap where each node caches the number of
+ * elements in its subtree. Insertion and deletion are O(log pieces) wherever they occur
+ * instead of moving the elements between the gap and the change.
+ * Deleted elements are not reclaimed until the array is consolidated into a single
+ * block which happens when a contiguous view of the whole array is needed or when
+ * too much storage or too many pieces accumulate.
+ * Appended elements go into blocks of a fixed size so the allocation when a block fills
+ * does not grow with the array.
+ */
+template <typename T>
+class PieceTree {
+	static constexpr int none = -1;
+	struct Node {
+		T *data = nullptr;
+		ptrdiff_t length = 0;	// Elements in this piece
+		ptrdiff_t total = 0;	// Elements in this subtree
+		uint32_t priority = 0;
+		int left = none;
+		int right = none;
+	};
+	std::vector<Node> nodes;
+	std::vector<int> freeNodes;
+	int root = none;
+	size_t pieces = 0;
+
+	std::vector<std::unique_ptr<T[]>> blocks;
+	T *appendPoint = nullptr;	// Where the next insertion will be copied
+	ptrdiff_t appendSpace = 0;
+	ptrdiff_t allocated = 0;	// Sum of block sizes
+	ptrdiff_t lengthBody = 0;
+	T empty {};
+	uint32_t seed = 0x9E3779B9U;
+
+	// The piece most recently found by position is remembered so sequential access is fast.
+	// Layout reads the document from several threads so each thread has its own slots,
+	// identified by tree and by a version that changes whenever the pieces change.
+	struct Located {
+		const PieceTree *owner = nullptr;
+		uint64_t version = 0;
+		ptrdiff_t start = 0;
+		ptrdiff_t length = 0;
+		T *data = nullptr;
+	};
+	static constexpr size_t locatedSlots = 4;
+	static inline std::atomic<uint64_t> versionLast {0};
+	uint64_t version = ++versionLast;
+
+	static constexpr ptrdiff_t blockGrow = 64 * 1024;
+	static constexpr ptrdiff_t reclaimMinimum = 1024 * 1024;
+	static constexpr size_t piecesMinimum = 4096;
+
+	uint32_t NextPriority() noexcept {
+		// xorshift32
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		return seed;
+	}
+
+	ptrdiff_t Total(int node) const noexcept {
+		return (node == none) ? 0 : nodes[node].total;
+	}
+
+	void Update(int node) noexcept {
+		Node &n = nodes[node];
+		n.total = Total(n.left) + n.length + Total(n.right);
+	}
+
+	int NewNode(T *data, ptrdiff_t length) {
+		int node = none;
+		if (freeNodes.empty()) {
+			node = static_cast<int>(nodes.size());
+			nodes.emplace_back();
+		} else {
+			node = freeNodes.back();
+			freeNodes.pop_back();
+		}
+		Node &n = nodes[node];
+		n.data = data;
+		n.length = length;
+		n.total = length;
+		n.priority = NextPriority();
+		n.left = none;
+		n.right = none;
+		pieces++;
+		return node;
+	}
+
+	void FreeSubtree(int node) {
+		if (node != none) {
+			FreeSubtree(nodes[node].left);
+			FreeSubtree(nodes[node].right);
+			freeNodes.push_back(node);
+			pieces--;
+		}
+	}
+
+	int Merge(int a, int b) noexcept {
+		if (a == none)
+			return b;
+		if (b == none)
+			return a;
+		if (nodes[a].priority > nodes[b].priority) {
+			nodes[a].right = Merge(nodes[a].right, b);
+			Update(a);
+			return a;
+		}
+		nodes[b].left = Merge(a, nodes[b].left);
+		Update(b);
+		return b;
+	}
+
+	// Split tree into the first position elements and the remainder.
+	// May split one piece so allocates a node.
+	void Split(int node, ptrdiff_t position, int &left, int &right) {
+		if (node == none) {
+			left = none;
+			right = none;
+			return;
+		}
+		const ptrdiff_t leftTotal = Total(nodes[node].left);
+		const ptrdiff_t nodeEnd = leftTotal + nodes[node].length;
+		if (position <= leftTotal) {
+			int leftOfLeft = none;
+			int rightOfLeft = none;
+			Split(nodes[node].left, position, leftOfLeft, rightOfLeft);
+			nodes[node].left = rightOfLeft;
+			Update(node);
+			left = leftOfLeft;
+			right = node;
+		} else if (position >= nodeEnd) {
+			int leftOfRight = none;
+			int rightOfRight = none;
+			Split(nodes[node].right, position - nodeEnd, leftOfRight, rightOfRight);
+			nodes[node].right = leftOfRight;
+			Update(node);
+			left = node;
+			right = rightOfRight;
+		} else {
+			// Split inside this piece: node keeps the start and its left subtree
+			const ptrdiff_t offset = position - leftTotal;
+			const int tail = NewNode(nodes[node].data + offset, nodes[node].length - offset);
+			const int rightSubtree = nodes[node].right;
+			nodes[node].length = offset;
+			nodes[node].right = none;
+			Update(node);
+			left = node;
+			right = Merge(tail, rightSubtree);
+		}
+	}
+
+	// Find the piece containing position which must be in [0, lengthBody),
+	// reusing this thread's remembered piece when it contains position.
+	const Located &Locate(ptrdiff_t position) const noexcept {
+		thread_local std::array<Located, locatedSlots> slots {};
+		thread_local size_t slotNext = 0;
+		Located *slot = nullptr;
+		for (Located &candidate : slots) {
+			if (candidate.owner == this) {
+				slot = &candidate;
+				break;
+			}
+		}
+		if (slot) {
+			if (slot->version == version && position >= slot->start && position < slot->start + slot->length) {
+				return *slot;
+			}
+		} else {
+			slot = &slots[slotNext];
+			slotNext = (slotNext + 1) % locatedSlots;
+			slot->owner = this;
+		}
+		slot->version = version;
+		slot->start = 0;
+		slot->length = 0;
+		slot->data = nullptr;
+		int node = root;
+		ptrdiff_t start = 0;
+		while (node != none) {
+			const Node &n = nodes[node];
+			const ptrdiff_t leftTotal = Total(n.left);
+			if (position < start + leftTotal) {
+				node = n.left;
+			} else if (position < start + leftTotal + n.length) {
+				slot->start = start + leftTotal;
+				slot->length = n.length;
+				slot->data = n.data;
+				break;
+			} else {
+				start += leftTotal + n.length;
+				node = n.right;
+			}
+		}
+		return *slot;
+	}
+
+	// Pieces have changed so every thread's remembered piece for this tree is stale.
+	void InvalidateCache() noexcept {
+		version = ++versionLast;
+	}
+
+	template <typename F>
+	bool VisitSegments(int node, ptrdiff_t nodeStart, ptrdiff_t position, ptrdiff_t end, F &f) const {
+		if (node == none || position >= end)
+			return true;
+		const Node &n = nodes[node];
+		const ptrdiff_t leftTotal = Total(n.left);
+		const ptrdiff_t pieceStart = nodeStart + leftTotal;
+		const ptrdiff_t pieceEnd = pieceStart + n.length;
+		if (position < pieceStart) {
+			if (!VisitSegments(n.left, nodeStart, position, end, f))
+				return false;
+		}
+		if (position < pieceEnd && end > pieceStart) {
+			const ptrdiff_t segmentStart = std::max(position, pieceStart);
+			const ptrdiff_t segmentEnd = std::min(end, pieceEnd);
+			if (!f(n.data + segmentStart - pieceStart, segmentEnd - segmentStart, segmentStart))
+				return false;
+		}
+		if (end > pieceEnd) {
+			return VisitSegments(n.right, pieceEnd, position, end, f);
+		}
+		return true;
+	}
+
+	// Make space for at least length elements at appendPoint.
+	void RoomFor(ptrdiff_t length) {
+		if (appendSpace < length) {
+			const ptrdiff_t size = std::max(length, blockGrow);
+			blocks.push_back(std::make_unique<T[]>(size));
+			appendPoint = blocks.back().get();
+			appendSpace = size;
+			allocated += size;
+		}
+	}
+
+	// Insert a piece that has been written at appendPoint.
+	void InsertAppended(ptrdiff_t position, ptrdiff_t insertLength) {
+		T *data = appendPoint;
+		appendPoint += insertLength;
+		appendSpace -= insertLength;
+		lengthBody += insertLength;
+		InvalidateCache();
+		if (position > 0 && ExtendPiece(position, data, insertLength)) {
+			return;
+		}
+		int left = none;
+		int right = none;
+		Split(root, position, left, right);
+		root = Merge(Merge(left, NewNode(data, insertLength)), right);
+	}
+
+	// When the piece ending at position is immediately followed in its block by data,
+	// as happens when typing, extend that piece instead of adding a new one.
+	bool ExtendPiece(ptrdiff_t position, const T *data, ptrdiff_t insertLength) noexcept {
+		int node = root;
+		ptrdiff_t start = 0;
+		while (node != none) {
+			const Node &n = nodes[node];
+			const ptrdiff_t leftTotal = Total(n.left);
+			const ptrdiff_t pieceEnd = start + leftTotal + n.length;
+			if (position <= start + leftTotal) {
+				node = n.left;
+			} else if (position <= pieceEnd) {
+				if (position != pieceEnd || (n.data + n.length) != data)
+					return false;
+				break;
+			} else {
+				start = pieceEnd;
+				node = n.right;
+			}
+		}
+		if (node == none)
+			return false;
+		// Descend again adding to each total on the path
+		node = root;
+		start = 0;
+		while (node != none) {
+			Node &n = nodes[node];
+			n.total += insertLength;
+			const ptrdiff_t leftTotal = Total(n.left);
+			const ptrdiff_t pieceEnd = start + leftTotal + n.length;
+			if (position <= start + leftTotal) {
+				node = n.left;
+			} else if (position <= pieceEnd) {
+				n.length += insertLength;
+				return true;
+			} else {
+				start = pieceEnd;
+				node = n.right;
+			}
+		}
+		return true;
+	}
+
+	void ReclaimIfWasteful() {
+		// Space not yet appended to, such as that reserved by ReAllocate, is not waste
+		if ((allocated - appendSpace > 2 * lengthBody + reclaimMinimum) ||
+			(pieces > std::max(piecesMinimum, static_cast<size_t>(lengthBody / 64)))) {
+			Consolidate(0);
+		}
+	}
+
+public:
+	PieceTree() = default;
+	// Deleted so PieceTree objects can not be copied.
+	PieceTree(const PieceTree &) = delete;
+	PieceTree(PieceTree &&) = delete;
+	PieceTree &operator=(const PieceTree &) = delete;
+	PieceTree &operator=(PieceTree &&) = delete;
+	~PieceTree() = default;
+
+	/// Release all storage.
+	void DeleteAll() noexcept {
+		nodes.clear();
+		freeNodes.clear();
+		root = none;
+		pieces = 0;
+		blocks.clear();
+		appendPoint = nullptr;
+		appendSpace = 0;
+		allocated = 0;
+		lengthBody = 0;
+		InvalidateCache();
+	}
+
+	ptrdiff_t Length() const noexcept {
+		return lengthBody;
+	}
+
+	/// Number of pieces currently in the tree.
+	size_t Pieces() const noexcept {
+		return pieces;
+	}
+
+	/// Ensure the next appended elements up to newSize total do not need another block.
+	/// This allows loading a file to produce a single piece.
+	/// An extra element is reserved so BufferPointer can terminate that piece in place.
+	void ReAllocate(ptrdiff_t newSize) {
+		if (newSize > lengthBody) {
+			RoomFor(newSize - lengthBody + 1);
+		}
+	}
+
+	/// Retrieving positions outside the range of the array returns empty.
+	const T &ValueAt(ptrdiff_t position) const noexcept {
+		if (position < 0 || position >= lengthBody) {
+			return empty;
+		}
+		const Located &located = Locate(position);
+		return located.data[position - located.start];
+	}
+
+	/// Return a pointer to position and set segmentLength to the number of elements from
+	/// there to the end of its piece so the array can be read in place one piece at a time.
+	const T *SegmentPointer(ptrdiff_t position, ptrdiff_t &segmentLength) const noexcept {
+		if (position < 0 || position >= lengthBody) {
+			segmentLength = 0;
+			return &empty;
+		}
+		const Located &located = Locate(position);
+		segmentLength = located.start + located.length - position;
+		return located.data + position - located.start;
+	}
+
+	/// Call f(pointer, length, position) for each contiguous segment of a range.
+	/// f returns false to stop.
+	template <typename F>
+	void ForEachSegment(ptrdiff_t position, ptrdiff_t length, F f) const {
+		position = std::max<ptrdiff_t>(position, 0);
+		const ptrdiff_t end = std::min(position + length, lengthBody);
+		VisitSegments(root, 0, position, end, f);
+	}
+
+	void GetRange(T *buffer, ptrdiff_t position, ptrdiff_t retrieveLength) const {
+		ForEachSegment(position, retrieveLength, [&buffer](const T *segment, ptrdiff_t length, ptrdiff_t) {
+			std::copy_n(segment, length, buffer);
+			buffer += length;
+			return true;
+		});
+	}
+
+	void InsertFromArray(ptrdiff_t positionToInsert, const T s[], ptrdiff_t positionFrom, ptrdiff_t insertLength) {
+		if (insertLength > 0 && positionToInsert >= 0 && positionToInsert <= lengthBody) {
+			RoomFor(insertLength);
+			std::copy_n(s + positionFrom, insertLength, appendPoint);
+			InsertAppended(positionToInsert, insertLength);
+			ReclaimIfWasteful();
+		}
+	}
+
+	void InsertValue(ptrdiff_t position, ptrdiff_t insertLength, T v) {
+		if (insertLength > 0 && position >= 0 && position <= lengthBody) {
+			RoomFor(insertLength);
+			std::fill_n(appendPoint, insertLength, v);
+			InsertAppended(position, insertLength);
+			ReclaimIfWasteful();
+		}
+	}
+
+	void DeleteRange(ptrdiff_t position, ptrdiff_t deleteLength) {
+		if ((position < 0) || (deleteLength <= 0) || ((position + deleteLength) > lengthBody)) {
+			return;
+		}
+		if ((position == 0) && (deleteLength == lengthBody)) {
+			DeleteAll();
+			return;
+		}
+		InvalidateCache();
+		int left = none;
+		int middle = none;
+		int right = none;
+		Split(root, position, left, right);
+		Split(right, deleteLength, middle, right);
+		FreeSubtree(middle);
+		root = Merge(left, right);
+		lengthBody -= deleteLength;
+		ReclaimIfWasteful();
+	}
+
+	/// Copy all elements into one new block followed by an empty element and extra space
+	/// for future insertions, discarding old blocks.
+	void Consolidate(ptrdiff_t extra) {
+		const ptrdiff_t size = lengthBody + 1 + std::max(extra, blockGrow);
+		std::unique_ptr<T[]> block = std::make_unique<T[]>(size);
+		GetRange(block.get(), 0, lengthBody);
+		nodes.clear();
+		freeNodes.clear();
+		pieces = 0;
+		blocks.clear();
+		T *data = block.get();
+		blocks.push_back(std::move(block));
+		allocated = size;
+		root = (lengthBody > 0) ? NewNode(data, lengthBody) : none;
+		// Leave an empty element after the end for BufferPointer
+		appendPoint = data + lengthBody + 1;
+		appendSpace = size - lengthBody - 1;
+		InvalidateCache();
+	}
+
+	/// Consolidate if needed and return a pointer to the first element.
+	/// Also ensures there is an empty element beyond logical end in case it is
+	/// passed to a function expecting a NUL terminated string.
+	T *BufferPointer() {
+		// A single piece can be used in place when the element after it is unused: either
+		// the one left by Consolidate or the next free element in the same block.
+		const bool inPlace = (lengthBody > 0) && (pieces == 1) &&
+			((appendPoint == nodes[root].data + lengthBody + 1) ||
+			((appendPoint == nodes[root].data + lengthBody) && (appendSpace > 0)));
+		if (!inPlace) {
+			Consolidate(0);
+		}
+		if (lengthBody == 0) {
+			return blocks.back().get();
+		}
+		T *data = nodes[root].data;
+		data[lengthBody] = T();
+		return data;
+	}
+
+	/// Return a pointer to a range of elements, first copying the range into a
+	/// single piece if it spans pieces.
+	T *RangePointer(ptrdiff_t position, ptrdiff_t rangeLength) noexcept {
+		if (lengthBody == 0) {
+			return nullptr;
+		}
+		if (position >= lengthBody) {
+			// Pointer to end
+			const Located &last = Locate(lengthBody - 1);
+			return last.data + last.length;
+		}
+		const Located &located = Locate(position);
+		if (position + rangeLength <= located.start + located.length) {
+			return located.data + position - located.start;
+		}
+		try {
+			rangeLength = std::min(rangeLength, lengthBody - position);
+			RoomFor(rangeLength);
+			GetRange(appendPoint, position, rangeLength);
+			T *data = appendPoint;
+			appendPoint += rangeLength;
+			appendSpace -= rangeLength;
+			InvalidateCache();
+			int left = none;
+			int middle = none;
+			int right = none;
+			Split(root, position, left, right);
+			Split(right, rangeLength, middle, right);
+			FreeSubtree(middle);
+			root = Merge(Merge(left, NewNode(data, rangeLength)), right);
+			return data;
+		} catch (...) {
+			return nullptr;
+		}
+	}
+};
+
+}
+
+#endif
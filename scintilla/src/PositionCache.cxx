@@ -76,7 +76,8 @@ void LineLayout::Resize(int maxLineLength_) {
 		styles = std::make_unique<unsigned char []>(lineAllocation);
 		// Extra position allocated as sometimes the Windows
 		// GetTextExtentExPoint API writes an extra element.
-		positions = std::make_unique<XYPOSITION []>(lineAllocation + 1);
+		// Allocated by ClearPositions as lines laid out in chunks do not use positions.
+		positions.reset();
 		lineStarts.reset();
 		bidiData.reset();
 		lenLineStarts = 0;
@@ -99,7 +100,48 @@ void LineLayout::EnsureBidiData() {
 }
 
 void LineLayout::ClearPositions() {
-	std::fill(&positions[0], &positions[maxLineLength + 2], 0.0f);
+	if (!positions) {
+		// Extra position allocated as sometimes the Windows
+		// GetTextExtentExPoint API writes an extra element.
+		positions = std::make_unique<XYPOSITION []>(maxLineLength + 2);
+	} else {
+		std::fill(&positions[0], &positions[maxLineLength + 2], 0.0f);
+	}
+	ClearChunks();
+}
+
+void LineLayout::ClearChunks() noexcept {
+	chunkStarts.clear();
+	chunkBases.clear();
+	chunkPositions.clear();
+}
+
+bool LineLayout::Chunked() const noexcept {
+	return !chunkStarts.empty();
+}
+
+size_t LineLayout::ChunkFromPosition(Sci::Position index) const noexcept {
+	const auto it = std::upper_bound(chunkStarts.begin(), chunkStarts.end() - 1, index);
+	return std::max<ptrdiff_t>(it - chunkStarts.begin() - 1, 0);
+}
+
+// Position of the character at index. For lines laid out in chunks this is resolved from
+// the chunk's base and either its measured positions or a proportion of its width.
+XYPOSITION LineLayout::XPosition(Sci::Position index) const noexcept {
+	if (chunkStarts.empty()) {
+		return positions[index];
+	}
+	if (index >= numCharsInLine) {
+		return chunkBases.back();
+	}
+	const size_t chunk = ChunkFromPosition(index);
+	const int start = chunkStarts[chunk];
+	const XYPOSITION base = chunkBases[chunk];
+	if (chunkPositions[chunk]) {
+		return base + chunkPositions[chunk][index - start];
+	}
+	const int length = chunkStarts[chunk + 1] - start;
+	return base + (chunkBases[chunk + 1] - base) * static_cast<XYPOSITION>(index - start) / length;
 }
 
 void LineLayout::Invalidate(ValidLevel validity_) noexcept {
@@ -228,7 +270,7 @@ int LineLayout::FindBefore(XYPOSITION x, Range range) const noexcept {
 	Sci::Position upper = range.end;
 	do {
 		const Sci::Position middle = (upper + lower + 1) / 2; 	// Round high
-		const XYPOSITION posMiddle = positions[middle];
+		const XYPOSITION posMiddle = XPosition(middle);
 		if (x < posMiddle) {
 			upper = middle - 1;
 		} else {
@@ -243,11 +285,11 @@ int LineLayout::FindPositionFromX(XYPOSITION x, Range range, bool charPosition)
 	int pos = FindBefore(x, range);
 	while (pos < range.end) {
 		if (charPosition) {
-			if (x < (positions[pos + 1])) {
+			if (x < XPosition(pos + 1)) {
 				return pos;
 			}
 		} else {
-			if (x < ((positions[pos] + positions[pos + 1]) / 2)) {
+			if (x < ((XPosition(pos) + XPosition(pos + 1)) / 2)) {
 				return pos;
 			}
 		}
@@ -263,13 +305,13 @@ Point LineLayout::PointFromPosition(int posInLine, int lineHeight, PointEnd pe)
 		if (posInLine >= rangeSubLine.start) {
 			pt.y = static_cast<XYPOSITION>(subLine*lineHeight);
 			if (posInLine <= rangeSubLine.end) {
-				pt.x = positions[posInLine] - positions[rangeSubLine.start];
+				pt.x = XPosition(posInLine) - XPosition(rangeSubLine.start);
 				if (rangeSubLine.start != 0)	// Wrapped lines may be indented
 					pt.x += wrapIndent;
 				if (FlagSet(pe, PointEnd::subLineEnd))	// Return end of first subline not start of next
 					break;
 			} else if (FlagSet(pe, PointEnd::lineEnd) && (subLine == (lines-1))) {
-				pt.x = positions[numCharsInLine] - positions[rangeSubLine.start];
+				pt.x = XPosition(numCharsInLine) - XPosition(rangeSubLine.start);
 				if (rangeSubLine.start != 0)	// Wrapped lines may be indented
 					pt.x += wrapIndent;
 			}
@@ -284,13 +326,13 @@ XYPOSITION LineLayout::XInLine(Sci::Position index) const noexcept {
 	// For positions inside line return value from positions
 	// For positions after line return last position + 1.0
 	if (index <= numCharsInLine) {
-		return positions[index];
+		return XPosition(index);
 	}
-	return positions[numCharsInLine] + 1.0;
+	return XPosition(numCharsInLine) + 1.0;
 }
 
 Interval LineLayout::Span(int start, int end) const noexcept {
-	return { positions[start], positions[end] };
+	return { XPosition(start), XPosition(end) };
 }
 
 Interval LineLayout::SpanByte(int index) const noexcept {
@@ -959,10 +1001,12 @@ bool BreakFinder::More() const noexcept {
 	return (subBreak >= 0) || (nextBreak < lineRange.end);
 }
 
+// Entries are keyed by font identity instead of style number so they stay valid when
+// styles change and can be used by every view that shares the cache.
 class PositionCacheEntry {
-	uint16_t styleNumber = 0;
+	unsigned int fontIdentity = 0;
 	uint16_t len = 0;
-	uint16_t clock = 0;
+	uint32_t clock = 0;
 	bool unicode = false;
 	std::unique_ptr<XYPOSITION[]> positions;
 public:
@@ -974,19 +1018,41 @@ public:
 	void operator=(const PositionCacheEntry &) = delete;
 	void operator=(PositionCacheEntry &&) = delete;
 	~PositionCacheEntry();
-	void Set(unsigned int styleNumber_, bool unicode_, std::string_view sv, const XYPOSITION *positions_, uint16_t clock_);
+	void Set(unsigned int fontIdentity_, bool unicode_, std::string_view sv, const XYPOSITION *positions_, uint32_t clock_);
 	void Clear() noexcept;
-	bool Retrieve(unsigned int styleNumber_, bool unicode_, std::string_view sv, XYPOSITION *positions_) const noexcept;
-	static size_t Hash(unsigned int styleNumber_, bool unicode_, std::string_view sv) noexcept;
+	bool Retrieve(unsigned int fontIdentity_, bool unicode_, std::string_view sv, XYPOSITION *positions_) const noexcept;
+	static size_t Hash(unsigned int fontIdentity_, bool unicode_, std::string_view sv) noexcept;
+	[[nodiscard]] bool Empty() const noexcept;
 	[[nodiscard]] bool NewerThan(const PositionCacheEntry &other) const noexcept;
+	void Touch(uint32_t clock_) noexcept;
 	void ResetClock() noexcept;
 };
 
-class PositionCache : public IPositionCache {
-	std::vector<PositionCacheEntry> pces{ positionCacheDefaultSize };
+// Each string is stored in one of positionCacheWays entries of a set so that
+// a few strings with the same hash do not keep displacing each other.
+constexpr size_t positionCacheWays = 4;
+// The cache is split into shards, each with its own lock, so that layout threads
+// measuring different strings rarely wait for each other.
+constexpr size_t positionCacheShardsMaximum = 16;
+constexpr size_t positionCacheSetsPerShardMinimum = 8;
+
+// A shard is a set associative cache that replaces the least recently used entry of a set.
+struct PositionCacheShard {
 	std::mutex mutex;
-	uint16_t clock = 1;
+	std::vector<PositionCacheEntry> pces;
+	uint32_t clock = 1;
 	bool allClear = true;
+	PositionCacheStatistics statistics;
+	void Clear() noexcept;
+	uint32_t Tick() noexcept;
+};
+
+class PositionCache : public IPositionCache {
+	size_t size = 0;
+	size_t ways = 0;
+	size_t setsPerShard = 0;
+	size_t shardCount = 0;
+	std::unique_ptr<PositionCacheShard[]> shards;
 public:
 	PositionCache();
 	// Deleted so PositionCache objects can not be copied.
@@ -1001,13 +1067,15 @@ public:
 	[[nodiscard]] size_t GetSize() const noexcept override;
 	void MeasureWidths(Surface *surface, const ViewStyle &vstyle, unsigned int styleNumber,
 		bool unicode, std::string_view sv, XYPOSITION *positions, bool needsLocking) override;
+	[[nodiscard]] PositionCacheStatistics Statistics() override;
+	void ClearStatistics() override;
 };
 
 PositionCacheEntry::PositionCacheEntry() noexcept = default;
 
 // Copy constructor not currently used, but needed for being element in std::vector.
 PositionCacheEntry::PositionCacheEntry(const PositionCacheEntry &other) :
-	styleNumber(other.styleNumber), len(other.len), clock(other.clock), unicode(other.unicode) {
+	fontIdentity(other.fontIdentity), len(other.len), clock(other.clock), unicode(other.unicode) {
 	if (other.positions) {
 		const size_t lenData = len + (len / sizeof(XYPOSITION)) + 1;
 		positions = std::make_unique<XYPOSITION[]>(lenData);
@@ -1015,10 +1083,10 @@ PositionCacheEntry::PositionCacheEntry(const PositionCacheEntry &other) :
 	}
 }
 
-void PositionCacheEntry::Set(unsigned int styleNumber_, bool unicode_, std::string_view sv,
-	const XYPOSITION *positions_, uint16_t clock_) {
+void PositionCacheEntry::Set(unsigned int fontIdentity_, bool unicode_, std::string_view sv,
+	const XYPOSITION *positions_, uint32_t clock_) {
 	Clear();
-	styleNumber = static_cast<uint16_t>(styleNumber_);
+	fontIdentity = fontIdentity_;
 	len = static_cast<uint16_t>(sv.length());
 	clock = clock_;
 	unicode = unicode_;
@@ -1037,14 +1105,14 @@ PositionCacheEntry::~PositionCacheEntry() {
 
 void PositionCacheEntry::Clear() noexcept {
 	positions.reset();
-	styleNumber = 0;
+	fontIdentity = 0;
 	len = 0;
 	clock = 0;
 }
 
-bool PositionCacheEntry::Retrieve(unsigned int styleNumber_, bool unicode_, std::string_view sv, XYPOSITION *positions_) const noexcept {
-	if ((styleNumber == styleNumber_) && (unicode == unicode_) && (len == sv.length()) &&
-		(memcmp(&positions[len], sv.data(), sv.length())== 0)) {
+bool PositionCacheEntry::Retrieve(unsigned int fontIdentity_, bool unicode_, std::string_view sv, XYPOSITION *positions_) const noexcept {
+	if ((fontIdentity == fontIdentity_) && (unicode == unicode_) && (len == sv.length()) &&
+		positions && (memcmp(&positions[len], sv.data(), sv.length())== 0)) {
 		for (unsigned int i=0; i<len; i++) {
 			positions_[i] = positions[i];
 		}
@@ -1053,25 +1121,31 @@ bool PositionCacheEntry::Retrieve(unsigned int styleNumber_, bool unicode_, std:
 	return false;
 }
 
-size_t PositionCacheEntry::Hash(unsigned int styleNumber_, bool unicode_, std::string_view sv) noexcept {
+size_t PositionCacheEntry::Hash(unsigned int fontIdentity_, bool unicode_, std::string_view sv) noexcept {
 	const size_t h1 = std::hash<std::string_view>{}(sv);
-	const size_t h2 = std::hash<unsigned int>{}(styleNumber_);
+	const size_t h2 = std::hash<unsigned int>{}(fontIdentity_);
 	return h1 ^ (h2 << 1) ^ static_cast<size_t>(unicode_);
 }
 
+bool PositionCacheEntry::Empty() const noexcept {
+	return !positions;
+}
+
 bool PositionCacheEntry::NewerThan(const PositionCacheEntry &other) const noexcept {
 	return clock > other.clock;
 }
 
+void PositionCacheEntry::Touch(uint32_t clock_) noexcept {
+	clock = clock_;
+}
+
 void PositionCacheEntry::ResetClock() noexcept {
 	if (clock > 0) {
 		clock = 1;
 	}
 }
 
-PositionCache::PositionCache() = default;
-
-void PositionCache::Clear() noexcept {
+void PositionCacheShard::Clear() noexcept {
 	if (!allClear) {
 		for (PositionCacheEntry &pce : pces) {
 			pce.Clear();
@@ -1081,13 +1155,47 @@ void PositionCache::Clear() noexcept {
 	allClear = true;
 }
 
+uint32_t PositionCacheShard::Tick() noexcept {
+	clock++;
+	if (clock > 0xFFFF0000U) {
+		// Wrap the clock round and reset all cache entries so none get stuck with a high clock.
+		for (PositionCacheEntry &pce : pces) {
+			pce.ResetClock();
+		}
+		clock = 2;
+	}
+	return clock;
+}
+
+PositionCache::PositionCache() = default;
+
+void PositionCache::Clear() noexcept {
+	for (size_t shard = 0; shard < shardCount; shard++) {
+		shards[shard].Clear();
+	}
+}
+
 void PositionCache::SetSize(size_t size_) {
-	Clear();
-	pces.resize(size_);
+	shards.reset();
+	size = size_;
+	ways = std::min(size, positionCacheWays);
+	const size_t sets = ways ? size / ways : 0;
+	shardCount = sets ? 1 : 0;
+	while ((shardCount < positionCacheShardsMaximum) &&
+		(sets / (shardCount * 2) >= positionCacheSetsPerShardMinimum)) {
+		shardCount *= 2;
+	}
+	setsPerShard = shardCount ? sets / shardCount : 0;
+	if (shardCount) {
+		shards = std::make_unique<PositionCacheShard[]>(shardCount);
+		for (size_t shard = 0; shard < shardCount; shard++) {
+			shards[shard].pces.resize(setsPerShard * ways);
+		}
+	}
 }
 
 size_t PositionCache::GetSize() const noexcept {
-	return pces.size();
+	return size;
 }
 
 void PositionCache::MeasureWidths(Surface *surface, const ViewStyle &vstyle, unsigned int styleNumber,
@@ -1103,29 +1211,36 @@ void PositionCache::MeasureWidths(Surface *surface, const ViewStyle &vstyle, uns
 		}
 	}
 
-	size_t probe = pces.size();	// Out of bounds
-	if ((!pces.empty()) && (sv.length() < 30)) {
+	PositionCacheShard *shard = nullptr;
+	size_t probe = 0;
+	const unsigned int fontIdentity = style.fontIdentity;
+	if (shardCount && fontIdentity && (sv.length() < 30)) {
 		// Only store short strings in the cache so it doesn't churn with
 		// long comments with only a single comment.
 
-		// Two way associative: try two probe positions.
-		const size_t hashValue = PositionCacheEntry::Hash(styleNumber, unicode, sv);
-		probe = hashValue % pces.size();
-		std::unique_lock<std::mutex> guard(mutex, std::defer_lock);
+		// Shard count is a power of 2 so use the low bits of the hash to choose
+		// the shard and the remaining bits to choose the set within the shard.
+		const size_t hashValue = PositionCacheEntry::Hash(fontIdentity, unicode, sv);
+		shard = &shards[hashValue & (shardCount - 1)];
+		const size_t setStart = ((hashValue / shardCount) % setsPerShard) * ways;
+		std::unique_lock<std::mutex> guard(shard->mutex, std::defer_lock);
 		if (needsLocking) {
 			guard.lock();
 		}
-		if (pces[probe].Retrieve(styleNumber, unicode, sv, positions)) {
-			return;
-		}
-		const size_t probe2 = (hashValue * 37) % pces.size();
-		if (pces[probe2].Retrieve(styleNumber, unicode, sv, positions)) {
-			return;
-		}
-		// Not found. Choose the oldest of the two slots to replace
-		if (pces[probe].NewerThan(pces[probe2])) {
-			probe = probe2;
+		probe = setStart;
+		for (size_t way = setStart; way < setStart + ways; way++) {
+			PositionCacheEntry &pce = shard->pces[way];
+			if (pce.Retrieve(fontIdentity, unicode, sv, positions)) {
+				pce.Touch(shard->Tick());
+				shard->statistics.hits++;
+				return;
+			}
+			// Not found. Choose an empty slot or else the least recently used slot to replace
+			if (!shard->pces[probe].Empty() && (pce.Empty() || shard->pces[probe].NewerThan(pce))) {
+				probe = way;
+			}
 		}
+		shard->statistics.misses++;
 	}
 
 	const Font *fontStyle = style.font.get();
@@ -1134,26 +1249,49 @@ void PositionCache::MeasureWidths(Surface *surface, const ViewStyle &vstyle, uns
 	} else {
 		surface->MeasureWidths(fontStyle, sv, positions);
 	}
-	if (probe < pces.size()) {
+	if (shard) {
 		// Store into cache
-		std::unique_lock<std::mutex> guard(mutex, std::defer_lock);
+		std::unique_lock<std::mutex> guard(shard->mutex, std::defer_lock);
 		if (needsLocking) {
 			guard.lock();
 		}
-		clock++;
-		if (clock > 60000) {
-			// Since there are only 16 bits for the clock, wrap it round and
-			// reset all cache entries so none get stuck with a high clock.
-			for (PositionCacheEntry &pce : pces) {
-				pce.ResetClock();
-			}
-			clock = 2;
+		PositionCacheEntry &pce = shard->pces[probe];
+		if (!pce.Empty()) {
+			shard->statistics.evictions++;
 		}
-		allClear = false;
-		pces[probe].Set(styleNumber, unicode, sv, positions, clock);
+		shard->allClear = false;
+		pce.Set(fontIdentity, unicode, sv, positions, shard->Tick());
+	}
+}
+
+PositionCacheStatistics PositionCache::Statistics() {
+	PositionCacheStatistics total;
+	for (size_t shard = 0; shard < shardCount; shard++) {
+		std::lock_guard<std::mutex> guard(shards[shard].mutex);
+		const PositionCacheStatistics &statistics = shards[shard].statistics;
+		total.hits += statistics.hits;
+		total.misses += statistics.misses;
+		total.evictions += statistics.evictions;
+	}
+	return total;
+}
+
+void PositionCache::ClearStatistics() {
+	for (size_t shard = 0; shard < shardCount; shard++) {
+		std::lock_guard<std::mutex> guard(shards[shard].mutex);
+		shards[shard].statistics = {};
 	}
 }
 
 std::unique_ptr<IPositionCache> Scintilla::Internal::CreatePositionCache() {
 	return std::make_unique<PositionCache>();
 }
+
+std::shared_ptr<IPositionCache> Scintilla::Internal::SharedPositionCache() {
+	static std::shared_ptr<IPositionCache> sharedCache = [] {
+		std::shared_ptr<IPositionCache> cache = CreatePositionCache();
+		cache->SetSize(positionCacheSharedDefaultSize);
+		return cache;
+	}();
+	return sharedCache;
+}
@@ -71,6 +71,15 @@ public:
 
 	std::unique_ptr<BidiData> bidiData;
 
+	// Very long lines may be divided into chunks instead of filling positions.
+	// chunkStarts ends with numCharsInLine and chunkBases holds the x position of each chunk
+	// start and of the line end. chunkPositions holds each measured chunk's positions relative
+	// to its base and is empty for chunks that are estimated or were freed after measuring.
+	// All are empty when the whole line was measured into positions.
+	std::vector<int> chunkStarts;
+	std::vector<XYPOSITION> chunkBases;
+	std::vector<std::unique_ptr<XYPOSITION[]>> chunkPositions;
+
 	// Wrapped line support
 	int widthLine = wrapWidthInfinite;
 	int lines = 1;
@@ -81,6 +90,10 @@ public:
 	void ReSet(Sci::Line lineNumber_, Sci::Position maxLineLength_);
 	void EnsureBidiData();
 	void ClearPositions();
+	void ClearChunks() noexcept;
+	[[nodiscard]] bool Chunked() const noexcept;
+	size_t ChunkFromPosition(Sci::Position index) const noexcept;
+	XYPOSITION XPosition(Sci::Position index) const noexcept;
 	void Invalidate(ValidLevel validity_) noexcept;
 	Sci::Line LineNumber() const noexcept;
 	bool CanHold(Sci::Line lineDoc, int lineLength_) const noexcept;
@@ -259,6 +272,14 @@ public:
 };
 
 constexpr size_t positionCacheDefaultSize = 0x400;
+constexpr size_t positionCacheSharedDefaultSize = 0x1000;
+
+// Counters to show how effective the position cache is.
+struct PositionCacheStatistics {
+	size_t hits = 0;
+	size_t misses = 0;	// Lookups of cacheable strings that were not found
+	size_t evictions = 0;	// Entries replaced by newer strings
+};
 
 class IPositionCache {
 public:
@@ -268,9 +289,13 @@ public:
 	virtual size_t GetSize() const noexcept = 0;
 	virtual void MeasureWidths(Surface *surface, const ViewStyle &vstyle, unsigned int styleNumber,
 		bool unicode, std::string_view sv, XYPOSITION *positions, bool needsLocking) = 0;
+	virtual PositionCacheStatistics Statistics() = 0;
+	virtual void ClearStatistics() = 0;
 };
 
 std::unique_ptr<IPositionCache> CreatePositionCache();
+// The process-wide cache used by views that share measurements.
+std::shared_ptr<IPositionCache> SharedPositionCache();
 
 }
 
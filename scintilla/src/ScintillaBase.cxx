@@ -644,7 +644,10 @@ LexState *ScintillaBase::DocumentLexState() {
 	if (!pdoc->GetLexInterface()) {
 		pdoc->SetLexInterface(std::make_unique<LexState>(pdoc));
 	}
-	return dynamic_cast<LexState *>(pdoc->GetLexInterface());
+	LexState *lexState = dynamic_cast<LexState *>(pdoc->GetLexInterface());
+	// The lexer may be called so it can not be in use by background styling
+	lexState->StopBackgroundStyling();
+	return lexState;
 }
 
 const char *LexState::DescribeWordListSets() {
@@ -732,6 +735,7 @@ int LexState::PropGetInt(const char *key, int defaultValue) const {
 }
 
 LineEndType LexState::LineEndTypesSupported() {
+	StopBackgroundStyling();
 	if (instance) {
 		return static_cast<LineEndType>(instance->LineEndTypesSupported());
 	}
@@ -37,6 +37,9 @@ struct FontMeasurements {
 	XYPOSITION spaceWidth = 1;
 	bool monospaceASCII = false;
 	int sizeZoomed = 2;
+	// Fonts realised from the same parameters, even in different views, measure text
+	// the same so share an identity that keys the position cache. 0 is not realised.
+	unsigned int fontIdentity = 0;
 };
 
 /**
@@ -0,0 +1,158 @@
+// Scintilla source code edit control
+/** @file ThreadPool.cxx
+ ** Persistent worker threads for running parallel passes over lines or segments.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <cstddef>
+
+#include <stdexcept>
+#include <exception>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#include "ThreadPool.h"
+
+namespace Scintilla::Internal {
+
+ThreadPool::~ThreadPool() noexcept {
+	StopWorkers();
+}
+
+size_t ThreadPool::Claim(Job *job) noexcept {
+	const size_t index = job->next++;
+	if (job->next >= job->count) {
+		jobs.erase(std::find(jobs.begin(), jobs.end(), job));
+	}
+	return index;
+}
+
+void ThreadPool::Perform(Job *job, size_t index, bool worker) noexcept {
+	std::exception_ptr exception;
+	try {
+		(*job->task)(index);
+	} catch (...) {
+		exception = std::current_exception();
+	}
+	std::lock_guard<std::mutex> guard(mutexJobs);
+	if (exception && !job->exception) {
+		job->exception = exception;
+	}
+	job->finished++;
+	statistics.tasks++;
+	if (worker) {
+		statistics.workerTasks++;
+	}
+	if (job->finished == job->count) {
+		jobFinished.notify_all();
+	}
+}
+
+void ThreadPool::Work() noexcept {
+	while (true) {
+		Job *job = nullptr;
+		size_t index = 0;
+		{
+			std::unique_lock<std::mutex> lock(mutexJobs);
+			const std::chrono::steady_clock::time_point startWait = std::chrono::steady_clock::now();
+			jobAvailable.wait(lock, [this] { return stopping || !jobs.empty(); });
+			statistics.idle += std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::steady_clock::now() - startWait);
+			if (stopping) {
+				return;
+			}
+			// Take the most recent job so nested calls finish before their callers continue
+			job = jobs.back();
+			index = Claim(job);
+		}
+		Perform(job, index, true);
+	}
+}
+
+void ThreadPool::StopWorkers() noexcept {
+	{
+		std::lock_guard<std::mutex> guard(mutexJobs);
+		stopping = true;
+	}
+	jobAvailable.notify_all();
+	for (std::thread &worker : workers) {
+		worker.join();
+	}
+	workers.clear();
+	stopping = false;
+}
+
+void ThreadPool::SetThreads(unsigned int threads_) noexcept {
+	threads_ = std::max(threads_, 1U);
+	if (threads != threads_) {
+		StopWorkers();
+		threads = threads_;
+	}
+}
+
+void ThreadPool::Run(size_t count, const std::function<void(size_t)> &task) {
+	if ((count <= 1) || (threads <= 1)) {
+		for (size_t index = 0; index < count; index++) {
+			task(index);
+		}
+		std::lock_guard<std::mutex> guard(mutexJobs);
+		statistics.tasks += count;
+		return;
+	}
+
+	if (workers.empty()) {
+		for (unsigned int th = 1; th < threads; th++) {
+			workers.emplace_back(&ThreadPool::Work, this);
+		}
+		std::lock_guard<std::mutex> guard(mutexJobs);
+		statistics.threadsCreated += workers.size();
+	}
+
+	Job job;
+	job.task = &task;
+	job.count = count;
+	{
+		std::lock_guard<std::mutex> guard(mutexJobs);
+		jobs.push_back(&job);
+		statistics.runs++;
+	}
+	jobAvailable.notify_all();
+
+	// Help with this job's tasks then wait for those claimed by workers
+	while (true) {
+		size_t index = 0;
+		{
+			std::lock_guard<std::mutex> guard(mutexJobs);
+			if (job.next >= job.count) {
+				break;
+			}
+			index = Claim(&job);
+		}
+		Perform(&job, index, false);
+	}
+	{
+		std::unique_lock<std::mutex> lock(mutexJobs);
+		jobFinished.wait(lock, [&job] { return job.finished == job.count; });
+	}
+	if (job.exception) {
+		std::rethrow_exception(job.exception);
+	}
+}
+
+ThreadPoolStatistics ThreadPool::Statistics() {
+	std::lock_guard<std::mutex> guard(mutexJobs);
+	return statistics;
+}
+
+void ThreadPool::ClearStatistics() {
+	std::lock_guard<std::mutex> guard(mutexJobs);
+	statistics = {};
+}
+
+}
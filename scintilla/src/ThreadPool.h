@@ -0,0 +1,74 @@
+// Scintilla source code edit control
+/** @file ThreadPool.h
+ ** Persistent worker threads for running parallel passes over lines or segments.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+namespace Scintilla::Internal {
+
+// Counters to show how much work is shared with the pool's workers.
+struct ThreadPoolStatistics {
+	size_t runs = 0;	// Calls to Run that used workers
+	size_t tasks = 0;	// Tasks run by all threads including callers
+	size_t workerTasks = 0;	// Tasks run by workers
+	size_t threadsCreated = 0;
+	std::chrono::microseconds idle {};	// Total time workers waited for tasks
+};
+
+/**
+ * A set of worker threads that stay alive between calls so that parallel
+ * layout and wrapping do not create operating system threads each time.
+ * The calling thread also runs tasks so a pool of n threads has n-1 workers.
+ */
+class ThreadPool {
+	// A call to Run, allocated on the caller's stack.
+	struct Job {
+		const std::function<void(size_t)> *task = nullptr;
+		size_t count = 0;
+		size_t next = 0;	// Next task index to claim
+		size_t finished = 0;
+		std::exception_ptr exception;
+	};
+	unsigned int threads = 1;
+	std::vector<std::thread> workers;
+	std::mutex mutexJobs;
+	std::condition_variable jobAvailable;
+	std::condition_variable jobFinished;
+	std::vector<Job *> jobs;	// Jobs with unclaimed tasks
+	bool stopping = false;
+	ThreadPoolStatistics statistics;
+	// Claim the next task of job, removing it from jobs when all tasks are claimed. Lock must be held.
+	size_t Claim(Job *job) noexcept;
+	// Run one task and record its completion.
+	void Perform(Job *job, size_t index, bool worker) noexcept;
+	void Work() noexcept;
+	void StopWorkers() noexcept;
+public:
+	ThreadPool() noexcept = default;
+	// Deleted so ThreadPool objects can not be copied.
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool(ThreadPool &&) = delete;
+	ThreadPool &operator=(const ThreadPool &) = delete;
+	ThreadPool &operator=(ThreadPool &&) = delete;
+	~ThreadPool() noexcept;
+
+	// Set the number of threads including the calling thread. Workers are started when first needed.
+	void SetThreads(unsigned int threads_) noexcept;
+	[[nodiscard]] unsigned int Threads() const noexcept {
+		return threads;
+	}
+	// Call task(index) for each index in [0, count) spread over the pool and wait for them all.
+	// May be called from inside a task. The first exception thrown by a task is rethrown.
+	void Run(size_t count, const std::function<void(size_t)> &task);
+
+	[[nodiscard]] ThreadPoolStatistics Statistics();
+	void ClearStatistics();
+};
+
+}
+
+#endif
@@ -23,6 +23,7 @@
 #include <algorithm>
 #include <memory>
 #include <numeric>
+#include <mutex>
 
 #include "ScintillaTypes.h"
 
@@ -62,6 +63,27 @@ bool MarginStyle::ShowsFolding() const noexcept {
 	return (mask & MaskFolders) != 0;
 }
 
+namespace {
+
+unsigned int FontIdentity(const FontParameters &fp, int logPixelsY) {
+	static std::mutex mutexIdentities;
+	static std::map<std::string, unsigned int> identities;
+	std::string key(fp.faceName);
+	key += '\0';
+	key += fp.localeName ? fp.localeName : "";
+	for (const int value : { static_cast<int>(fp.size * FontSizeMultiplier), static_cast<int>(fp.weight),
+		static_cast<int>(fp.italic), static_cast<int>(fp.extraFontFlag), static_cast<int>(fp.technology),
+		static_cast<int>(fp.characterSet), static_cast<int>(fp.stretch), logPixelsY }) {
+		key += '\0';
+		key += std::to_string(value);
+	}
+	std::lock_guard<std::mutex> guard(mutexIdentities);
+	const unsigned int identityNext = static_cast<unsigned int>(identities.size()) + 1;
+	return identities.try_emplace(key, identityNext).first->second;
+}
+
+}
+
 void FontRealised::Realise(Surface &surface, int zoomLevel, Technology technology, const FontSpecification &fs, const char *localeName) {
 	PLATFORM_ASSERT(fs.fontName);
 	// If negative zoomLevel, ensure sizeZoomed at least minimum positive size 
@@ -71,6 +93,7 @@ void FontRealised::Realise(Surface &surface, int zoomLevel, Technology technolog
 	const FontParameters fp(fs.fontName, deviceHeight / FontSizeMultiplier, fs.weight,
 		fs.italic, fs.extraFontFlag, technology, fs.characterSet, localeName, fs.stretch);
 	font = Font::Allocate(fp);
+	measurements.fontIdentity = FontIdentity(fp, surface.LogPixelsY());
 
 	// floor here is historical as platform layers have tweaked their values to match.
 	// ceil would likely be better to ensure (nearly) all of the ink of a character is seen
@@ -12,6 +12,7 @@ CXXFLAGS = /MP /EHsc /std:c++17 $(OPTIMIZATION) /nologo /D_HAS_AUTO_PTR_ETC=1 /w
 TESTSRC=test*.cxx
 # Files being tested from scintilla/src directory
 TESTEDSRC=\
+ ../../src/BackgroundStyling.cxx \
  ../../src/CaseConvert.cxx \
  ../../src/CaseFolder.cxx \
  ../../src/CellBuffer.cxx \
@@ -22,10 +23,12 @@ TESTEDSRC=\
  ../../src/Decoration.cxx \
  ../../src/Document.cxx \
  ../../src/Geometry.cxx \
+ ../../src/LinearRegex.cxx \
  ../../src/PerLine.cxx \
  ../../src/RESearch.cxx \
  ../../src/RunStyles.cxx \
  ../../src/Selection.cxx \
+ ../../src/ThreadPool.cxx \
  ../../src/UndoHistory.cxx \
  ../../src/UniConversion.cxx \
  ../../src/UniqueString.cxx
@@ -0,0 +1,335 @@
+/** @file testBackgroundStyling.cxx
+ ** Unit Tests for Scintilla internal data structures
+ **/
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <stdexcept>
+#include <utility>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <set>
+#include <optional>
+#include <algorithm>
+#include <memory>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#include "ScintillaTypes.h"
+
+#include "ILoader.h"
+#include "ILexer.h"
+
+#include "Debugging.h"
+
+#include "CharacterCategoryMap.h"
+#include "Position.h"
+#include "SplitVector.h"
+#include "Partitioning.h"
+#include "RunStyles.h"
+#include "CellBuffer.h"
+#include "CharClassify.h"
+#include "Decoration.h"
+#include "CaseFolder.h"
+#include "Document.h"
+#include "BackgroundStyling.h"
+
+#include "catch.hpp"
+
+using namespace Scintilla;
+using namespace Scintilla::Internal;
+
+namespace {
+
+constexpr int styleDefault = 0;
+constexpr int styleComment = 1;
+constexpr int styleNumber = 2;
+
+// Minimal lexer with multi-line comments, line states, and folding on braces.
+class LexerTest final : public ILexer5 {
+	static int BraceDelta(IDocument *pAccess, Sci_Position line) {
+		const Sci_Position start = pAccess->LineStart(line);
+		const Sci_Position end = pAccess->LineEnd(line);
+		int delta = 0;
+		for (Sci_Position i = start; i < end; i++) {
+			char ch = 0;
+			pAccess->GetCharRange(&ch, i, 1);
+			if (pAccess->StyleAt(i) != styleComment) {
+				if (ch == '{')
+					delta++;
+				else if (ch == '}')
+					delta--;
+			}
+		}
+		return delta;
+	}
+public:
+	int SCI_METHOD Version() const override { return lvRelease5; }
+	void SCI_METHOD Release() override { delete this; }
+	const char *SCI_METHOD PropertyNames() override { return ""; }
+	int SCI_METHOD PropertyType(const char *) override { return 0; }
+	const char *SCI_METHOD DescribeProperty(const char *) override { return ""; }
+	Sci_Position SCI_METHOD PropertySet(const char *, const char *) override { return -1; }
+	const char *SCI_METHOD DescribeWordListSets() override { return ""; }
+	Sci_Position SCI_METHOD WordListSet(int, const char *) override { return -1; }
+	void SCI_METHOD Lex(Sci_PositionU startPos, Sci_Position lengthDoc, int initStyle, IDocument *pAccess) override {
+		std::string text(lengthDoc + 1, '\0');
+		if (startPos > 0) {
+			pAccess->GetCharRange(text.data(), startPos - 1, lengthDoc + 1);
+		} else {
+			text.insert(0, 1, '\0');
+			pAccess->GetCharRange(text.data() + 1, startPos, lengthDoc);
+		}
+		std::string styles(lengthDoc, '\0');
+		int state = (initStyle == styleComment) ? styleComment : styleDefault;
+		Sci_Position line = pAccess->LineFromPosition(startPos);
+		for (Sci_Position i = 0; i < lengthDoc; i++) {
+			const char chPrev = text[i];
+			const char ch = text[i + 1];
+			const char chNext = text[i + 2];
+			if (state == styleComment) {
+				styles[i] = styleComment;
+				if ((ch == '/') && (chPrev == '*') && (i > 0) && (styles[i - 1] == styleComment)) {
+					state = styleDefault;
+				}
+			} else if ((ch == '/') && (chNext == '*')) {
+				styles[i] = styleComment;
+				state = styleComment;
+				// Step over '*' so "/*/" does not end the comment
+				if (i + 1 < lengthDoc) {
+					styles[++i] = styleComment;
+				}
+			} else if (ch >= '0' && ch <= '9') {
+				styles[i] = styleNumber;
+			}
+			if (text[i + 1] == '\n') {
+				pAccess->SetLineState(line, state);
+				line++;
+			}
+		}
+		pAccess->StartStyling(startPos);
+		pAccess->SetStyles(lengthDoc, styles.data());
+	}
+	void SCI_METHOD Fold(Sci_PositionU startPos, Sci_Position lengthDoc, int, IDocument *pAccess) override {
+		constexpr int base = static_cast<int>(FoldLevel::Base);
+		Sci_Position line = pAccess->LineFromPosition(startPos);
+		const Sci_Position lineLast = pAccess->LineFromPosition(startPos + lengthDoc);
+		int depth = 0;
+		if (line > 0) {
+			depth = (pAccess->GetLevel(line - 1) & static_cast<int>(FoldLevel::NumberMask)) - base +
+				BraceDelta(pAccess, line - 1);
+		}
+		for (; line <= lineLast; line++) {
+			pAccess->SetLevel(line, base + depth);
+			depth += BraceDelta(pAccess, line);
+		}
+	}
+	void *SCI_METHOD PrivateCall(int, void *) override { return nullptr; }
+	int SCI_METHOD LineEndTypesSupported() override { return 0; }
+	int SCI_METHOD AllocateSubStyles(int, int) override { return -1; }
+	int SCI_METHOD SubStylesStart(int) override { return -1; }
+	int SCI_METHOD SubStylesLength(int) override { return 0; }
+	int SCI_METHOD StyleFromSubStyle(int subStyle) override { return subStyle; }
+	int SCI_METHOD PrimaryStyleFromStyle(int style) override { return style; }
+	void SCI_METHOD FreeSubStyles() override {}
+	void SCI_METHOD SetIdentifiers(int, const char *) override {}
+	int SCI_METHOD DistanceToSecondaryStyles() override { return 0; }
+	const char *SCI_METHOD GetSubStyleBases() override { return ""; }
+	int SCI_METHOD NamedStyles() override { return 3; }
+	const char *SCI_METHOD NameOfStyle(int) override { return ""; }
+	const char *SCI_METHOD TagsOfStyle(int) override { return ""; }
+	const char *SCI_METHOD DescriptionOfStyle(int) override { return ""; }
+	const char *SCI_METHOD GetName() override { return "test"; }
+	int SCI_METHOD GetIdentifier() override { return 0; }
+	const char *SCI_METHOD PropertyGet(const char *) override { return ""; }
+};
+
+// Several batches of text with comments spanning lines and nested braces
+std::string TestText() {
+	std::string text;
+	for (int i = 0; i < 8000; i++) {
+		text += "int v" + std::to_string(i) + " = " + std::to_string(i * 7) + ";";
+		text += (i % 4 == 3) ? "\n}\n}\n}\n" : " {\n";
+		if (i % 5 == 0)
+			text += "/* comment { with brace\n  continues 42 */ x = 1;\n";
+	}
+	return text;
+}
+
+struct LexedDocument {
+	Document document;
+	explicit LexedDocument(std::string_view text) : document(DocumentOption::Default) {
+		document.InsertString(0, text);
+		document.SetLexInterface(std::make_unique<LexInterface>(&document));
+		document.GetLexInterface()->SetInstance(new LexerTest());
+	}
+	void StyleInBackground() {
+		while (document.StyleInBackground(true)) {
+		}
+	}
+	std::string Styles() const {
+		std::string styles(document.Length(), '\0');
+		document.GetStyleRange(reinterpret_cast<unsigned char *>(styles.data()), 0, document.Length());
+		return styles;
+	}
+	std::vector<int> Levels() const {
+		std::vector<int> levels;
+		for (Sci::Line line = 0; line < document.LinesTotal(); line++) {
+			levels.push_back(document.GetLevel(line));
+		}
+		return levels;
+	}
+	std::vector<int> LineStates() const {
+		std::vector<int> states;
+		for (Sci::Line line = 0; line < document.LinesTotal(); line++) {
+			states.push_back(document.GetLineState(line));
+		}
+		return states;
+	}
+};
+
+void RequireSameStyling(const LexedDocument &background, const LexedDocument &synchronous) {
+	REQUIRE(background.document.GetEndStyled() == background.document.Length());
+	REQUIRE(background.Styles() == synchronous.Styles());
+	REQUIRE(background.Levels() == synchronous.Levels());
+	REQUIRE(background.LineStates() == synchronous.LineStates());
+}
+
+}
+
+TEST_CASE("StyleSnapshot") {
+
+	StyleSnapshot snapshot;
+	snapshot.text = "ab\ncd\r\n\nef";
+	snapshot.styles.assign(snapshot.text.length(), '\0');
+	snapshot.lineStarts = { 0, 3, 7, 8, 10 };
+	snapshot.levels.assign(4, static_cast<int>(FoldLevel::Base));
+	snapshot.lineStates.assign(4, 0);
+
+	SECTION("Lines") {
+		REQUIRE(snapshot.LineFromPosition(0) == 0);
+		REQUIRE(snapshot.LineFromPosition(2) == 0);
+		REQUIRE(snapshot.LineFromPosition(3) == 1);
+		REQUIRE(snapshot.LineFromPosition(7) == 2);
+		REQUIRE(snapshot.LineFromPosition(9) == 3);
+		REQUIRE(snapshot.LineFromPosition(10) == 3);
+		REQUIRE(snapshot.LineStart(3) == 8);
+		REQUIRE(snapshot.LineStart(4) == 10);
+		REQUIRE(snapshot.LineEnd(0) == 2);
+		REQUIRE(snapshot.LineEnd(1) == 5);
+		REQUIRE(snapshot.LineEnd(2) == 7);
+		REQUIRE(snapshot.LineEnd(3) == 10);
+	}
+
+	SECTION("Changes") {
+		snapshot.StartStyling(3);
+		snapshot.SetStyleFor(2, 5);
+		snapshot.SetLevel(1, 0x401);
+		snapshot.SetLineState(2, 7);
+		snapshot.SetLineState(0, 3);
+		const StyleBatch batch = snapshot.TakeChanges();
+		REQUIRE(batch.styleStart == 3);
+		REQUIRE(batch.styles == "\x05\x05");
+		REQUIRE(batch.levels.first == 1);
+		REQUIRE(batch.levels.values == std::vector<int> { 0x401 });
+		REQUIRE(batch.lineStates.first == 0);
+		REQUIRE(batch.lineStates.values == std::vector<int> { 3, 0, 7 });
+		// Nothing more changed
+		const StyleBatch batchEmpty = snapshot.TakeChanges();
+		REQUIRE(batchEmpty.styles.empty());
+		REQUIRE(batchEmpty.levels.values.empty());
+		REQUIRE(batchEmpty.lineStates.values.empty());
+	}
+
+	SECTION("UTF8") {
+		snapshot.codePage = CpUtf8;
+		snapshot.text = "a\xCE\x93z";	// a gamma z
+		snapshot.styles.assign(snapshot.text.length(), '\0');
+		snapshot.lineStarts = { 0, 4 };
+		Sci_Position width = 0;
+		REQUIRE(snapshot.GetCharacterAndWidth(1, &width) == 0x393);
+		REQUIRE(width == 2);
+		REQUIRE(snapshot.GetRelativePosition(0, 2) == 3);
+		REQUIRE(snapshot.GetRelativePosition(3, -1) == 1);
+		REQUIRE(snapshot.GetRelativePosition(3, -3) == Sci::invalidPosition);
+	}
+}
+
+TEST_CASE("BackgroundStyling") {
+
+	const std::string text = TestText();
+	LexedDocument synchronous(text);
+	synchronous.document.EnsureStyledTo(synchronous.document.Length());
+
+	SECTION("Complete") {
+		LexedDocument background(text);
+		background.StyleInBackground();
+		RequireSameStyling(background, synchronous);
+	}
+
+	SECTION("Modified") {
+		// Insert while the worker is running
+		LexedDocument background(text);
+		REQUIRE(background.document.StyleInBackground(false));
+		constexpr std::string_view insertion = "/* { 9 */\n";
+		background.document.InsertString(text.length() / 2, insertion);
+		background.StyleInBackground();
+
+		std::string modified = text;
+		modified.insert(text.length() / 2, insertion);
+		LexedDocument expected(modified);
+		expected.document.EnsureStyledTo(expected.document.Length());
+		RequireSameStyling(background, expected);
+	}
+
+	SECTION("ModifiedAfterComplete") {
+		// Edit after the worker finished so only the text after the first change is copied
+		LexedDocument background(text);
+		background.StyleInBackground();
+		constexpr std::string_view insertion = "{ /* 9 */\n";
+		const Sci::Position nearEnd = background.document.LineStart(background.document.LinesTotal() - 3);
+		background.document.InsertString(nearEnd, insertion);
+		background.document.DeleteChars(2, 3);
+		background.document.InsertString(text.length() / 2, insertion);
+		background.StyleInBackground();
+
+		std::string modified = text;
+		modified.insert(nearEnd, insertion);
+		modified.erase(2, 3);
+		modified.insert(text.length() / 2, insertion);
+		LexedDocument expected(modified);
+		expected.document.EnsureStyledTo(expected.document.Length());
+		RequireSameStyling(background, expected);
+	}
+
+	SECTION("Interrupted") {
+		// Style synchronously past the worker then continue in the background
+		LexedDocument background(text);
+		REQUIRE(background.document.StyleInBackground(false));
+		background.document.EnsureStyledTo(text.length() / 3);
+		REQUIRE(background.document.GetEndStyled() >= static_cast<Sci::Position>(text.length() / 3));
+		background.StyleInBackground();
+		RequireSameStyling(background, synchronous);
+	}
+
+	SECTION("Stopped") {
+		LexedDocument background(text);
+		REQUIRE(background.document.StyleInBackground(false));
+		background.document.GetLexInterface()->StopBackgroundStyling();
+		background.StyleInBackground();
+		RequireSameStyling(background, synchronous);
+	}
+
+	SECTION("NoLexer") {
+		Document document(DocumentOption::Default);
+		document.InsertString(0, text);
+		REQUIRE(!document.StyleInBackground(false));
+	}
+}
@@ -72,7 +72,8 @@ TEST_CASE("CellBuffer") {
 	constexpr std::string_view sText = "Scintilla";
 	constexpr Sci::Position sLength = sText.length();
 
-	CellBuffer cb(true, false);
+	const bool pieceTree = GENERATE(false, true);
+	CellBuffer cb(true, false, pieceTree);
 
 	SECTION("InsertOneLine") {
 		bool startSequence = false;
@@ -160,6 +161,55 @@ TEST_CASE("CellBuffer") {
 		cb.SetLineEndTypes(LineEndType::Default);
 	}
 
+	SECTION("InsertEndsWithCR") {
+		// Whole blocks of text followed by '\r' must not read the '\n' after the inserted text
+		const std::string sText2 = std::string(32, 'a') + "\r\n";
+		const Sci::Position sLength2 = sText2.length() - 1;
+		bool startSequence = false;
+		cb.InsertString(0, sText2.data(), sLength2, startSequence);
+		REQUIRE(2 == cb.Lines());
+		REQUIRE(sLength2 == cb.LineStart(1));
+		REQUIRE(sLength2 - 1 == cb.LineEnd(0));
+	}
+
+	SECTION("SegmentPointer") {
+		// Reading each contiguous segment in turn produces all the text
+		bool startSequence = false;
+		cb.InsertString(0, sText.data(), sLength, startSequence);
+		cb.InsertString(3, "ab", 2, startSequence);
+		std::string text;
+		Sci::Position position = 0;
+		while (position < cb.Length()) {
+			Sci::Position segmentLength = 0;
+			const char *segment = cb.SegmentPointer(position, segmentLength);
+			REQUIRE(segmentLength > 0);
+			text.append(segment, segmentLength);
+			position += segmentLength;
+		}
+		REQUIRE("Sciabntilla" == text);
+		Sci::Position segmentLength = 0;
+		cb.SegmentPointer(cb.Length(), segmentLength);
+		REQUIRE(0 == segmentLength);
+	}
+
+	SECTION("InsertManyLines") {
+		// Every line start from one insertion, with each kind of line end, is added together
+		const char *lineEnds[] = { "\n", "\r\n", "\r" };
+		std::string sLines;
+		std::vector<Sci::Position> starts { 0 };
+		for (int line = 0; line < 3000; line++) {
+			sLines += std::to_string(line);
+			sLines += lineEnds[line % 3];
+			starts.push_back(sLines.length());
+		}
+		bool startSequence = false;
+		cb.InsertString(0, sLines.data(), sLines.length(), startSequence);
+		REQUIRE(3001 == cb.Lines());
+		for (size_t line = 1; line < starts.size(); line++) {
+			REQUIRE(starts[line] == cb.LineStart(line));
+		}
+	}
+
 	SECTION("UndoOff") {
 		REQUIRE(cb.IsCollectingUndo());
 		cb.SetUndoCollection(false);
@@ -673,7 +723,8 @@ TEST_CASE("UndoActions") {
 
 TEST_CASE("CharacterIndex") {
 
-	CellBuffer cb(true, false);
+	const bool pieceTree = GENERATE(false, true);
+	CellBuffer cb(true, false, pieceTree);
 
 	SECTION("Setup") {
 		REQUIRE(cb.LineCharacterIndex() == LineCharacterIndexType::None);
@@ -1617,7 +1668,8 @@ TEST_CASE("CellBufferLong") {
 
 	// Call methods on CellBuffer pseudo-randomly trying  to trigger assertion failures
 
-	CellBuffer cb(true, false);
+	const bool pieceTree = GENERATE(false, true);
+	CellBuffer cb(true, false, pieceTree);
 
 	SECTION("Random") {
 		RandomSequence rseq;
@@ -1657,3 +1709,101 @@ TEST_CASE("CellBufferLong") {
 	}
 }
 #endif
+
+namespace {
+
+// Simple reference for where lines start with Unicode line ends.
+std::vector<Sci::Position> LineStartsOf(std::string_view text) {
+	std::vector<Sci::Position> starts{ 0 };
+	for (size_t i = 0; i < text.length(); i++) {
+		const std::string_view rest = text.substr(i);
+		if (rest.substr(0, 2) == "\r\n") {
+			i++;
+		} else if (rest.substr(0, 2) == "\xc2\x85") {
+			i++;
+		} else if ((rest.substr(0, 3) == "\xe2\x80\xa8") || (rest.substr(0, 3) == "\xe2\x80\xa9")) {
+			i += 2;
+		} else if ((rest.front() != '\r') && (rest.front() != '\n')) {
+			continue;
+		}
+		starts.push_back(i + 1);
+	}
+	return starts;
+}
+
+// Count characters in valid UTF-8 text as UTF-32 or UTF-16 code units.
+Sci::Position CountCharacters(std::string_view text, bool utf16) noexcept {
+	Sci::Position count = 0;
+	for (const char ch : text) {
+		const unsigned char uch = ch;
+		if ((uch < 0x80) || (uch >= 0xc0))
+			count++;
+		if (utf16 && (uch >= 0xf0))
+			count++;
+	}
+	return count;
+}
+
+void RequireLines(const CellBuffer &cb, std::string_view text) {
+	const std::vector<Sci::Position> starts = LineStartsOf(text);
+	REQUIRE(cb.Lines() == static_cast<Sci::Line>(starts.size()));
+	for (size_t line = 0; line < starts.size(); line++) {
+		REQUIRE(cb.LineStart(line) == starts[line]);
+		const std::string_view before = text.substr(0, starts[line]);
+		REQUIRE(cb.IndexLineStart(line, LineCharacterIndexType::Utf32) == CountCharacters(before, false));
+		REQUIRE(cb.IndexLineStart(line, LineCharacterIndexType::Utf16) == CountCharacters(before, true));
+	}
+}
+
+}
+
+TEST_CASE("CellBufferLineScan") {
+
+	// Insert text with many line ends of each kind in runs of varying length and check
+	// lines and character indices against a simple reference.
+
+	constexpr std::string_view pieces[] = {
+		"\n", "\r\n", "\r", "\xc2\x85", "\xe2\x80\xa8", "\xe2\x80\xa9",
+		"a", "text without line ends that is longer than a scan block",
+		"\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80",
+		"\xc2\xa9",	// Ends with same byte as PS
+	};
+
+	const bool pieceTree = GENERATE(false, true);
+	CellBuffer cb(true, false, pieceTree);
+	cb.SetUTF8Substance(true);
+	cb.SetLineEndTypes(LineEndType::Unicode);
+	cb.AllocateLineCharacterIndex(LineCharacterIndexType::Utf16 | LineCharacterIndexType::Utf32);
+
+	RandomSequence rseq;
+	std::string text;
+	for (int i = 0; i < 3000; i++) {
+		text += pieces[rseq.Next() % std::size(pieces)];
+	}
+
+	SECTION("Whole") {
+		std::string expected = "start\r\nend";
+		bool startSequence = false;
+		cb.InsertString(0, expected.c_str(), expected.length(), startSequence);
+		cb.InsertString(7, text.c_str(), text.length(), startSequence);
+		expected.insert(7, text);
+		RequireLines(cb, expected);
+	}
+
+	SECTION("Appended") {
+		// Lines joined and split across insertions, such as \r then \n.
+		// Insertions are whole characters as the index is only maintained for valid UTF-8.
+		size_t position = 0;
+		while (position < text.length()) {
+			size_t length = std::min<size_t>(rseq.Next() % 70 + 1, text.length() - position);
+			while ((position + length < text.length()) &&
+				((static_cast<unsigned char>(text[position + length]) & 0xc0) == 0x80)) {
+				length++;
+			}
+			bool startSequence = false;
+			cb.InsertString(position, text.c_str() + position, length, startSequence);
+			position += length;
+		}
+		RequireLines(cb, text);
+	}
+}
@@ -102,7 +102,7 @@ std::ostream &operator << (std::ostream &os, Match const &value) {
 struct DocPlus {
 	Document document;
 
-	DocPlus(std::string_view svInitial, int codePage) : document(DocumentOption::Default) {
+	DocPlus(std::string_view svInitial, int codePage, DocumentOption options=DocumentOption::Default) : document(options) {
 		SetCodePage(codePage);
 		document.InsertString(0, svInitial);
 	}
@@ -194,13 +194,17 @@ void TimeTrace(std::string_view sv, const Catch::Timer &tikka) {
 
 TEST_CASE("Document") {
 
+	// Run with both the gap buffer and piece tree
+	const DocumentOption options = GENERATE(DocumentOption::Default, DocumentOption::PieceTree);
+
 	constexpr std::string_view sText = "Scintilla";
 	constexpr Sci::Position sLength = sText.length();
 	constexpr FindOption rePosix = FindOption::RegExp | FindOption::Posix;
 	constexpr FindOption reCxx11 = FindOption::RegExp | FindOption::Cxx11RegEx;
+	constexpr FindOption reLinear = FindOption::RegExp | FindOption::Posix | FindOption::LinearRegEx;
 
 	SECTION("InsertOneLine") {
-		DocPlus doc("", 0);
+		DocPlus doc("", 0, options);
 		const Sci::Position length = doc.document.InsertString(0, sText);
 		REQUIRE(sLength == doc.document.Length());
 		REQUIRE(length == sLength);
@@ -230,7 +234,7 @@ TEST_CASE("Document") {
 				modLength = -1;
 			}
 		};
-		DocPlus doc(sText, 0);
+		DocPlus doc(sText, 0, options);
 		// Length of sText is 9
 		REQUIRE(doc.Styles() == std::string(9, 0));
 		ModificationWatcher mw;
@@ -293,7 +297,7 @@ TEST_CASE("Document") {
 	// Arguments are expected to be at character boundaries and will be tweaked if
 	// part way through a character.
 	SECTION("SearchInLatin") {
-		DocPlus doc("abcde", 0);	// a b c d e
+		DocPlus doc("abcde", 0, options);	// a b c d e
 		constexpr std::string_view finding = "b";
 		Sci::Position lengthFinding = finding.length();
 		Sci::Position location = doc.FindNeedle(finding, FindOption::MatchCase, &lengthFinding);
@@ -307,7 +311,7 @@ TEST_CASE("Document") {
 	}
 
 	SECTION("SearchInBothSegments") {
-		DocPlus doc("ab-ab", 0);	// a b - a b
+		DocPlus doc("ab-ab", 0, options);	// a b - a b
 		constexpr std::string_view finding = "ab";
 		for (int gapPos = 0; gapPos <= 5; gapPos++) {
 			doc.MoveGap(gapPos);
@@ -320,7 +324,7 @@ TEST_CASE("Document") {
 	}
 
 	SECTION("InsensitiveSearchInLatin") {
-		DocPlus doc("abcde", 0);	// a b c d e
+		DocPlus doc("abcde", 0, options);	// a b c d e
 		constexpr std::string_view finding = "B";
 		Sci::Position lengthFinding = finding.length();
 		Sci::Position location = doc.FindNeedle(finding, FindOption::None, &lengthFinding);
@@ -335,7 +339,7 @@ TEST_CASE("Document") {
 
 	SECTION("InsensitiveSearchIn1252") {
 		// In Windows Latin, code page 1252, C6 is AE and E6 is ae
-		DocPlus doc("tru\xc6s\xe6t", 0);	// t r u AE s ae t
+		DocPlus doc("tru\xc6s\xe6t", 0, options);	// t r u AE s ae t
 		doc.SetSBCSFoldings(foldings1252, std::size(foldings1252));
 
 		// Search for upper-case AE
@@ -360,7 +364,7 @@ TEST_CASE("Document") {
 
 	SECTION("Search2InLatin") {
 		// Checks that the initial '_' and final 'f' are ignored since they are outside the search bounds
-		DocPlus doc("_abcdef", 0);	// _ a b c d e f
+		DocPlus doc("_abcdef", 0, options);	// _ a b c d e f
 		constexpr std::string_view finding = "cd";
 		Sci::Position lengthFinding = finding.length();
 		const size_t docLength = doc.document.Length() - 1;
@@ -384,7 +388,7 @@ TEST_CASE("Document") {
 	}
 
 	SECTION("SearchInUTF8") {
-		DocPlus doc("ab\xCE\x93" "d", CpUtf8);	// a b gamma d
+		DocPlus doc("ab\xCE\x93" "d", CpUtf8, options);	// a b gamma d
 		constexpr std::string_view finding = "b";
 		Sci::Position lengthFinding = finding.length();
 		Sci::Position location = doc.FindNeedle(finding, FindOption::MatchCase, &lengthFinding);
@@ -406,7 +410,7 @@ TEST_CASE("Document") {
 	}
 
 	SECTION("InsensitiveSearchInUTF8") {
-		DocPlus doc("ab\xCE\x93" "d", CpUtf8);	// a b gamma d
+		DocPlus doc("ab\xCE\x93" "d", CpUtf8, options);	// a b gamma d
 		constexpr std::string_view finding = "b";
 		Sci::Position lengthFinding = finding.length();
 		Sci::Position location = doc.FindNeedle(finding, FindOption::None, &lengthFinding);
@@ -428,11 +432,54 @@ TEST_CASE("Document") {
 		REQUIRE(location == -1);
 	}
 
+	SECTION("InsensitiveSearchInUTF8Candidates") {
+		// Forward searches only check characters that may fold to the start of the search
+		std::string text;
+		for (int i = 0; i < 6; i++) {
+			text += "\xE6\x97\xA5\xE6\x9C\xAC";	// Japanese 'Japan' to skip over
+		}
+		// Kelvin sign 'ey' phi ' KEY ' long s
+		text += "\xE2\x84\xAA" "ey \xCF\x86 KEY \xC5\xBF";
+		DocPlus doc(text, CpUtf8, options);
+		for (Sci::Position gapPos = 0; gapPos <= doc.document.Length(); gapPos += 7) {
+			doc.MoveGap(gapPos);
+			constexpr std::string_view findingKey = "key";
+			Sci::Position lengthFinding = findingKey.length();
+			Sci::Position location = doc.FindNeedle(findingKey, FindOption::None, &lengthFinding);
+			REQUIRE(location == 36);
+			REQUIRE(lengthFinding == 5);
+			lengthFinding = findingKey.length();
+			location = doc.document.FindText(37, doc.document.Length(), findingKey.data(), FindOption::None, &lengthFinding);
+			REQUIRE(location == 45);
+			REQUIRE(lengthFinding == 3);
+			lengthFinding = findingKey.length();
+			location = doc.FindNeedleReverse(findingKey, FindOption::None, &lengthFinding);
+			REQUIRE(location == 45);
+
+			constexpr std::string_view findingPhi = "\xCE\xA6";	// Capital phi
+			lengthFinding = findingPhi.length();
+			location = doc.FindNeedle(findingPhi, FindOption::None, &lengthFinding);
+			REQUIRE(location == 42);
+			REQUIRE(lengthFinding == 2);
+
+			constexpr std::string_view findingS = "S";
+			lengthFinding = findingS.length();
+			location = doc.FindNeedle(findingS, FindOption::None, &lengthFinding);
+			REQUIRE(location == 49);
+			REQUIRE(lengthFinding == 2);
+
+			constexpr std::string_view findingMissing = "keys";
+			lengthFinding = findingMissing.length();
+			location = doc.FindNeedle(findingMissing, FindOption::None, &lengthFinding);
+			REQUIRE(location == -1);
+		}
+	}
+
 	SECTION("SearchInShiftJIS") {
 		// {CJK UNIFIED IDEOGRAPH-9955} is two bytes: {0xE9, 'b'} in Shift-JIS
 		// The 'b' can be incorrectly matched by the search string 'b' when the search
 		// does not iterate the text correctly.
-		DocPlus doc("ab\xe9" "b ", 932);	// a b {CJK UNIFIED IDEOGRAPH-9955} {space}
+		DocPlus doc("ab\xe9" "b ", 932, options);	// a b {CJK UNIFIED IDEOGRAPH-9955} {space}
 		constexpr std::string_view finding = "b";
 		// Search forwards
 		Sci::Position lengthFinding = finding.length();
@@ -448,7 +495,7 @@ TEST_CASE("Document") {
 		// {CJK UNIFIED IDEOGRAPH-9955} is two bytes: {0xE9, 'b'} in Shift-JIS
 		// The 'b' can be incorrectly matched by the search string 'b' when the search
 		// does not iterate the text correctly.
-		DocPlus doc("ab\xe9" "b ", 932);	// a b {CJK UNIFIED IDEOGRAPH-9955} {space}
+		DocPlus doc("ab\xe9" "b ", 932, options);	// a b {CJK UNIFIED IDEOGRAPH-9955} {space}
 		constexpr std::string_view finding = "b";
 		// Search forwards
 		Sci::Position lengthFinding = finding.length();
@@ -594,7 +641,7 @@ TEST_CASE("Document") {
 	}
 
 	SECTION("RegexSearchAndSubstitution") {
-		DocPlus doc("\n\r\r\n 1a\xCE\x93z \n\r\r\n 2b\xCE\x93y \n\r\r\n", CpUtf8);// 1a gamma z 2b gamma y
+		DocPlus doc("\n\r\r\n 1a\xCE\x93z \n\r\r\n 2b\xCE\x93y \n\r\r\n", CpUtf8, options);// 1a gamma z 2b gamma y
 		const Sci::Position docLength = doc.document.Length();
 		Match match;
 
@@ -633,7 +680,7 @@ TEST_CASE("Document") {
 	}
 
 	SECTION("RegexAssertion") {
-		DocPlus doc("ab cd ef\r\ngh ij kl", CpUtf8);
+		DocPlus doc("ab cd ef\r\ngh ij kl", CpUtf8, options);
 		const Sci::Position docLength = doc.document.Length();
 		Match match;
 
@@ -742,7 +789,7 @@ TEST_CASE("Document") {
 	SECTION("RegexContextualAssertion") {
 		// For std::regex, check the use of assertions next to text in forward direction
 		// These are more common than empty assertions
-		DocPlus doc("ab cd ef\r\ngh ij kl", CpUtf8);
+		DocPlus doc("ab cd ef\r\ngh ij kl", CpUtf8, options);
 		const Sci::Position docLength = doc.document.Length();
 		Match match;
 
@@ -780,7 +827,7 @@ TEST_CASE("Document") {
 	}
 
 	SECTION("RESearchMovePositionOutsideCharUTF8") {
-		DocPlus doc(" a\xCE\x93\xCE\x93z ", CpUtf8);// a gamma gamma z
+		DocPlus doc(" a\xCE\x93\xCE\x93z ", CpUtf8, options);// a gamma gamma z
 		const Sci::Position docLength = doc.document.Length();
 		constexpr std::string_view finding = R"([a-z](\w)\1)";
 
@@ -801,7 +848,7 @@ TEST_CASE("Document") {
 	}
 
 	SECTION("RESearchMovePositionOutsideCharDBCS") {
-		DocPlus doc(" \x98\x61xx 1aa\x83\xA1\x83\xA1z ", 932);// U+548C xx 1aa gamma gamma z
+		DocPlus doc(" \x98\x61xx 1aa\x83\xA1\x83\xA1z ", 932, options);// U+548C xx 1aa gamma gamma z
 		const Sci::Position docLength = doc.document.Length();
 
 		Match match = doc.FindString(0, docLength, R"([a-z](\w)\1)", rePosix);
@@ -818,8 +865,178 @@ TEST_CASE("Document") {
 		REQUIRE(substituted == "\ta\n");
 	}
 
+	SECTION("LinearRegexSearch") {
+		DocPlus doc("\n\r\r\n 1a\xCE\x93z \n\r\r\n 2b\xCE\x93y \n\r\r\n", CpUtf8, options);// 1a gamma z 2b gamma y
+		const Sci::Position docLength = doc.document.Length();
+		Match match;
+
+		constexpr std::string_view finding = R"(\d+(\w+))";
+		constexpr std::string_view substituteText = R"(\t\1\n)";
+		std::string substituted;
+
+		match = doc.FindString(0, docLength, finding, reLinear);
+		REQUIRE(match == Match(5, 5));
+		substituted = doc.Substitute(substituteText);
+		REQUIRE(substituted == "\ta\xCE\x93z\n");
+
+		match = doc.FindString(docLength, 0, finding, reLinear);
+		REQUIRE(match == Match(16, 5));
+		substituted = doc.Substitute(substituteText);
+		REQUIRE(substituted == "\tb\xCE\x93y\n");
+
+		// Repeating the search uses the compiled pattern
+		match = doc.FindString(6, docLength, finding, reLinear);
+		REQUIRE(match == Match(16, 5));
+
+		match = doc.FindString(0, docLength, "^$", reLinear);
+		REQUIRE(match == Match(0));
+		match = doc.FindString(docLength, 0, "\\>", reLinear);
+		REQUIRE(match == Match(21));
+		match = doc.FindString(docLength, 0, "^ [0-9]", reLinear);
+		REQUIRE(match == Match(15, 2));
+
+		// Word characters changing are seen by a repeated search
+		match = doc.FindString(0, docLength, "[0-9]\\w", reLinear);
+		REQUIRE(match == Match(5, 2));
+		doc.document.SetCharClasses(reinterpret_cast<const unsigned char *>("a"), CharacterClass::punctuation);
+		match = doc.FindString(0, docLength, "[0-9]\\w", reLinear);
+		REQUIRE(match == Match(16, 2));
+	}
+
+	SECTION("LinearRegexBackReference") {
+		DocPlus doc(" xab abab ", CpUtf8, options);
+		const Sci::Position docLength = doc.document.Length();
+
+		// Back references fall back to RESearch
+		const Match match = doc.FindString(0, docLength, R"((ab)\1)", reLinear);
+		REQUIRE(match == Match(5, 4));
+		const std::string substituted = doc.Substitute(R"(\1)");
+		REQUIRE(substituted == "ab");
+	}
+
+	SECTION("FindAll") {
+		DocPlus doc("ab Ab\nab abab\n", CpUtf8, options);
+		const Sci::Position docLength = doc.document.Length();
+		std::vector<Range> found;
+
+		Sci::Position matches = doc.document.FindAll(0, docLength, "ab", FindOption::MatchCase, 2, 0, &found);
+		REQUIRE(4 == matches);
+		REQUIRE(found == std::vector<Range> { {0, 2}, {6, 8}, {9, 11}, {11, 13} });
+
+		// Case insensitive, reversed range, no recording
+		matches = doc.document.FindAll(docLength, 0, "ab", FindOption::None, 2, 0, nullptr);
+		REQUIRE(5 == matches);
+
+		// Limited
+		found.clear();
+		matches = doc.document.FindAll(0, docLength, "ab", FindOption::None, 2, 2, &found);
+		REQUIRE(2 == matches);
+		REQUIRE(found == std::vector<Range> { {0, 2}, {3, 5} });
+
+		// Empty regular expression matches advance
+		found.clear();
+		matches = doc.document.FindAll(0, docLength, "^", rePosix, 1, 0, &found);
+		REQUIRE(3 == matches);
+		REQUIRE(found == std::vector<Range> { {0, 0}, {6, 6}, {14, 14} });
+
+		matches = doc.document.FindAll(0, docLength, "b\\>", rePosix, 3, 0, nullptr);
+		REQUIRE(4 == matches);
+
+		// Matches do not overlap in each encoding and case sensitivity
+		for (const int codePage : { 0, CpUtf8, 932 }) {
+			DocPlus docRun("aAaAa aaa", codePage, options);
+			for (const FindOption flags : { FindOption::MatchCase, FindOption::None }) {
+				found.clear();
+				matches = docRun.document.FindAll(0, docRun.document.Length(), "aa", flags, 2, 0, &found);
+				if (flags == FindOption::MatchCase) {
+					REQUIRE(1 == matches);
+					REQUIRE(found == std::vector<Range> { {6, 8} });
+				} else {
+					REQUIRE(3 == matches);
+					REQUIRE(found == std::vector<Range> { {0, 2}, {2, 4}, {6, 8} });
+				}
+			}
+		}
+	}
+
+	SECTION("ParallelSearch") {
+		// Large enough to be divided into chunks with runs of 'a' that cross chunk boundaries
+		std::string text;
+		for (int line = 0; text.length() < 0x420000; line++) {
+			text += "Key " + std::to_string(line) + " " + std::string(line % 97, 'a') + " \xCE\x93\n";
+		}
+		DocPlus doc(text, CpUtf8, options);
+		doc.MoveGap(0x280000);
+		const Sci::Position docLength = doc.document.Length();
+		struct Search {
+			std::string_view text;
+			FindOption flags;
+		};
+		const std::string run(40, 'a');
+		const Search searches[] = {
+			{ run, FindOption::MatchCase },
+			{ "key 12", FindOption::None },
+			{ "\xCE\xB3\n", FindOption::None },
+			{ "7777", FindOption::WholeWord },
+			{ "[0-9]+ a+", rePosix },
+			{ "^", rePosix },
+			{ "8475[0-9] a", reLinear },
+			{ "missing", FindOption::MatchCase },
+		};
+		for (const Search &search : searches) {
+			const FindOption parallel = search.flags | FindOption::Parallel;
+			const Sci::Position length = search.text.length();
+			std::vector<Range> found;
+			const Sci::Position matches = doc.document.FindAll(0, docLength, search.text.data(), search.flags, length, 0, &found);
+			std::vector<Range> foundParallel;
+			REQUIRE(matches == doc.document.FindAll(0, docLength, search.text.data(), parallel, length, 0, &foundParallel));
+			REQUIRE(found == foundParallel);
+			if (found.empty()) {
+				continue;
+			}
+
+			Sci::Position lengthFound = length;
+			Sci::Position lengthParallel = length;
+			REQUIRE(found.front().start == doc.document.FindText(0, docLength, search.text.data(), parallel, &lengthParallel));
+			REQUIRE(found.front().Length() == lengthParallel);
+
+			// Search forwards from the middle and backwards from the end
+			const Sci::Position middle = docLength / 2;
+			lengthFound = length;
+			lengthParallel = length;
+			REQUIRE(doc.document.FindText(middle, docLength, search.text.data(), search.flags, &lengthFound) ==
+				doc.document.FindText(middle, docLength, search.text.data(), parallel, &lengthParallel));
+			REQUIRE(lengthFound == lengthParallel);
+			lengthFound = length;
+			lengthParallel = length;
+			REQUIRE(doc.document.FindText(docLength, 0, search.text.data(), search.flags, &lengthFound) ==
+				doc.document.FindText(docLength, 0, search.text.data(), parallel, &lengthParallel));
+			REQUIRE(lengthFound == lengthParallel);
+		}
+
+		// Ranges that start and end inside lines with the gap inside those lines, before
+		// the start and after the end, where regular expression chunks read whole lines
+		const Sci::Position lineFirst = doc.document.LineStart(10);
+		const Sci::Position lineLast = doc.document.LineStart(doc.document.LinesTotal() - 10);
+		const Sci::Position gaps[] = { lineFirst + 2, doc.document.LineEnd(doc.document.LinesTotal() - 10) - 1 };
+		for (const Sci::Position gap : gaps) {
+			doc.MoveGap(gap);
+			constexpr std::string_view search = "4475[0-9] a";
+			const Sci::Position length = search.length();
+			std::vector<Range> found;
+			const Sci::Position matches = doc.document.FindAll(lineFirst + 5, lineLast + 5, search.data(), reLinear, length, 0, &found);
+			std::vector<Range> foundParallel;
+			REQUIRE(matches == doc.document.FindAll(lineFirst + 5, lineLast + 5, search.data(),
+				reLinear | FindOption::Parallel, length, 0, &foundParallel));
+			REQUIRE(found == foundParallel);
+			Sci::Position lengthParallel = length;
+			REQUIRE(found.front().start == doc.document.FindText(lineFirst + 5, lineLast + 5, search.data(),
+				reLinear | FindOption::Parallel, &lengthParallel));
+		}
+	}
+
 	SECTION("BraceMatch") {
-		DocPlus doc("{}(()())[]", CpUtf8);
+		DocPlus doc("{}(()())[]", CpUtf8, options);
 		constexpr Sci::Position maxReStyle = 0; // unused parameter
 		Sci::Position pos = doc.document.BraceMatch(0, maxReStyle, 0, false);
 		REQUIRE(pos == 1);
@@ -859,7 +1076,7 @@ TEST_CASE("Document") {
 	}
 
 	SECTION("BraceMatch DBCS") {
-		DocPlus doc("{\x81}\x81{}", 932); // { U+00B1 U+FF0B }
+		DocPlus doc("{\x81}\x81{}", 932, options); // { U+00B1 U+FF0B }
 		constexpr Sci::Position maxReStyle = 0; // unused parameter
 		Sci::Position pos = doc.document.BraceMatch(0, maxReStyle, 0, false);
 		REQUIRE(pos == 5);
@@ -0,0 +1,126 @@
+/** @file testLinearRegex.cxx
+ ** Unit Tests for Scintilla internal data structures
+ **/
+
+#include <cstddef>
+#include <cstring>
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <algorithm>
+
+#include "Position.h"
+#include "CharClassify.h"
+#include "LinearRegex.h"
+
+#include "catch.hpp"
+
+using namespace Scintilla::Internal;
+
+namespace {
+
+struct Found {
+	Sci::Position start = LinearRegex::NOTFOUND;
+	Sci::Position end = LinearRegex::NOTFOUND;
+	bool operator==(const Found &other) const noexcept {
+		return start == other.start && end == other.end;
+	}
+};
+
+Found Search(LinearRegex &re, std::string_view pattern, std::string_view text, bool findLast=false,
+	bool caseSensitive=true, bool utf8=false) {
+	const char *msg = re.Compile(pattern, caseSensitive, false, utf8);
+	REQUIRE(nullptr == msg);
+	if (re.Execute(text, 0, text.length(), findLast)) {
+		return { re.bopat[0], re.eopat[0] };
+	}
+	return {};
+}
+
+}
+
+// Test LinearRegex.
+
+TEST_CASE("LinearRegex") {
+
+	CharClassify cc;
+	LinearRegex re(&cc);
+
+	SECTION("Literal") {
+		REQUIRE(Found { 6, 9 } == Search(re, "lla", "Scintilla scintilla"));
+		REQUIRE(Found { 16, 19 } == Search(re, "lla", "Scintilla scintilla", true));
+		REQUIRE(Found {} == Search(re, "llb", "Scintilla scintilla"));
+		REQUIRE(Found { 0, 3 } == Search(re, "sci", "Scintilla scintilla", false, false));
+	}
+
+	SECTION("Classes") {
+		REQUIRE(Found { 3, 6 } == Search(re, "[0-9]+", "abc123def"));
+		REQUIRE(Found { 3, 6 } == Search(re, "\\d+", "abc123def"));
+		REQUIRE(Found { 0, 3 } == Search(re, "[^0-9]*", "abc123def"));
+		REQUIRE(Found { 2, 5 } == Search(re, "\\s\\w+", "a  bc d"));
+		REQUIRE(Found { 1, 4 } == Search(re, "a.c", "xabcx"));
+		REQUIRE(Found { 2, 4 } == Search(re, "[]-]+", "ab]-c"));
+		REQUIRE(Found { 1, 2 } == Search(re, "\\x41", "xAx"));
+		REQUIRE(Found {} == Search(re, "a.c", "a\nc"));
+		REQUIRE(re.Compile("[abc", true, false, false) != nullptr);
+	}
+
+	SECTION("Anchors") {
+		constexpr std::string_view text = "ab cd\r\nef ab\ngh";
+		REQUIRE(Found { 0, 2 } == Search(re, "^ab", text));
+		REQUIRE(Found { 10, 12 } == Search(re, "ab$", text));
+		REQUIRE(Found { 7, 9 } == Search(re, "^ef", text));
+		REQUIRE(Found { 13, 15 } == Search(re, "^\\w+", text, true));
+		REQUIRE(Found { 3, 5 } == Search(re, "\\<cd\\>", text));
+		REQUIRE(Found {} == Search(re, "\\<b", text));
+		// A quantifier with nothing to repeat is literal
+		REQUIRE(Found { 1, 3 } == Search(re, "*a", "x*a"));
+	}
+
+	SECTION("Captures") {
+		const Found found = Search(re, "\\([a-z]+\\)=\\([0-9]+\\)", "set x=12;");
+		REQUIRE(Found { 4, 8 } == found);
+		REQUIRE(4 == re.bopat[1]);
+		REQUIRE(5 == re.eopat[1]);
+		REQUIRE(6 == re.bopat[2]);
+		REQUIRE(8 == re.eopat[2]);
+		REQUIRE(LinearRegex::NOTFOUND == re.bopat[3]);
+
+		REQUIRE(nullptr == re.Compile("(a+)(b)", true, true, false));
+		REQUIRE(re.Execute("xaab", 0, 4, false));
+		REQUIRE(1 == re.bopat[1]);
+		REQUIRE(3 == re.eopat[1]);
+	}
+
+	SECTION("Lazy") {
+		REQUIRE(Found { 0, 10 } == Search(re, "<.*>", "<a><b></a>x"));
+		REQUIRE(Found { 0, 3 } == Search(re, "<.*?>", "<a><b></a>x"));
+		REQUIRE(Found { 0, 1 } == Search(re, "a+?", "aaa"));
+	}
+
+	SECTION("UTF8") {
+		// a gamma gamma z
+		constexpr std::string_view text = " a\xCE\x93\xCE\x93z ";
+		REQUIRE(Found { 0, 2 } == Search(re, ".", text.substr(2), false, true, true));
+		REQUIRE(Found { 1, 7 } == Search(re, "a..z", text, false, true, true));
+		REQUIRE(Found { 2, 6 } == Search(re, "\xCE\x93+", text, false, true, true));
+		REQUIRE(Found { 1, 7 } == Search(re, "\\w+", text, false, true, true));
+		REQUIRE(Found { 2, 4 } == Search(re, "[\xCE\x91-\xCE\xA9]", text, false, true, true));
+		// Invalid bytes are matched as single characters
+		REQUIRE(Found { 1, 4 } == Search(re, "a.b", "xa\xFF" "b", false, true, true));
+	}
+
+	SECTION("Pathological") {
+		// Backtracking engines take exponential time on this pattern
+		const std::string text(100, 'a');
+		REQUIRE(Found {} == Search(re, "\\(a*\\)*b", text));
+		REQUIRE(Found { 0, 100 } == Search(re, "\\(a*\\)*", text));
+	}
+
+	SECTION("BackReference") {
+		REQUIRE(LinearRegex::unsupportedBackReference == re.Compile("\\(a\\)\\1", true, false, false));
+	}
+}
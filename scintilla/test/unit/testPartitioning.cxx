@@ -165,6 +165,32 @@ TEST_CASE("Partitioning") {
 		part.Check();
 	}
 
+	SECTION("DeletePartitions") {
+		// Compare removing a range at once with removing each partition with the step
+		// both before and after the range
+		for (const Sci::Position stepAt : { 1, 5, 15 }) {
+			Partitioning<Sci::Position> partEach;
+			Partitioning<Sci::Position> partBulk;
+			partEach.InsertText(0, 42);
+			partBulk.InsertText(0, 42);
+			for (Sci::Position i = 0; i < 20; i++) {
+				partEach.InsertPartition(i + 1, (i + 1) * 2);
+				partBulk.InsertPartition(i + 1, (i + 1) * 2);
+			}
+			partEach.InsertText(stepAt, 3);
+			partBulk.InsertText(stepAt, 3);
+			for (int i = 0; i < 4; i++) {
+				partEach.RemovePartition(6);
+			}
+			partBulk.RemovePartitions(6, 4);
+			REQUIRE(partEach.Partitions() == partBulk.Partitions());
+			for (Sci::Position p = 0; p <= partEach.Partitions(); p++) {
+				REQUIRE(partEach.PositionFromPartition(p) == partBulk.PositionFromPartition(p));
+			}
+			partBulk.Check();
+		}
+	}
+
 	SECTION("DeleteAll") {
 		part.InsertText(0, 3);
 		part.InsertPartition(1, 2);
@@ -192,6 +192,23 @@ TEST_CASE("LineMarkers") {
 		REQUIRE(1 == lm.LineFromHandle(handle1));
 		REQUIRE(4 == lm.LineFromHandle(handle2));
 	}
+
+	SECTION("RemoveLines") {
+		// Markers on removed lines move to the line before
+		const int handle1 = lm.AddMark(1, 1, 6);
+		const int handle2 = lm.AddMark(2, 2, 6);
+		const int handle3 = lm.AddMark(3, 3, 6);
+		const int handle4 = lm.AddMark(4, 4, 6);
+		lm.RemoveLines(2, 2);
+		REQUIRE(0 == lm.MarkValue(0));
+		REQUIRE((2 | 4 | 8) == lm.MarkValue(1));
+		REQUIRE(16 == lm.MarkValue(2));
+		REQUIRE(0 == lm.MarkValue(3));
+		REQUIRE(1 == lm.LineFromHandle(handle1));
+		REQUIRE(1 == lm.LineFromHandle(handle2));
+		REQUIRE(1 == lm.LineFromHandle(handle3));
+		REQUIRE(2 == lm.LineFromHandle(handle4));
+	}
 }
 
 TEST_CASE("LineLevels") {
@@ -236,6 +253,20 @@ TEST_CASE("LineLevels") {
 		REQUIRE(2 == ll.GetLevel(4));
 		REQUIRE(FoldBase == ll.GetLevel(5));
 	}
+
+	SECTION("RemoveLines") {
+		constexpr int header = static_cast<int>(Scintilla::FoldLevel::HeaderFlag);
+		ll.SetLevel(1, 1, 6);
+		ll.SetLevel(2, 2, 6);
+		ll.SetLevel(3, 3 | header, 6);
+		ll.SetLevel(4, 4, 6);
+		ll.RemoveLines(2, 2);
+		REQUIRE(FoldBase == ll.GetLevel(0));
+		// Header flag from removed line merged into line before
+		REQUIRE((1 | header) == ll.GetLevel(1));
+		REQUIRE(4 == ll.GetLevel(2));
+		REQUIRE(FoldBase == ll.GetLevel(3));
+	}
 }
 
 TEST_CASE("LineState") {
@@ -297,6 +328,22 @@ TEST_CASE("LineState") {
 		REQUIRE(2 == ls.GetLineState(4));
 		REQUIRE(0 == ls.GetLineState(5));
 	}
+
+	SECTION("RemoveLines") {
+		for (int line = 1; line < 5; line++) {
+			ls.SetLineState(line, line, 6);
+		}
+		REQUIRE(7 == ls.GetMaxLineState());
+		ls.RemoveLines(2, 2);
+		REQUIRE(5 == ls.GetMaxLineState());
+		REQUIRE(0 == ls.GetLineState(0));
+		REQUIRE(1 == ls.GetLineState(1));
+		REQUIRE(4 == ls.GetLineState(2));
+		REQUIRE(0 == ls.GetLineState(3));
+		// Removing past the end is clipped
+		ls.RemoveLines(3, 10);
+		REQUIRE(3 == ls.GetMaxLineState());
+	}
 }
 
 TEST_CASE("LineAnnotation") {
@@ -356,6 +403,18 @@ TEST_CASE("LineAnnotation") {
 		REQUIRE(0 == la.Length(2));
 		REQUIRE(4 == la.Length(3));
 	}
+
+	SECTION("RemoveLines") {
+		la.SetText(0, "Ant");
+		la.SetText(1, "Bird");
+		la.SetText(2, "Cat");
+		la.SetText(3, "Dingo");
+		// Same as removing line 2 twice
+		la.RemoveLines(2, 2);
+		REQUIRE(3 == la.Length(0));
+		REQUIRE(5 == la.Length(1));
+		REQUIRE(0 == la.Length(2));
+	}
 }
 
 TEST_CASE("LineTabstops") {
@@ -393,4 +452,15 @@ TEST_CASE("LineTabstops") {
 		lt.Init();
 		REQUIRE(0 == lt.GetNextTabstop(0, 0));
 	}
+
+	SECTION("RemoveLines") {
+		lt.AddTabstop(0, 100);
+		lt.AddTabstop(1, 200);
+		lt.AddTabstop(2, 300);
+		lt.AddTabstop(3, 400);
+		lt.RemoveLines(1, 2);
+		REQUIRE(100 == lt.GetNextTabstop(0, 0));
+		REQUIRE(400 == lt.GetNextTabstop(1, 0));
+		REQUIRE(0 == lt.GetNextTabstop(2, 0));
+	}
 }
@@ -0,0 +1,265 @@
+/** @file testPieceTree.cxx
+ ** Unit Tests for Scintilla internal data structures
+ **/
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <atomic>
+#include <array>
+#include <thread>
+
+#include "Debugging.h"
+
+#include "Position.h"
+#include "PieceTree.h"
+
+#include "catch.hpp"
+
+using namespace Scintilla::Internal;
+
+// Test PieceTree.
+
+namespace {
+
+constexpr std::string_view testText = "abcdefghijklmnopqrstuvwxyz";
+
+std::string Contents(const PieceTree<char> &pt) {
+	std::string s(pt.Length(), '\0');
+	pt.GetRange(s.data(), 0, pt.Length());
+	return s;
+}
+
+}
+
+TEST_CASE("PieceTree") {
+
+	PieceTree<char> pt;
+
+	SECTION("IsEmptyInitially") {
+		REQUIRE(0 == pt.Length());
+		REQUIRE(0 == pt.Pieces());
+		REQUIRE('\0' == pt.ValueAt(0));
+	}
+
+	SECTION("InsertOne") {
+		pt.InsertValue(0, 10, '\0');
+		pt.InsertValue(5, 1, 'x');
+		REQUIRE(11 == pt.Length());
+		for (ptrdiff_t i = 0; i < pt.Length(); i++) {
+			REQUIRE(((i == 5) ? 'x' : '\0') == pt.ValueAt(i));
+		}
+	}
+
+	SECTION("InsertFromArray") {
+		pt.InsertFromArray(0, testText.data(), 0, 10);
+		REQUIRE("abcdefghij" == Contents(pt));
+		pt.InsertFromArray(5, testText.data(), 20, 3);
+		REQUIRE("abcdeuvwfghij" == Contents(pt));
+		pt.InsertFromArray(pt.Length(), testText.data(), 0, 2);
+		REQUIRE("abcdeuvwfghijab" == Contents(pt));
+		// Out of range is ignored
+		pt.InsertFromArray(-1, testText.data(), 0, 2);
+		pt.InsertFromArray(pt.Length() + 1, testText.data(), 0, 2);
+		REQUIRE(15 == pt.Length());
+	}
+
+	SECTION("TypingCoalesces") {
+		pt.InsertFromArray(0, testText.data(), 0, 10);
+		for (ptrdiff_t i = 0; i < 10; i++) {
+			pt.InsertFromArray(3 + i, testText.data(), i, 1);
+		}
+		REQUIRE("abcabcdefghijdefghij" == Contents(pt));
+		// The original text split in two and a single piece for the typed text
+		REQUIRE(3 == pt.Pieces());
+	}
+
+	SECTION("DeleteRange") {
+		pt.InsertFromArray(0, testText.data(), 0, testText.length());
+		pt.InsertFromArray(10, testText.data(), 0, 3);
+		pt.DeleteRange(8, 7);
+		REQUIRE("abcdefghmnopqrstuvwxyz" == Contents(pt));
+		pt.DeleteRange(0, 1);
+		REQUIRE("bcdefghmnopqrstuvwxyz" == Contents(pt));
+		pt.DeleteRange(pt.Length() - 2, 2);
+		REQUIRE("bcdefghmnopqrstuvwx" == Contents(pt));
+		// Out of range is ignored
+		pt.DeleteRange(10, 100);
+		REQUIRE(19 == pt.Length());
+		pt.DeleteRange(0, pt.Length());
+		REQUIRE(0 == pt.Length());
+		REQUIRE(0 == pt.Pieces());
+	}
+
+	SECTION("ForEachSegment") {
+		pt.InsertFromArray(0, testText.data(), 0, 10);
+		pt.InsertFromArray(5, testText.data(), 20, 3);
+		std::string visited;
+		std::vector<ptrdiff_t> starts;
+		pt.ForEachSegment(3, 8, [&](const char *segment, ptrdiff_t length, ptrdiff_t position) {
+			visited.append(segment, length);
+			starts.push_back(position);
+			return true;
+		});
+		REQUIRE("deuvwfgh" == visited);
+		REQUIRE(std::vector<ptrdiff_t> { 3, 5, 8 } == starts);
+		// Stops early
+		int calls = 0;
+		pt.ForEachSegment(0, pt.Length(), [&calls](const char *, ptrdiff_t, ptrdiff_t) {
+			calls++;
+			return false;
+		});
+		REQUIRE(1 == calls);
+	}
+
+	SECTION("SegmentPointer") {
+		pt.InsertFromArray(0, testText.data(), 0, 10);
+		pt.InsertFromArray(5, testText.data(), 20, 3);
+		// Each segment runs to the end of its piece and reading does not consolidate
+		ptrdiff_t segmentLength = 0;
+		const char *segment = pt.SegmentPointer(3, segmentLength);
+		REQUIRE("de" == std::string_view(segment, segmentLength));
+		segment = pt.SegmentPointer(5, segmentLength);
+		REQUIRE("uvw" == std::string_view(segment, segmentLength));
+		segment = pt.SegmentPointer(9, segmentLength);
+		REQUIRE("ghij" == std::string_view(segment, segmentLength));
+		REQUIRE(3 == pt.Pieces());
+		// Outside the array is empty
+		pt.SegmentPointer(pt.Length(), segmentLength);
+		REQUIRE(0 == segmentLength);
+		pt.SegmentPointer(-1, segmentLength);
+		REQUIRE(0 == segmentLength);
+	}
+
+	SECTION("BufferPointer") {
+		pt.InsertFromArray(0, testText.data(), 0, 10);
+		pt.InsertFromArray(5, testText.data(), 20, 3);
+		REQUIRE(3 == pt.Pieces());
+		const char *text = pt.BufferPointer();
+		REQUIRE(1 == pt.Pieces());
+		REQUIRE(0 == strcmp(text, "abcdeuvwfghij"));
+		// Further calls do not copy
+		REQUIRE(text == pt.BufferPointer());
+	}
+
+	SECTION("LoadIsOnePiece") {
+		// Loading reserves space for the whole file then appends it in chunks
+		constexpr ptrdiff_t chunkSize = 128 * 1024;
+		constexpr int chunks = 10;
+		std::string chunk(chunkSize, ' ');
+		for (ptrdiff_t i = 0; i < chunkSize; i++) {
+			chunk[i] = testText[i % testText.length()];
+		}
+		pt.ReAllocate(chunkSize * chunks);
+		for (int i = 0; i < chunks; i++) {
+			pt.InsertFromArray(pt.Length(), chunk.data(), 0, chunkSize);
+		}
+		REQUIRE(chunkSize * chunks == pt.Length());
+		REQUIRE(1 == pt.Pieces());
+		// The loaded piece is used in place without copying
+		ptrdiff_t segmentLength = 0;
+		const char *loaded = pt.SegmentPointer(0, segmentLength);
+		REQUIRE(chunkSize * chunks == segmentLength);
+		const char *text = pt.BufferPointer();
+		REQUIRE(loaded == text);
+		REQUIRE('\0' == text[pt.Length()]);
+		REQUIRE(0 == memcmp(text + chunkSize * (chunks - 1), chunk.data(), chunkSize));
+	}
+
+	SECTION("RangePointer") {
+		pt.InsertFromArray(0, testText.data(), 0, 10);
+		pt.InsertFromArray(5, testText.data(), 20, 3);
+		// Within one piece
+		const char *range = pt.RangePointer(1, 3);
+		REQUIRE(0 == memcmp(range, "bcd", 3));
+		// Spans 3 pieces so is copied into one
+		range = pt.RangePointer(4, 6);
+		REQUIRE(0 == memcmp(range, "euvwfg", 6));
+		REQUIRE("abcdeuvwfghij" == Contents(pt));
+		REQUIRE(3 == pt.Pieces());
+	}
+
+	SECTION("Random") {
+		// Compare against std::string after many random modifications
+		std::string reference;
+		uint32_t r = 1;
+		auto next = [&r]() noexcept {
+			r = r * 1103515245U + 12345U;
+			return (r >> 16) & 0x7fff;
+		};
+		for (int i = 0; i < 20000; i++) {
+			const uint32_t action = next() % 10;
+			const ptrdiff_t position = next() % (reference.length() + 1);
+			const ptrdiff_t length = next() % 20 + 1;
+			if (action <= 4) {
+				const ptrdiff_t from = next() % (testText.length() - length + 1);
+				pt.InsertFromArray(position, testText.data(), from, length);
+				reference.insert(position, testText.substr(from, length));
+			} else if (action <= 8) {
+				if (position + length <= static_cast<ptrdiff_t>(reference.length())) {
+					pt.DeleteRange(position, length);
+					reference.erase(position, length);
+				}
+			} else if (!reference.empty()) {
+				const ptrdiff_t start = position % reference.length();
+				REQUIRE(reference[start] == pt.ValueAt(start));
+			}
+			REQUIRE(static_cast<ptrdiff_t>(reference.length()) == pt.Length());
+		}
+		REQUIRE(reference == Contents(pt));
+		REQUIRE(reference == pt.BufferPointer());
+	}
+
+	SECTION("ReadFromThreads") {
+		// Layout reads text and styles from several threads at once so each thread must
+		// find pieces without disturbing the others.
+		PieceTree<char> styles;
+		std::string reference;
+		for (int i = 0; i < 2000; i++) {
+			const ptrdiff_t position = (i * 7919) % (reference.length() + 1);
+			const ptrdiff_t from = i % testText.length();
+			pt.InsertFromArray(position, testText.data(), from, 1);
+			styles.InsertValue(position, 1, testText[from]);
+			reference.insert(position, 1, testText[from]);
+		}
+		REQUIRE(pt.Pieces() > 100);
+		const ptrdiff_t length = pt.Length();
+		std::atomic<int> mismatches = 0;
+		std::vector<std::thread> threads;
+		for (int t = 0; t < 8; t++) {
+			threads.emplace_back([&, t]() {
+				for (int pass = 0; pass < 20; pass++) {
+					for (ptrdiff_t i = 0; i < length; i++) {
+						// Each thread walks in a different order to move between pieces
+						const ptrdiff_t position = (t % 2) ? (length - 1 - i) : ((i * (t + 1) * 31) % length);
+						if (pt.ValueAt(position) != reference[position] ||
+							styles.ValueAt(position) != reference[position]) {
+							mismatches++;
+						}
+						ptrdiff_t segmentLength = 0;
+						const char *segment = pt.SegmentPointer(position, segmentLength);
+						if (segmentLength <= 0 || position + segmentLength > length ||
+							std::string_view(segment, segmentLength) != std::string_view(reference).substr(position, segmentLength)) {
+							mismatches++;
+						}
+					}
+				}
+			});
+		}
+		for (std::thread &thread : threads) {
+			thread.join();
+		}
+		REQUIRE(0 == mismatches);
+		// Modifying the tree makes the piece remembered by this thread stale
+		REQUIRE(reference[10] == pt.ValueAt(10));
+		pt.DeleteRange(0, 10);
+		REQUIRE(reference[20] == pt.ValueAt(10));
+	}
+}
@@ -0,0 +1,124 @@
+/** @file testThreadPool.cxx
+ ** Unit Tests for Scintilla internal data structures
+ **/
+
+#include <cstddef>
+
+#include <stdexcept>
+#include <exception>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#include "ThreadPool.h"
+
+#include "catch.hpp"
+
+using namespace Scintilla::Internal;
+
+// Test ThreadPool.
+
+TEST_CASE("ThreadPool") {
+
+	ThreadPool pool;
+
+	SECTION("SingleThread") {
+		REQUIRE(1 == pool.Threads());
+		std::vector<size_t> order;
+		pool.Run(5, [&order](size_t index) {
+			order.push_back(index);
+		});
+		// Without workers the tasks run in order on the calling thread
+		REQUIRE(std::vector<size_t> { 0, 1, 2, 3, 4 } == order);
+	}
+
+	SECTION("EachTaskOnce") {
+		pool.SetThreads(4);
+		REQUIRE(4 == pool.Threads());
+		for (int repeat = 0; repeat < 20; repeat++) {
+			std::vector<std::atomic<int>> calls(1000);
+			pool.Run(calls.size(), [&calls](size_t index) {
+				calls[index]++;
+			});
+			for (const std::atomic<int> &call : calls) {
+				REQUIRE(1 == call);
+			}
+		}
+	}
+
+	SECTION("Resize") {
+		pool.SetThreads(3);
+		std::atomic<size_t> sum = 0;
+		pool.Run(10, [&sum](size_t index) {
+			sum += index;
+		});
+		REQUIRE(45 == sum);
+		pool.SetThreads(0);
+		REQUIRE(1 == pool.Threads());
+		pool.SetThreads(2);
+		sum = 0;
+		pool.Run(10, [&sum](size_t index) {
+			sum += index;
+		});
+		REQUIRE(45 == sum);
+	}
+
+	SECTION("Nested") {
+		pool.SetThreads(4);
+		std::atomic<size_t> inner = 0;
+		pool.Run(8, [&pool, &inner](size_t) {
+			pool.Run(8, [&inner](size_t) {
+				inner++;
+			});
+		});
+		REQUIRE(64 == inner);
+	}
+
+	SECTION("Statistics") {
+		pool.Run(3, [](size_t) {});
+		ThreadPoolStatistics statistics = pool.Statistics();
+		REQUIRE(0 == statistics.runs);
+		REQUIRE(3 == statistics.tasks);
+		REQUIRE(0 == statistics.threadsCreated);
+		pool.SetThreads(4);
+		for (int repeat = 0; repeat < 10; repeat++) {
+			pool.Run(100, [](size_t) {});
+		}
+		statistics = pool.Statistics();
+		REQUIRE(10 == statistics.runs);
+		REQUIRE(1003 == statistics.tasks);
+		REQUIRE(statistics.workerTasks <= 1000);
+		// Threads are created once then reused
+		REQUIRE(3 == statistics.threadsCreated);
+		pool.ClearStatistics();
+		statistics = pool.Statistics();
+		REQUIRE(0 == statistics.runs);
+		REQUIRE(0 == statistics.tasks);
+		REQUIRE(0 == statistics.workerTasks);
+		REQUIRE(0 == statistics.threadsCreated);
+		REQUIRE(0 == statistics.idle.count());
+	}
+
+	SECTION("Exception") {
+		pool.SetThreads(4);
+		std::atomic<size_t> completed = 0;
+		REQUIRE_THROWS_AS(pool.Run(100, [&completed](size_t index) {
+			if (index == 50) {
+				throw std::runtime_error("Failed");
+			}
+			completed++;
+		}), std::runtime_error);
+		// Other tasks still ran and the pool remains usable
+		REQUIRE(99 == completed);
+		completed = 0;
+		pool.Run(10, [&completed](size_t) {
+			completed++;
+		});
+		REQUIRE(10 == completed);
+	}
+}
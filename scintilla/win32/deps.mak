@@ -115,6 +115,15 @@ $(DIR_O)/AutoComplete.o: \
 	../src/CharacterType.h \
 	../src/Position.h \
 	../src/AutoComplete.h
+$(DIR_O)/BackgroundStyling.o: \
+	../src/BackgroundStyling.cxx \
+	../include/ScintillaTypes.h \
+	../include/ILexer.h \
+	../include/Sci_Position.h \
+	../src/Debugging.h \
+	../src/Position.h \
+	../src/UniConversion.h \
+	../src/BackgroundStyling.h
 $(DIR_O)/CallTip.o: \
 	../src/CallTip.cxx \
 	../include/ScintillaTypes.h \
@@ -139,6 +148,7 @@ $(DIR_O)/CellBuffer.o: \
 	../src/Debugging.h \
 	../src/Position.h \
 	../src/SplitVector.h \
+	../src/PieceTree.h \
 	../src/Partitioning.h \
 	../src/RunStyles.h \
 	../src/SparseVector.h \
@@ -208,8 +218,11 @@ $(DIR_O)/Document.o: \
 	../src/CaseFolder.h \
 	../src/Document.h \
 	../src/RESearch.h \
+	../src/LinearRegex.h \
 	../src/UniConversion.h \
-	../src/ElapsedPeriod.h
+	../src/ElapsedPeriod.h \
+	../src/BackgroundStyling.h \
+	../src/ThreadPool.h
 $(DIR_O)/EditModel.o: \
 	../src/EditModel.cxx \
 	../include/ScintillaTypes.h \
@@ -277,7 +290,8 @@ $(DIR_O)/Editor.o: \
 	../src/MarginView.h \
 	../src/EditView.h \
 	../src/Editor.h \
-	../src/ElapsedPeriod.h
+	../src/ElapsedPeriod.h \
+	../src/ThreadPool.h
 $(DIR_O)/EditView.o: \
 	../src/EditView.cxx \
 	../include/ScintillaTypes.h \
@@ -314,7 +328,8 @@ $(DIR_O)/EditView.o: \
 	../src/EditModel.h \
 	../src/MarginView.h \
 	../src/EditView.h \
-	../src/ElapsedPeriod.h
+	../src/ElapsedPeriod.h \
+	../src/ThreadPool.h
 $(DIR_O)/Geometry.o: \
 	../src/Geometry.cxx \
 	../src/Geometry.h
@@ -334,6 +349,12 @@ $(DIR_O)/KeyMap.o: \
 	../src/Geometry.h \
 	../src/Platform.h \
 	../src/KeyMap.h
+$(DIR_O)/LinearRegex.o: \
+	../src/LinearRegex.cxx \
+	../src/Position.h \
+	../src/CharClassify.h \
+	../src/UniConversion.h \
+	../src/LinearRegex.h
 $(DIR_O)/LineMarker.o: \
 	../src/LineMarker.cxx \
 	../include/ScintillaTypes.h \
@@ -481,6 +502,9 @@ $(DIR_O)/Style.o: \
 	../src/Geometry.h \
 	../src/Platform.h \
 	../src/Style.h
+$(DIR_O)/ThreadPool.o: \
+	../src/ThreadPool.cxx \
+	../src/ThreadPool.h
 $(DIR_O)/UndoHistory.o: \
 	../src/UndoHistory.cxx \
 	../include/ScintillaTypes.h \
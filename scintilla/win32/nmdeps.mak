@@ -115,6 +115,15 @@ $(DIR_O)/AutoComplete.obj: \
 	../src/CharacterType.h \
 	../src/Position.h \
 	../src/AutoComplete.h
+$(DIR_O)/BackgroundStyling.obj: \
+	../src/BackgroundStyling.cxx \
+	../include/ScintillaTypes.h \
+	../include/ILexer.h \
+	../include/Sci_Position.h \
+	../src/Debugging.h \
+	../src/Position.h \
+	../src/UniConversion.h \
+	../src/BackgroundStyling.h
 $(DIR_O)/CallTip.obj: \
 	../src/CallTip.cxx \
 	../include/ScintillaTypes.h \
@@ -139,6 +148,7 @@ $(DIR_O)/CellBuffer.obj: \
 	../src/Debugging.h \
 	../src/Position.h \
 	../src/SplitVector.h \
+	../src/PieceTree.h \
 	../src/Partitioning.h \
 	../src/RunStyles.h \
 	../src/SparseVector.h \
@@ -208,8 +218,11 @@ $(DIR_O)/Document.obj: \
 	../src/CaseFolder.h \
 	../src/Document.h \
 	../src/RESearch.h \
+	../src/LinearRegex.h \
 	../src/UniConversion.h \
-	../src/ElapsedPeriod.h
+	../src/ElapsedPeriod.h \
+	../src/BackgroundStyling.h \
+	../src/ThreadPool.h
 $(DIR_O)/EditModel.obj: \
 	../src/EditModel.cxx \
 	../include/ScintillaTypes.h \
@@ -277,7 +290,8 @@ $(DIR_O)/Editor.obj: \
 	../src/MarginView.h \
 	../src/EditView.h \
 	../src/Editor.h \
-	../src/ElapsedPeriod.h
+	../src/ElapsedPeriod.h \
+	../src/ThreadPool.h
 $(DIR_O)/EditView.obj: \
 	../src/EditView.cxx \
 	../include/ScintillaTypes.h \
@@ -314,7 +328,8 @@ $(DIR_O)/EditView.obj: \
 	../src/EditModel.h \
 	../src/MarginView.h \
 	../src/EditView.h \
-	../src/ElapsedPeriod.h
+	../src/ElapsedPeriod.h \
+	../src/ThreadPool.h
 $(DIR_O)/Geometry.obj: \
 	../src/Geometry.cxx \
 	../src/Geometry.h
@@ -334,6 +349,12 @@ $(DIR_O)/KeyMap.obj: \
 	../src/Geometry.h \
 	../src/Platform.h \
 	../src/KeyMap.h
+$(DIR_O)/LinearRegex.obj: \
+	../src/LinearRegex.cxx \
+	../src/Position.h \
+	../src/CharClassify.h \
+	../src/UniConversion.h \
+	../src/LinearRegex.h
 $(DIR_O)/LineMarker.obj: \
 	../src/LineMarker.cxx \
 	../include/ScintillaTypes.h \
@@ -481,6 +502,9 @@ $(DIR_O)/Style.obj: \
 	../src/Geometry.h \
 	../src/Platform.h \
 	../src/Style.h
+$(DIR_O)/ThreadPool.obj: \
+	../src/ThreadPool.cxx \
+	../src/ThreadPool.h
 $(DIR_O)/UndoHistory.obj: \
 	../src/UndoHistory.cxx \
 	../include/ScintillaTypes.h \
@@ -384,6 +384,7 @@ SciTEIO.o: \
 	../src/FileWorker.h \
 	../src/MatchMarker.h \
 	../src/Searcher.h \
+	../src/StringSearch.h \
 	../src/SciTEBase.h
 SciTEProps.o: \
 	../src/SciTEProps.cxx \
@@ -424,6 +425,10 @@ StringList.o: \
 	../src/GUI.h \
 	../src/StringList.h \
 	../src/StringHelpers.h
+StringSearch.o: \
+	../src/StringSearch.cxx \
+	../src/StringHelpers.h \
+	../src/StringSearch.h
 StyleDefinition.o: \
 	../src/StyleDefinition.cxx \
 	../../scintilla/include/ScintillaTypes.h \
@@ -6,6 +6,7 @@
 // The License.txt file describes the conditions under which this software may be distributed.
 
 #include <cstdlib>
+#include <cstdint>
 #include <cstring>
 #include <cstdio>
 #include <ctime>
@@ -30,6 +31,7 @@
 #include <unistd.h>
 #include <dirent.h>
 #include <pwd.h>
+#include <sys/mman.h>
 
 #endif
 
@@ -705,6 +707,68 @@ bool FilePath::CaseSensitive() noexcept {
 #endif
 }
 
+FileMapping::FileMapping(const FilePath &path) noexcept {
+#ifdef _WIN32
+	HANDLE handleFile = ::CreateFileW(path.AsInternal(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+		nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (handleFile == INVALID_HANDLE_VALUE) {
+		return;
+	}
+	hFile = handleFile;
+	LARGE_INTEGER size {};
+	if (!::GetFileSizeEx(handleFile, &size) || size.QuadPart <= 0 ||
+		static_cast<unsigned long long>(size.QuadPart) > SIZE_MAX) {
+		return;
+	}
+	hMapping = ::CreateFileMappingW(handleFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!hMapping) {
+		return;
+	}
+	const void *view = ::MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+	if (view) {
+		data = static_cast<const char *>(view);
+		length = static_cast<size_t>(size.QuadPart);
+	}
+#else
+	fd = open(path.AsInternal(), O_RDONLY);
+	if (fd == -1) {
+		return;
+	}
+	struct stat statusFile;
+	if (fstat(fd, &statusFile) == -1 || statusFile.st_size <= 0) {
+		return;
+	}
+	void *view = mmap(nullptr, statusFile.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (view != MAP_FAILED) {
+		// Reading proceeds from start to end so ask for read-ahead
+		madvise(view, statusFile.st_size, MADV_SEQUENTIAL);
+		data = static_cast<const char *>(view);
+		length = statusFile.st_size;
+	}
+#endif
+}
+
+FileMapping::~FileMapping() noexcept {
+#ifdef _WIN32
+	if (data) {
+		::UnmapViewOfFile(data);
+	}
+	if (hMapping) {
+		::CloseHandle(hMapping);
+	}
+	if (hFile) {
+		::CloseHandle(hFile);
+	}
+#else
+	if (data) {
+		munmap(const_cast<char *>(data), length);
+	}
+	if (fd != -1) {
+		close(fd);
+	}
+#endif
+}
+
 // Find a path if it exists.
 // If path is not absolute, it is combined with dir.
 // Returns absolute path if it exists else nullopt.
@@ -83,6 +83,33 @@ public:
 	[[nodiscard]] static bool CaseSensitive() noexcept;
 };
 
+// Read-only memory mapping of a whole file so it can be read without copying.
+// View is empty if the file could not be mapped, which includes empty files.
+class FileMapping {
+#ifdef _WIN32
+	void *hFile = nullptr;
+	void *hMapping = nullptr;
+#else
+	int fd = -1;
+#endif
+	const char *data = nullptr;
+	size_t length = 0;
+public:
+	explicit FileMapping(const FilePath &path) noexcept;
+	// Deleted so FileMapping objects can not be copied.
+	FileMapping(const FileMapping &) = delete;
+	FileMapping(FileMapping &&) = delete;
+	FileMapping &operator=(const FileMapping &) = delete;
+	FileMapping &operator=(FileMapping &&) = delete;
+	~FileMapping() noexcept;
+	[[nodiscard]] bool Mapped() const noexcept {
+		return data != nullptr;
+	}
+	[[nodiscard]] std::string_view View() const noexcept {
+		return std::string_view(data, length);
+	}
+};
+
 std::optional<FilePath> FindPath(GUI::gui_string_view path, const FilePath &dir);
 
 std::string CommandExecute(const GUI::gui_char *command, const GUI::gui_char *directoryForRun);
@@ -44,8 +44,10 @@ double FileWorker::Duration() noexcept {
 	return et.Duration();
 }
 
-FileLoader::FileLoader(WorkerListener *pListener_, Scintilla::ILoader *pLoader_, const FilePath &path_, size_t size_, FILE *fp_) :
-	FileWorker(pListener_, path_, size_, fp_), pLoader(pLoader_), readSoFar(0), unicodeMode(UniMode::uni8Bit) {
+FileLoader::FileLoader(WorkerListener *pListener_, Scintilla::ILoader *pLoader_, const FilePath &path_, size_t size_, FILE *fp_,
+	std::unique_ptr<FileMapping> mapping_) :
+	FileWorker(pListener_, path_, size_, fp_), pLoader(pLoader_), readSoFar(0), unicodeMode(UniMode::uni8Bit),
+	mapping(std::move(mapping_)) {
 	SetSizeJob(size);
 }
 
@@ -53,18 +55,37 @@ void FileLoader::Execute() noexcept {
 	try {
 		if (fp) {
 			std::unique_ptr<Utf8_16::Reader> convert = Utf8_16::Reader::Allocate();
-			std::vector<char> data(blockSize);
-			size_t lenFile = fread(data.data(), 1, data.size(), fp);
-			while ((lenFile > 0) && (err == 0) && (!Cancelling())) {
-				GUI::SleepMilliseconds(sleepTime);
-				const std::string_view converted = convert->convert(std::string_view(data.data(), lenFile));
-				err = pLoader->AddData(converted.data(), converted.size());
-				IncrementProgress(lenFile);
-				if (et.Duration() > nextProgress) {
-					nextProgress = et.Duration() + timeBetweenProgress;
-					pListener->PostOnMainThread(WORK_FILEPROGRESS, this);
+			if (mapping && mapping->Mapped()) {
+				// 8-bit and UTF-8 pass through the converter unchanged so are added directly
+				// from the mapping. Only UTF-16 is converted into the converter's buffer.
+				std::string_view remaining = mapping->View();
+				while (!remaining.empty() && (err == 0) && (!Cancelling())) {
+					GUI::SleepMilliseconds(sleepTime);
+					const std::string_view block = remaining.substr(0, mappedBlockSize);
+					const std::string_view converted = convert->convert(block);
+					err = pLoader->AddData(converted.data(), converted.size());
+					IncrementProgress(block.size());
+					if (et.Duration() > nextProgress) {
+						nextProgress = et.Duration() + timeBetweenProgress;
+						pListener->PostOnMainThread(WORK_FILEPROGRESS, this);
+					}
+					remaining.remove_prefix(block.size());
+				}
+				mapping.reset();
+			} else {
+				std::vector<char> data(blockSize);
+				size_t lenFile = fread(data.data(), 1, data.size(), fp);
+				while ((lenFile > 0) && (err == 0) && (!Cancelling())) {
+					GUI::SleepMilliseconds(sleepTime);
+					const std::string_view converted = convert->convert(std::string_view(data.data(), lenFile));
+					err = pLoader->AddData(converted.data(), converted.size());
+					IncrementProgress(lenFile);
+					if (et.Duration() > nextProgress) {
+						nextProgress = et.Duration() + timeBetweenProgress;
+						pListener->PostOnMainThread(WORK_FILEPROGRESS, this);
+					}
+					lenFile = fread(data.data(), 1, data.size(), fp);
 				}
-				lenFile = fread(data.data(), 1, data.size(), fp);
 			}
 			fclose(fp);
 			fp = nullptr;
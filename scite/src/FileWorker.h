@@ -10,6 +10,8 @@
 
 /// Base size of file I/O operations.
 constexpr size_t blockSize = 128 * 1024;
+/// Size of each addition from a memory mapped file, larger as there is no copy into a buffer.
+constexpr size_t mappedBlockSize = 32 * blockSize;
 
 struct FileWorker : public Worker {
 	WorkerListener *pListener;
@@ -35,8 +37,10 @@ public:
 	Scintilla::ILoader *pLoader;
 	size_t readSoFar;
 	UniMode unicodeMode;
+	std::unique_ptr<FileMapping> mapping;
 
-	FileLoader(WorkerListener *pListener_, Scintilla::ILoader *pLoader_, const FilePath &path_, size_t size_, FILE *fp_);
+	FileLoader(WorkerListener *pListener_, Scintilla::ILoader *pLoader_, const FilePath &path_, size_t size_, FILE *fp_,
+		std::unique_ptr<FileMapping> mapping_=nullptr);
 	void Execute() noexcept override;
 	void Cancel() noexcept override;
 	bool IsLoading() const noexcept override {
@@ -2575,8 +2575,10 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCE_ZIG_STRING",7},
 	{"SCE_ZIG_STRINGEOL",18},
 	{"SCFIND_CXX11REGEX",0x00800000},
+	{"SCFIND_LINEARREGEX",0x01000000},
 	{"SCFIND_MATCHCASE",0x4},
 	{"SCFIND_NONE",0x0},
+	{"SCFIND_PARALLEL",0x02000000},
 	{"SCFIND_POSIX",0x00400000},
 	{"SCFIND_REGEXP",0x00200000},
 	{"SCFIND_WHOLEWORD",0x2},
@@ -2672,6 +2674,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_GETCHARACTERCATEGORYOPTIMIZATION",2721},
 	{"SCI_GETCHARACTERPOINTER",2520},
 	{"SCI_GETCHARAT",2007},
+	{"SCI_GETCHUNKEDLAYOUTLENGTH",2838},
 	{"SCI_GETCODEPAGE",2137},
 	{"SCI_GETCOLUMN",2129},
 	{"SCI_GETCOMMANDEVENTS",2718},
@@ -2691,6 +2694,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_GETENDATLASTLINE",2278},
 	{"SCI_GETENDSTYLED",2028},
 	{"SCI_GETEOLMODE",2030},
+	{"SCI_GETESTIMATEWRAPHEIGHTS",2840},
 	{"SCI_GETEXTRAASCENT",2526},
 	{"SCI_GETEXTRADESCENT",2528},
 	{"SCI_GETFIRSTVISIBLELINE",2152},
@@ -2700,6 +2704,8 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_GETFOLDPARENT",2225},
 	{"SCI_GETFONTLOCALE",2761},
 	{"SCI_GETFONTQUALITY",2612},
+	{"SCI_GETFOUNDEND",2829},
+	{"SCI_GETFOUNDSTART",2828},
 	{"SCI_GETGAPPOSITION",2644},
 	{"SCI_GETHIGHLIGHTGUIDE",2135},
 	{"SCI_GETHOTSPOTACTIVEUNDERLINE",2496},
@@ -2707,6 +2713,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_GETHSCROLLBAR",2131},
 	{"SCI_GETIDENTIFIER",2623},
 	{"SCI_GETIDLESTYLING",2693},
+	{"SCI_GETIDLEWRAPPING",2823},
 	{"SCI_GETIMEINTERACTION",2678},
 	{"SCI_GETINDENT",2123},
 	{"SCI_GETINDENTATIONGUIDES",2133},
@@ -2717,6 +2724,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_GETLENGTH",2006},
 	{"SCI_GETLEXER",4002},
 	{"SCI_GETLEXERLANGUAGE",4012},
+	{"SCI_GETLINEBITMAPCACHE",2836},
 	{"SCI_GETLINECHARACTERINDEX",2710},
 	{"SCI_GETLINECOUNT",2154},
 	{"SCI_GETLINEENDPOSITION",2136},
@@ -2754,6 +2762,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_GETPASTECONVERTENDINGS",2468},
 	{"SCI_GETPHASESDRAW",2673},
 	{"SCI_GETPOSITIONCACHE",2515},
+	{"SCI_GETPOSITIONCACHESHARED",2834},
 	{"SCI_GETPRIMARYSTYLEFROMSTYLE",4028},
 	{"SCI_GETPRINTCOLOURMODE",2149},
 	{"SCI_GETPRINTMAGNIFICATION",2147},
@@ -2907,6 +2916,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_SETCARETWIDTH",2188},
 	{"SCI_SETCHANGEHISTORY",2780},
 	{"SCI_SETCHARACTERCATEGORYOPTIMIZATION",2720},
+	{"SCI_SETCHUNKEDLAYOUTLENGTH",2837},
 	{"SCI_SETCODEPAGE",2037},
 	{"SCI_SETCOMMANDEVENTS",2717},
 	{"SCI_SETCONTROLCHARSYMBOL",2388},
@@ -2920,6 +2930,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_SETEDGEMODE",2363},
 	{"SCI_SETENDATLASTLINE",2277},
 	{"SCI_SETEOLMODE",2031},
+	{"SCI_SETESTIMATEWRAPHEIGHTS",2839},
 	{"SCI_SETEXTRAASCENT",2525},
 	{"SCI_SETEXTRADESCENT",2527},
 	{"SCI_SETFIRSTVISIBLELINE",2613},
@@ -2936,6 +2947,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_SETIDENTIFIER",2622},
 	{"SCI_SETIDENTIFIERS",4024},
 	{"SCI_SETIDLESTYLING",2692},
+	{"SCI_SETIDLEWRAPPING",2822},
 	{"SCI_SETILEXER",4033},
 	{"SCI_SETIMEINTERACTION",2679},
 	{"SCI_SETINDENT",2122},
@@ -2945,6 +2957,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_SETKEYWORDS",4005},
 	{"SCI_SETLAYOUTCACHE",2272},
 	{"SCI_SETLAYOUTTHREADS",2775},
+	{"SCI_SETLINEBITMAPCACHE",2835},
 	{"SCI_SETLINEENDTYPESALLOWED",2656},
 	{"SCI_SETLINEINDENTATION",2126},
 	{"SCI_SETLINESTATE",2092},
@@ -2971,6 +2984,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SCI_SETPASTECONVERTENDINGS",2467},
 	{"SCI_SETPHASESDRAW",2674},
 	{"SCI_SETPOSITIONCACHE",2514},
+	{"SCI_SETPOSITIONCACHESHARED",2833},
 	{"SCI_SETPRINTCOLOURMODE",2148},
 	{"SCI_SETPRINTMAGNIFICATION",2146},
 	{"SCI_SETPRINTWRAPMODE",2406},
@@ -3318,6 +3332,7 @@ static IFaceConstant ifaceConstants[] = {
 	{"SC_CURSORREVERSEARROW",7},
 	{"SC_CURSORWAIT",4},
 	{"SC_DOCUMENTOPTION_DEFAULT",0},
+	{"SC_DOCUMENTOPTION_PIECE_TREE",0x200},
 	{"SC_DOCUMENTOPTION_STYLES_NONE",0x1},
 	{"SC_DOCUMENTOPTION_TEXT_LARGE",0x100},
 	{"SC_EFF_QUALITY_ANTIALIASED",2},
@@ -3373,8 +3388,11 @@ static IFaceConstant ifaceConstants[] = {
 	{"SC_FONT_SIZE_MULTIPLIER",100},
 	{"SC_IDLESTYLING_AFTERVISIBLE",2},
 	{"SC_IDLESTYLING_ALL",3},
+	{"SC_IDLESTYLING_BACKGROUND",4},
 	{"SC_IDLESTYLING_NONE",0},
 	{"SC_IDLESTYLING_TOVISIBLE",1},
+	{"SC_IDLEWRAPPING_BACKGROUND",1},
+	{"SC_IDLEWRAPPING_INCREMENTAL",0},
 	{"SC_IME_INLINE",1},
 	{"SC_IME_WINDOWED",0},
 	{"SC_INDICFLAG_NONE",0},
@@ -3389,6 +3407,11 @@ static IFaceConstant ifaceConstants[] = {
 	{"SC_LAYER_BASE",0},
 	{"SC_LAYER_OVER_TEXT",2},
 	{"SC_LAYER_UNDER_TEXT",1},
+	{"SC_LAYOUTTHREADSTATISTIC_IDLEMICROSECONDS",4},
+	{"SC_LAYOUTTHREADSTATISTIC_RUNS",0},
+	{"SC_LAYOUTTHREADSTATISTIC_TASKS",1},
+	{"SC_LAYOUTTHREADSTATISTIC_THREADSCREATED",3},
+	{"SC_LAYOUTTHREADSTATISTIC_WORKERTASKS",2},
 	{"SC_LINECHARACTERINDEX_NONE",0},
 	{"SC_LINECHARACTERINDEX_UTF16",2},
 	{"SC_LINECHARACTERINDEX_UTF32",1},
@@ -3488,6 +3511,9 @@ static IFaceConstant ifaceConstants[] = {
 	{"SC_POPUP_ALL",1},
 	{"SC_POPUP_NEVER",0},
 	{"SC_POPUP_TEXT",2},
+	{"SC_POSITIONCACHESTATISTIC_EVICTIONS",2},
+	{"SC_POSITIONCACHESTATISTIC_HITS",0},
+	{"SC_POSITIONCACHESTATISTIC_MISSES",1},
 	{"SC_PRINT_BLACKONWHITE",2},
 	{"SC_PRINT_COLOURONWHITE",3},
 	{"SC_PRINT_COLOURONWHITEDEFAULTBG",4},
@@ -3630,6 +3656,8 @@ static IFaceFunction ifaceFunctions[] = {
 	{"ClearAllRepresentations", 2770, iface_void, {iface_void, iface_void}},
 	{"ClearCmdKey", 2071, iface_void, {iface_keymod, iface_void}},
 	{"ClearDocumentStyle", 2005, iface_void, {iface_void, iface_void}},
+	{"ClearLayoutThreadStatistics", 2825, iface_void, {iface_void, iface_void}},
+	{"ClearPositionCacheStatistics", 2832, iface_void, {iface_void, iface_void}},
 	{"ClearRegisteredImages", 2408, iface_void, {iface_void, iface_void}},
 	{"ClearRepresentation", 2667, iface_void, {iface_string, iface_void}},
 	{"ClearSelections", 2571, iface_void, {iface_void, iface_void}},
@@ -3641,6 +3669,7 @@ static IFaceFunction ifaceFunctions[] = {
 	{"CopyAllowLine", 2519, iface_void, {iface_void, iface_void}},
 	{"CopyRange", 2419, iface_void, {iface_position, iface_position}},
 	{"CopyText", 2420, iface_void, {iface_length, iface_string}},
+	{"CountAllInTarget", 2827, iface_position, {iface_position, iface_string}},
 	{"CountCharacters", 2633, iface_position, {iface_position, iface_position}},
 	{"CountCodeUnits", 2715, iface_position, {iface_position, iface_position}},
 	{"CreateDocument", 2375, iface_pointer, {iface_position, iface_int}},
@@ -3672,6 +3701,7 @@ static IFaceFunction ifaceFunctions[] = {
 	{"EnsureVisible", 2232, iface_void, {iface_line, iface_void}},
 	{"EnsureVisibleEnforcePolicy", 2234, iface_void, {iface_line, iface_void}},
 	{"ExpandChildren", 2239, iface_void, {iface_line, iface_int}},
+	{"FindAllInTarget", 2826, iface_position, {iface_position, iface_string}},
 	{"FindColumn", 2456, iface_position, {iface_line, iface_position}},
 	{"FindIndicatorFlash", 2641, iface_void, {iface_position, iface_position}},
 	{"FindIndicatorHide", 2642, iface_void, {iface_void, iface_void}},
@@ -3694,10 +3724,12 @@ static IFaceFunction ifaceFunctions[] = {
 	{"GetHotspotActiveBack", 2495, iface_colour, {iface_void, iface_void}},
 	{"GetHotspotActiveFore", 2494, iface_colour, {iface_void, iface_void}},
 	{"GetLastChild", 2224, iface_line, {iface_line, iface_int}},
+	{"GetLayoutThreadStatistic", 2824, iface_position, {iface_int, iface_void}},
 	{"GetLine", 2153, iface_position, {iface_line, iface_stringresult}},
 	{"GetLineSelEndPosition", 2425, iface_position, {iface_line, iface_void}},
 	{"GetLineSelStartPosition", 2424, iface_position, {iface_line, iface_void}},
 	{"GetNextTabStop", 2677, iface_int, {iface_line, iface_int}},
+	{"GetPositionCacheStatistic", 2831, iface_position, {iface_int, iface_void}},
 	{"GetPropertyInt", 4010, iface_int, {iface_string, iface_int}},
 	{"GetRangePointer", 2643, iface_pointer, {iface_position, iface_position}},
 	{"GetSelText", 2161, iface_position, {iface_void, iface_stringresult}},
@@ -3722,6 +3754,7 @@ static IFaceFunction ifaceFunctions[] = {
 	{"IndicatorAllOnFor", 2506, iface_int, {iface_position, iface_void}},
 	{"IndicatorClearRange", 2505, iface_void, {iface_position, iface_position}},
 	{"IndicatorEnd", 2509, iface_position, {iface_int, iface_position}},
+	{"IndicatorFillFound", 2830, iface_void, {iface_void, iface_void}},
 	{"IndicatorFillRange", 2504, iface_void, {iface_position, iface_position}},
 	{"IndicatorStart", 2508, iface_position, {iface_int, iface_position}},
 	{"IndicatorValueAt", 2507, iface_int, {iface_int, iface_position}},
@@ -3972,6 +4005,7 @@ static IFaceProperty ifaceProperties[] = {
 	{"CharAt", 2007, 0, iface_int, iface_position},
 	{"CharacterCategoryOptimization", 2721, 2720, iface_int, iface_void},
 	{"CharacterPointer", 2520, 0, iface_pointer, iface_void},
+	{"ChunkedLayoutLength", 2838, 2837, iface_position, iface_void},
 	{"CodePage", 2137, 2037, iface_int, iface_void},
 	{"Column", 2129, 0, iface_position, iface_position},
 	{"CommandEvents", 2718, 2717, iface_bool, iface_void},
@@ -3996,6 +4030,7 @@ static IFaceProperty ifaceProperties[] = {
 	{"EdgeMode", 2362, 2363, iface_int, iface_void},
 	{"EndAtLastLine", 2278, 2277, iface_bool, iface_void},
 	{"EndStyled", 2028, 0, iface_position, iface_void},
+	{"EstimateWrapHeights", 2840, 2839, iface_bool, iface_void},
 	{"ExtraAscent", 2526, 2525, iface_int, iface_void},
 	{"ExtraDescent", 2528, 2527, iface_int, iface_void},
 	{"FirstVisibleLine", 2152, 2613, iface_line, iface_void},
@@ -4007,6 +4042,8 @@ static IFaceProperty ifaceProperties[] = {
 	{"FoldParent", 2225, 0, iface_line, iface_line},
 	{"FontLocale", 2761, 2760, iface_stringresult, iface_void},
 	{"FontQuality", 2612, 2611, iface_int, iface_void},
+	{"FoundEnd", 2829, 0, iface_position, iface_position},
+	{"FoundStart", 2828, 0, iface_position, iface_position},
 	{"GapPosition", 2644, 0, iface_position, iface_void},
 	{"HScrollBar", 2131, 2130, iface_bool, iface_void},
 	{"HighlightGuide", 2135, 2134, iface_position, iface_void},
@@ -4017,6 +4054,7 @@ static IFaceProperty ifaceProperties[] = {
 	{"Identifier", 2623, 2622, iface_int, iface_void},
 	{"Identifiers", 0, 4024, iface_string, iface_int},
 	{"IdleStyling", 2693, 2692, iface_int, iface_void},
+	{"IdleWrapping", 2823, 2822, iface_int, iface_void},
 	{"Indent", 2123, 2122, iface_int, iface_void},
 	{"IndentationGuides", 2133, 2132, iface_int, iface_void},
 	{"IndicAlpha", 2524, 2523, iface_int, iface_int},
@@ -4036,6 +4074,7 @@ static IFaceProperty ifaceProperties[] = {
 	{"Length", 2006, 0, iface_position, iface_void},
 	{"Lexer", 4002, 0, iface_int, iface_void},
 	{"LexerLanguage", 4012, 0, iface_stringresult, iface_void},
+	{"LineBitmapCache", 2836, 2835, iface_int, iface_void},
 	{"LineCharacterIndex", 2710, 0, iface_int, iface_void},
 	{"LineCount", 2154, 0, iface_line, iface_void},
 	{"LineEndPosition", 2136, 0, iface_position, iface_line},
@@ -4087,6 +4126,7 @@ static IFaceProperty ifaceProperties[] = {
 	{"PasteConvertEndings", 2468, 2467, iface_bool, iface_void},
 	{"PhasesDraw", 2673, 2674, iface_int, iface_void},
 	{"PositionCache", 2515, 2514, iface_int, iface_void},
+	{"PositionCacheShared", 2834, 2833, iface_bool, iface_void},
 	{"PrimaryStyleFromStyle", 4028, 0, iface_int, iface_int},
 	{"PrintColourMode", 2149, 2148, iface_int, iface_void},
 	{"PrintMagnification", 2147, 2146, iface_int, iface_void},
@@ -4195,9 +4235,9 @@ static IFaceProperty ifaceProperties[] = {
 };
 
 enum {
-	ifaceFunctionCount = 333,
-	ifaceConstantCount = 3444,
-	ifacePropertyCount = 281
+	ifaceFunctionCount = 340,
+	ifaceConstantCount = 3470,
+	ifacePropertyCount = 288
 };
 
 //--Autogenerated
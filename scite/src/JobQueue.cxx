@@ -261,7 +261,7 @@ bool JobQueue::SetCancelFlag(bool value) {
 	return cancelFlagPrevious;
 }
 
-bool JobQueue::Cancelled() noexcept {
+bool JobQueue::Cancelled() const noexcept {
 	return cancelFlag;
 }
 
@@ -79,7 +79,7 @@ public:
 	void SetExecuting(bool state) noexcept;
 	bool HasCommandToRun() const noexcept;
 	bool SetCancelFlag(bool value);
-	bool Cancelled() noexcept;
+	bool Cancelled() const noexcept;
 
 	void ClearJobs() noexcept;
 	void AddCommand(std::string_view command, const FilePath &directory, JobSubsystem jobType, std::string_view input, int flags);
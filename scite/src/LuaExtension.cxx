@@ -17,6 +17,7 @@
 #include <set>
 #include <optional>
 #include <memory>
+#include <algorithm>
 #include <chrono>
 
 #include "ScintillaTypes.h"
@@ -378,6 +379,20 @@ ExtensionAPI::Pane check_pane_object(lua_State *L, int index) {
 	return ExtensionAPI::paneOutput; // this line never reached
 }
 
+// Push the text of a range read directly from the document rather than through
+// an intermediate std::string.
+void push_range(lua_State *L, SA::ScintillaCall &sc, SA::Span range) {
+	const SA::Position lengthDoc = sc.Length();
+	range.start = std::clamp<SA::Position>(range.start, 0, lengthDoc);
+	range.end = std::clamp<SA::Position>(range.end, range.start, lengthDoc);
+	if (range.Length() == 0) {
+		lua_pushliteral(L, "");
+		return;
+	}
+	const char *text = static_cast<const char *>(sc.RangePointer(range.start, range.Length()));
+	lua_pushlstring(L, text, range.Length());
+}
+
 int cf_pane_textrange(lua_State *L) {
 	const ExtensionAPI::Pane p = check_pane_object(L, 1);
 
@@ -385,8 +400,7 @@ int cf_pane_textrange(lua_State *L) {
 		const SA::Position cpMin = luaL_checkinteger(L, 2);
 		const SA::Position cpMax = luaL_checkinteger(L, 3);
 		if (cpMax >= 0) {
-			std::string range = host->Range(p, SA::Span(cpMin, cpMax));
-			push_string(L, range);
+			push_range(L, host->PaneCaller(p), SA::Span(cpMin, cpMax));
 			return 1;
 		}
 		raise_error(L, "Invalid argument 2 for <pane>:textrange.  Positive number or zero expected.");
@@ -474,6 +488,42 @@ int cf_pane_findtext(lua_State *L) {
 	return 0;
 }
 
+int cf_pane_findall(lua_State *L) {
+	const ExtensionAPI::Pane p = check_pane_object(L, 1);
+	size_t lengthText = 0;
+	const char *t = luaL_checklstring(L, 2, &lengthText);
+	if (strlen(t) != lengthText) {
+		raise_error(L, "Text for <pane>:findall must not contain NUL characters.");
+		return 0;
+	}
+	const int flags = luaL_optint(L, 3, 0);
+	SA::ScintillaCall &sc = host->PaneCaller(p);
+	const SA::Position lengthDoc = sc.Length();
+	const SA::Position rangeStart = std::clamp<SA::Position>(luaL_optinteger(L, 4, 0), 0, lengthDoc);
+	const SA::Position rangeEnd = std::clamp<SA::Position>(luaL_optinteger(L, 5, lengthDoc), 0, lengthDoc);
+
+	// All matches are found by one SCI_FINDALLINTARGET and returned as a table of
+	// alternating start and end positions.
+	// The script's target and search flags are restored so findall does not disturb
+	// calls like ReplaceTarget.
+	const SA::Position targetStart = sc.TargetStart();
+	const SA::Position targetEnd = sc.TargetEnd();
+	const SA::FindOption searchFlags = sc.SearchFlags();
+	sc.SetTargetRange(rangeStart, rangeEnd);
+	sc.SetSearchFlags(static_cast<SA::FindOption>(flags));
+	const SA::Position matches = sc.FindAllInTarget(0, t);
+	sc.SetTargetRange(targetStart, targetEnd);
+	sc.SetSearchFlags(searchFlags);
+	lua_createtable(L, static_cast<int>(std::max<SA::Position>(matches, 0) * 2), 0);
+	for (SA::Position match = 0; match < matches; match++) {
+		lua_pushinteger(L, sc.FoundStart(match));
+		lua_rawseti(L, -2, match * 2 + 1);
+		lua_pushinteger(L, sc.FoundEnd(match));
+		lua_rawseti(L, -2, match * 2 + 2);
+	}
+	return 1;
+}
+
 // Pane match generator.  This was prototyped in about 30 lines of Lua.
 // I hope the C++ version is more robust at least, e.g. prevents infinite
 // loops and is more tamper-resistant.
@@ -536,8 +586,7 @@ int cf_match_metatable_index(lua_State *L) {
 			// If the document is changed while in the match loop, this will be broken.
 			// Exception: if the changes are made exclusively through match:replace,
 			// everything will be fine.
-			const std::string range = host->Range(pmo->pane, pmo->range);
-			push_string(L, range);
+			push_range(L, host->PaneCaller(pmo->pane), pmo->range);
 			return 1;
 		} else if (0 == strcmp(key, "replace")) {
 			constexpr int replaceMethodIndex = lua_upvalueindex(1);
@@ -1177,6 +1226,8 @@ void push_pane_object(lua_State *L, ExtensionAPI::Pane p) noexcept {
 		lua_setfield(L, -2, "findtext");
 		lua_pushcfunction(L, cf_pane_textrange);
 		lua_setfield(L, -2, "textrange");
+		lua_pushcfunction(L, cf_pane_findall);
+		lua_setfield(L, -2, "findall");
 		lua_pushcfunction(L, cf_pane_insert);
 		lua_setfield(L, -2, "insert");
 		lua_pushcfunction(L, cf_pane_remove);
@@ -1838,22 +1889,28 @@ struct StylingContext {
 	}
 
 	void StartStyling(SA::Position startPos_, SA::Position length, int initStyle_) {
+		// Styles from an earlier StartStyling or SetStyleRuns were for a different position
+		styler->Flush();
 		endDoc = styler->Length();
 		endPos = startPos_ + length;
 		if (endPos == endDoc)
 			endPos = endDoc + 1;
-		currentPos = startPos_;
-		atLineStart = true;
-		atLineEnd = false;
 		state = initStyle_;
+		styler->StartAt(startPos_);
+		styler->StartSegment(startPos_);
+		SetCursor(startPos_, true);
+	}
+
+	void SetCursor(SA::Position position, bool lineStart) {
+		currentPos = position;
+		atLineStart = lineStart;
+		atLineEnd = false;
 		cursorPos = 0;
 		lenCurrent = 0;
 		lenNext = 0;
 		memcpy(cursor[0], "\0\0\0\0\0\0\0\0", 8);
 		memcpy(cursor[1], "\0\0\0\0\0\0\0\0", 8);
 		memcpy(cursor[2], "\0\0\0\0\0\0\0\0", 8);
-		styler->StartAt(startPos_);
-		styler->StartSegment(startPos_);
 
 		GetNextChar();
 		cursorPos++;
@@ -1980,6 +2037,46 @@ struct StylingContext {
 		return 1;
 	}
 
+	static int Text(lua_State *L) {
+		StylingContext *context = Context(L);
+		const SA::Position position = luaL_checkinteger(L, 2);
+		const SA::Position length = luaL_checkinteger(L, 3);
+		push_string(L, context->styler->GetRange(position, position + length));
+		return 1;
+	}
+
+	static int SetStyleRuns(lua_State *L) {
+		// Runs are a table of alternating lengths and styles
+		StylingContext *context = Context(L);
+		luaL_checktype(L, 3, LUA_TTABLE);
+		// Send any styles still buffered as StartAt moves the styling position immediately
+		context->styler->Flush();
+		const SA::Position endDocument = context->styler->Length();
+		SA::Position position = std::clamp<SA::Position>(luaL_checkinteger(L, 2), 0, endDocument);
+		context->styler->StartAt(position);
+		context->styler->StartSegment(position);
+		const lua_Integer lengthRuns = lua_rawlen(L, 3);
+		for (lua_Integer i = 1; i < lengthRuns; i += 2) {
+			lua_rawgeti(L, 3, i);
+			lua_rawgeti(L, 3, i + 1);
+			const SA::Position lengthRun = lua_tointeger(L, -2);
+			const int style = static_cast<int>(lua_tointeger(L, -1));
+			lua_pop(L, 2);
+			if (lengthRun > 0) {
+				position = std::min(position + lengthRun, endDocument);
+				context->styler->ColourTo(position - 1, style);
+			}
+		}
+		if (position > context->currentPos) {
+			// Continue from after the runs so Colourize does not style backwards
+			const char chPrevious = context->styler->SafeGetCharAt(position - 1);
+			const bool lineStart = (chPrevious == '\n') ||
+				((chPrevious == '\r') && (context->styler->SafeGetCharAt(position) != '\n'));
+			context->SetCursor(position, lineStart);
+		}
+		return 0;
+	}
+
 	bool Match(const char *s) {
 		for (SA::Position n=0; *s; n++) {
 			if (*s != styler->SafeGetCharAt(currentPos+n))
@@ -2041,6 +2138,8 @@ bool LuaExtension::OnStyle(SA::Position startPos, SA::Position lengthDoc, int in
 			sc.PushMethod(luaState, StylingContext::SetLevelAt, "SetLevelAt");
 			sc.PushMethod(luaState, StylingContext::LineState, "LineState");
 			sc.PushMethod(luaState, StylingContext::SetLineState, "SetLineState");
+			sc.PushMethod(luaState, StylingContext::Text, "Text");
+			sc.PushMethod(luaState, StylingContext::SetStyleRuns, "SetStyleRuns");
 
 			sc.PushMethod(luaState, StylingContext::StartStyling, "StartStyling");
 			sc.PushMethod(luaState, StylingContext::EndStyling, "EndStyling");
@@ -98,36 +98,32 @@ void MatchMarker::Continue() {
 	//Monitor the amount of time took by the search.
 	GUI::ElapsedTime searchElapsedTime;
 
-	SA::Position matchPrevious = SA::InvalidPosition;
-
-	// Find the first occurrence of word.
-	SA::Span rangeFound = pSci->SpanSearchInTarget(textMatch);
-	while ((rangeFound.start >= 0) && (rangeFound.start != matchPrevious)) {
-		matchPrevious = rangeFound.start;
-		if (searchElapsedTime.Duration() > maxDuration) {
-			// Clear all indicators because timer has expired.
-			pSci->IndicatorClearRange(0, pSci->Length());
-			lineRanges.clear();
-			break;
-		}
-
-		if ((styleMatch < 0) || (styleMatch == pSci->UnsignedStyleAt(rangeFound.start))) {
-			pSci->IndicatorFillRange(rangeFound.start, rangeFound.Length());
-			const SA::Line line = pSci->LineFromPosition(rangeFound.start);
-			if ((bookMark >= 0) && (showContext != 0)) {
-				pSci->MarkerAdd(line, bookMark);
+	// Find every occurrence of word in the segment with one call.
+	const SA::Position matchCount = pSci->FindAllInTarget(0, textMatch.c_str());
+	const bool markLines = ((bookMark >= 0) && (showContext != 0)) || (showContext >= 0);
+	if ((styleMatch < 0) && !markLines) {
+		pSci->IndicatorFillFound();
+	} else {
+		for (SA::Position match = 0; match < matchCount; match++) {
+			if (searchElapsedTime.Duration() > maxDuration) {
+				// Clear all indicators because timer has expired.
+				pSci->IndicatorClearRange(0, pSci->Length());
+				lineRanges.clear();
+				break;
 			}
-			if (showContext >= 0) {
-				matches.insert(line);
+
+			const SA::Position start = pSci->FoundStart(match);
+			if ((styleMatch < 0) || (styleMatch == pSci->UnsignedStyleAt(start))) {
+				pSci->IndicatorFillRange(start, pSci->FoundEnd(match) - start);
+				const SA::Line line = pSci->LineFromPosition(start);
+				if ((bookMark >= 0) && (showContext != 0)) {
+					pSci->MarkerAdd(line, bookMark);
+				}
+				if (showContext >= 0) {
+					matches.insert(line);
+				}
 			}
 		}
-		if (rangeFound.Length() == 0) {
-			// Empty matches are possible for regex
-			rangeFound.end = pSci->PositionAfter(rangeFound.end);
-		}
-		// Try to find next occurrence of word.
-		pSci->SetTarget(SA::Span(rangeFound.end, positionEnd));
-		rangeFound = pSci->SpanSearchInTarget(textMatch);
 	}
 
 	// Retire searched lines
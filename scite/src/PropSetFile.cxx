@@ -59,14 +59,47 @@ bool ImportFilter::IsValid(const std::string &name) const {
 }
 
 bool PropSetFile::caseSensitiveFilenames = false;
+unsigned int PropSetFile::wildGeneration = 0;
+std::set<std::string, std::less<>> PropSetFile::wildDependencies;
 
 PropSetFile::PropSetFile(bool lowerKeys_) : lowerKeys(lowerKeys_), superPS(nullptr) {
 }
 
+PropSetFile::PropSetFile(const PropSetFile &other) : lowerKeys(other.lowerKeys), props(other.props), superPS(other.superPS) {
+}
+
+PropSetFile &PropSetFile::operator=(const PropSetFile &other) {
+	if (this != &other) {
+		lowerKeys = other.lowerKeys;
+		superPS = other.superPS;
+		// Update in place as GetWild caches point at values in props
+		for (mapss::iterator it = props.begin(); it != props.end();) {
+			if (other.props.contains(it->first)) {
+				++it;
+			} else {
+				Changed(it->first);
+				it = props.erase(it);
+			}
+		}
+		for (const auto &[key, val] : other.props) {
+			Set(key, val);
+		}
+	}
+	return *this;
+}
+
 void PropSetFile::Set(std::string_view key, std::string_view val) {
 	if (key.empty())	// Empty keys are not supported
 		return;
-	props[std::string(key)] = std::string(val);
+	const mapss::iterator keyPos = props.find(key);
+	if (keyPos == props.end()) {
+		props.emplace(key, val);
+	} else if (keyPos->second != val) {
+		keyPos->second = val;
+	} else {
+		return;
+	}
+	Changed(key);
 }
 
 void PropSetFile::SetPath(std::string_view key, const FilePath &path) {
@@ -104,14 +137,36 @@ void PropSetFile::Unset(std::string_view key) {
 	if (key.empty())	// Empty keys are not supported
 		return;
 	const mapss::iterator keyPos = props.find(key);
-	if (keyPos != props.end())
+	if (keyPos != props.end()) {
 		props.erase(keyPos);
+		Changed(key);
+	}
 }
 
 void PropSetFile::Clear() noexcept {
+	// Only forget GetWild results that depend on a removed key
+	for (const auto &[key, val] : props) {
+		Changed(key);
+	}
 	props.clear();
 }
 
+void PropSetFile::Changed(std::string_view key) noexcept {
+	// A key may match a remembered key base as a prefix or be a variable used to expand file patterns
+	for (size_t length = key.length(); length > 0; length--) {
+		if (wildDependencies.contains(key.substr(0, length))) {
+			InvalidateWild();
+			return;
+		}
+	}
+}
+
+void PropSetFile::InvalidateWild() noexcept {
+	// Each PropSetFile notices the new generation and empties its cache on its next GetWild
+	wildGeneration++;
+	wildDependencies.clear();
+}
+
 bool PropSetFile::Exists(std::string_view key) const {
 	const mapss::const_iterator keyPos = props.find(key);
 	if (keyPos != props.end()) {
@@ -265,7 +320,8 @@ struct VarChain {
 	const VarChain *link = nullptr;
 };
 
-int ExpandAllInPlace(const PropSetFile &props, std::string &withVars, int maxExpands, const VarChain &blankVars = VarChain()) {
+int ExpandAllInPlace(const PropSetFile &props, std::string &withVars, int maxExpands, const VarChain &blankVars = VarChain(),
+	std::vector<std::string> *variables = nullptr) {
 	size_t varStart = withVars.find("$(");
 	while ((varStart != std::string::npos) && (maxExpands > 0)) {
 		const size_t varEnd = withVars.find(')', varStart + 2);
@@ -282,6 +338,9 @@ int ExpandAllInPlace(const PropSetFile &props, std::string &withVars, int maxExp
 		}
 
 		std::string var(withVars, varStart + 2, varEnd - (varStart + 2));
+		if (variables) {
+			variables->push_back(var);
+		}
 		std::string val;
 		try {
 			val = props.Evaluate(var);
@@ -294,7 +353,7 @@ int ExpandAllInPlace(const PropSetFile &props, std::string &withVars, int maxExp
 		}
 
 		if (--maxExpands >= 0) {
-			maxExpands = ExpandAllInPlace(props, val, maxExpands, VarChain(var, &blankVars));
+			maxExpands = ExpandAllInPlace(props, val, maxExpands, VarChain(var, &blankVars), variables);
 		}
 
 		withVars.erase(varStart, varEnd - varStart + 1);
@@ -544,13 +603,15 @@ bool MatchWildSet(std::string_view patternSet, std::string_view text, bool caseS
 
 }
 
-std::string_view PropSetFile::GetWildUsingStart(const PropSetFile &psStart, std::string_view keybase, std::string_view filename) const {
+// Returns the value found or nullptr. The variables expanded to match file patterns are added to variables.
+const std::string *PropSetFile::GetWildUsingStart(const PropSetFile &psStart, std::string_view keybase, std::string_view filename,
+	std::vector<std::string> &variables) const {
 	const PropSetFile *psf = this;
 	while (psf) {
 		mapss::const_iterator it = psf->props.lower_bound(keybase);
 		while ((it != psf->props.end()) && it->first.starts_with(keybase)) {
 			if (it->first == keybase) {
-				return it->second;
+				return &it->second;
 			}
 			const std::string_view first = it->first;
 			const std::string_view orgkeyfile = first.substr(keybase.length());
@@ -562,13 +623,15 @@ std::string_view PropSetFile::GetWildUsingStart(const PropSetFile &psStart, std:
 				const size_t endVar = orgkeyfile.find_first_of(')');
 				if (endVar != std::string_view::npos) {
 					const std::string_view var = orgkeyfile.substr(2, endVar-2);
-					key = psStart.GetExpandedString(var);
+					variables.emplace_back(var);
+					key = psStart.Get(var);
+					ExpandAllInPlace(psStart, key, maxIterations, VarChain(var), &variables);
 					keyFile = key;
 				}
 			}
 
 			if (MatchWildSet(keyFile, filename, caseSensitiveFilenames)) {
-				return it->second;
+				return &it->second;
 			}
 
 			++it;
@@ -576,11 +639,63 @@ std::string_view PropSetFile::GetWildUsingStart(const PropSetFile &psStart, std:
 		// Failed here, so try in base property set
 		psf = psf->superPS;
 	}
-	return "";
+	return nullptr;
+}
+
+namespace {
+
+std::string WildCacheKey(std::string_view keybase, std::string_view filename) {
+	std::string keyCache(keybase);
+	keyCache.push_back('\0');
+	keyCache.append(filename);
+	return keyCache;
+}
+
+}
+
+bool PropSetFile::WildChainChanged() const noexcept {
+	size_t depth = 0;
+	for (const PropSetFile *psf = superPS; psf; psf = psf->superPS) {
+		if (depth >= wildCacheChain.size() || wildCacheChain[depth] != psf) {
+			return true;
+		}
+		depth++;
+	}
+	return depth != wildCacheChain.size();
 }
 
 std::string_view PropSetFile::GetWild(std::string_view keybase, std::string_view filename) const {
-	return GetWildUsingStart(*this, keybase, filename);
+	if (wildCacheGeneration != wildGeneration || WildChainChanged()) {
+		wildCache.clear();
+		wildCacheGeneration = wildGeneration;
+		wildCacheChain.clear();
+		for (const PropSetFile *psf = superPS; psf; psf = psf->superPS) {
+			wildCacheChain.push_back(psf);
+		}
+	}
+	std::string keyCache = WildCacheKey(keybase, filename);
+	const auto itCache = wildCache.find(keyCache);
+	if (itCache != wildCache.end()) {
+		return itCache->second ? std::string_view(*itCache->second) : std::string_view();
+	}
+
+	std::vector<std::string> variables;
+	const std::string *value = GetWildUsingStart(*this, keybase, filename, variables);
+	// Variables containing spaces are commands like 'star' that depend on other keys so are not remembered
+	const bool commands = std::any_of(variables.begin(), variables.end(), [](const std::string &var) {
+		return var.find(' ') != std::string::npos;
+	});
+	if (!keybase.empty() && !commands) {
+		wildDependencies.emplace(keybase);
+		wildDependencies.insert(variables.begin(), variables.end());
+		wildCache.emplace(std::move(keyCache), value);
+	}
+	return value ? std::string_view(*value) : std::string_view();
+}
+
+bool PropSetFile::IsWildRemembered(std::string_view keybase, std::string_view filename) const {
+	return (wildCacheGeneration == wildGeneration) && !WildChainChanged() &&
+		wildCache.contains(WildCacheKey(keybase, filename));
 }
 
 // GetNewExpandString does not use Expand as it has to use GetWild with the filename for each
@@ -23,12 +23,29 @@ public:
 
 class PropSetFile {
 	bool lowerKeys;
-	std::string_view GetWildUsingStart(const PropSetFile &psStart, std::string_view keybase, std::string_view filename) const;
+	const std::string *GetWildUsingStart(const PropSetFile &psStart, std::string_view keybase, std::string_view filename,
+		std::vector<std::string> &variables) const;
 	static bool caseSensitiveFilenames;
 	mapss props;
+	// GetWild results are remembered until a key they depend upon changes in any PropSetFile
+	// or a different chain of base property sets is attached.
+	// wildDependencies holds the key bases and variables used by all remembered results.
+	mutable std::map<std::string, const std::string *, std::less<>> wildCache;
+	mutable std::vector<const PropSetFile *> wildCacheChain;
+	mutable unsigned int wildCacheGeneration = 0;
+	static unsigned int wildGeneration;
+	static std::set<std::string, std::less<>> wildDependencies;
+	[[nodiscard]] bool WildChainChanged() const noexcept;
+	static void Changed(std::string_view key) noexcept;
+	static void InvalidateWild() noexcept;
 public:
 	PropSetFile *superPS;
 	explicit PropSetFile(bool lowerKeys_=false);
+	// Copies start with an empty GetWild cache. Assignment only updates keys whose values differ
+	// so remembered lookups that do not depend on them stay valid.
+	PropSetFile(const PropSetFile &other);
+	PropSetFile(PropSetFile &&other) noexcept = default;
+	PropSetFile &operator=(const PropSetFile &other);
 
 	void Set(std::string_view key, std::string_view val);
 	void SetPath(std::string_view key, const FilePath &path);
@@ -56,6 +73,8 @@ public:
 	bool Read(const FilePath &filename, const FilePath &directoryForImports, const ImportFilter &filter,
 		  FilePathSet *imports, size_t depth);
 	std::string_view GetWild(std::string_view keybase, std::string_view filename) const;
+	// Whether the GetWild result for keybase and filename is remembered. Used by tests.
+	[[nodiscard]] bool IsWildRemembered(std::string_view keybase, std::string_view filename) const;
 	std::string GetNewExpandString(std::string_view keybase, std::string_view filename = "") const;
 	bool GetFirst(const char *&key, const char *&val) const;
 	bool GetNext(const char *&key, const char *&val) const;
@@ -1056,6 +1056,10 @@ SA::FindOption SciTEBase::SearchFlags(bool regularExpressions) const {
 		opt |= SA::FindOption::Posix;
 	if (props.GetInt("find.replace.regexp.cpp11"))
 		opt |= SA::FindOption::Cxx11RegEx;
+	if (props.GetInt("find.replace.regexp.linear"))
+		opt |= SA::FindOption::LinearRegEx;
+	if (props.GetInt("find.parallel"))
+		opt |= SA::FindOption::Parallel;
 	return opt;
 }
 
@@ -1351,6 +1355,34 @@ intptr_t SciTEBase::DoReplaceAll(bool inSelection) {
 
 	const std::string replaceTarget = UnSlashAsNeeded(EncodeString(replaceWhat), unSlash, regExp);
 	wEditor.SetSearchFlags(SearchFlags(regExp));
+	if (!regExp && !findInStyle && !(inSelection && countSelections > 1) &&
+		(findTarget.find('\0') == std::string::npos)) {
+		// Plain text matches can all be found in one call then replaced from last
+		// to first so the positions of earlier matches remain valid.
+		wEditor.SetTarget(rangeSearch);
+		const SA::Position matchCount = wEditor.FindAllInTarget(0, findTarget.c_str());
+		if (matchCount <= 0) {
+			return 0;
+		}
+		const SA::Position lenReplaced = replaceTarget.length();
+		const SA::Position lastStart = wEditor.FoundStart(matchCount - 1);
+		SA::Position lastMatch = lastStart;
+		UndoBlock ub(wEditor);
+		for (SA::Position match = matchCount - 1; match >= 0; match--) {
+			const SA::Span rangeFound(wEditor.FoundStart(match), wEditor.FoundEnd(match));
+			wEditor.SetTarget(rangeFound);
+			wEditor.ReplaceTarget(replaceTarget);
+			const SA::Position change = lenReplaced - rangeFound.Length();
+			rangeSearch.end += change;
+			lastMatch += (match == matchCount - 1) ? lenReplaced : change;
+		}
+		if (inSelection) {
+			SetSelection(rangeSearch.start, rangeSearch.end);
+		} else {
+			SetSelection(lastMatch, lastMatch);
+		}
+		return matchCount;
+	}
 	SA::Position posFind = FindInTarget(findTarget, rangeSearch, false);
 	if ((posFind >= 0) && (posFind <= rangeSearch.end)) {
 		SA::Position lastMatch = posFind;
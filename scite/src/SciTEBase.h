@@ -104,7 +104,7 @@ public:
 	bool isReadOnly;
 	bool failedSave;
 	bool useMonoFont;
-	enum class LifeState { empty, reading, readAll, opened } lifeState;
+	enum class LifeState { empty, reading, readAll, opened, deferred } lifeState;
 	UniMode unicodeMode;
 	time_t fileModTime;
 	time_t fileModLastAsk;
@@ -369,6 +369,10 @@ protected:
 	int diagnosticStyleStart;
 	enum { diagnosticStyles=4};
 
+	// Descriptions of the styles last set by ReadFontProperties so unchanged styles are not set again
+	std::string editorStylesApplied;
+	std::string outputStylesApplied;
+
 	bool stripTrailingSpaces;
 	bool ensureFinalLineEnd;
 	bool ensureConsistentLineEnds;
@@ -851,6 +855,8 @@ protected:
 	void DeleteFileStackMenu();
 	void SetFileStackMenu();
 	bool AddFileToBuffer(const BufferState &bufferState);
+	bool AddDeferredBuffer(const BufferState &bufferState);
+	void LoadDeferredBuffer();
 	void AddFileToStack(const RecentFile &file);
 	void RemoveFileFromStack(const FilePath &file);
 	FilePosition GetFilePosition();
@@ -901,8 +907,8 @@ protected:
 	void ReadEditorConfig(const std::string &fileNameForExtension);
 	StyleDefinition StyleDefinitionFor(int style);
 	void SetOneStyle(GUI::ScintillaWindow &win, int style, std::string_view definition);
-	void SetStyleBlock(GUI::ScintillaWindow &win, const char *lang, int start, int last);
-	void SetStyleFor(GUI::ScintillaWindow &win, const char *lang);
+	using StyleDefinitions = std::vector<std::pair<int, std::string>>;
+	void AddStyleBlock(StyleDefinitions &definitions, const char *lang, int start, int last);
 	static void SetOneIndicator(GUI::ScintillaWindow &win, SA::IndicatorNumbers indicator, const IndicatorDefinition &ind);
 	void SetIndicatorFromProperty(GUI::ScintillaWindow &win, SA::IndicatorNumbers indicator, const std::string &propertyName);
 	void SetMarkerFromProperty(GUI::ScintillaWindow &win, int marker, const std::string &propertyName);
@@ -937,7 +943,7 @@ protected:
 	void OpenFromStdin(bool UseOutputPane);
 	void OpenFilesFromStdin();
 	virtual bool GrepIntoDirectory(const FilePath &directory);
-	void GrepRecursive(GrepFlags gf, const FilePath &baseDir, const char *searchString,
+	void GrepTreeParallel(GrepFlags gf, const FilePath &baseDir, std::string_view searchString,
 		GUI::gui_string_view fileTypes, GUI::gui_string_view excludedTypes);
 	void InternalGrep(GrepFlags gf, const FilePath &directory, GUI::gui_string_view fileTypes, GUI::gui_string_view excludedTypes,
 			  std::string_view search, SA::Position &originalEnd);
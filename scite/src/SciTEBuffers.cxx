@@ -481,7 +481,12 @@ void SciTEBase::SetDocumentAt(BufferIndex index, bool updateStack) {
 		if (extender)
 			extender->OnOpen(filePath.AsUTF8().c_str());
 	}
-	RestoreState(bufferNext, restoreBookmarks);
+	if (bufferNext.lifeState == Buffer::LifeState::deferred) {
+		// Session buffer shown for the first time so read its file now
+		LoadDeferredBuffer();
+	} else {
+		RestoreState(bufferNext, restoreBookmarks);
+	}
 
 	TabSelect(index);
 
@@ -526,6 +531,10 @@ void SciTEBase::UpdateBuffersCurrent() {
 
 	if ((buffers.length > 0) && (currentbuf >= 0) && (buffers.GetVisible(currentbuf))) {
 		Buffer &bufferCurrent = buffers.buffers[currentbuf];
+		if (bufferCurrent.lifeState == Buffer::LifeState::deferred) {
+			// Not yet read so keep the state from the session file
+			return;
+		}
 		bufferCurrent.file.Set(filePath);
 		if (bufferCurrent.lifeState != Buffer::LifeState::reading && bufferCurrent.lifeState != Buffer::LifeState::readAll) {
 			bufferCurrent.file.filePosition = GetFilePosition();
@@ -696,11 +705,21 @@ std::string StringFromLines(const std::vector<SA::Line> &lines) {
 }
 
 void SciTEBase::RestoreFromSession(const Session &session) {
-	for (const BufferState &buffer : session.buffers)
-		AddFileToBuffer(buffer);
+	// With session.load.lazy only the active file is read now and other buffers are
+	// read when first shown.
+	const bool deferLoading = props.GetInt("session.load.lazy") && (buffers.size() > 1);
+	for (const BufferState &buffer : session.buffers) {
+		if (deferLoading && !buffer.file.SameNameAs(session.pathActive))
+			AddDeferredBuffer(buffer);
+		else
+			AddFileToBuffer(buffer);
+	}
 	const BufferIndex iBuffer = buffers.GetDocumentByName(session.pathActive);
-	if (iBuffer >= 0)
+	if (iBuffer >= 0) {
 		SetDocumentAt(iBuffer);
+		buffers.MoveToStackTop(iBuffer);
+	}
+	LoadDeferredBuffer();
 }
 
 void SciTEBase::RestoreSession() {
@@ -1053,8 +1072,12 @@ void SciTEBase::Close(bool updateUI, bool loadingSession, bool makingRoomForNew)
 			ClearDocument();
 		}
 		if (updateUI) {
-			CheckReload();
-			RestoreState(bufferNext, false);
+			if (bufferNext.lifeState == Buffer::LifeState::deferred) {
+				LoadDeferredBuffer();
+			} else {
+				CheckReload();
+				RestoreState(bufferNext, false);
+			}
 			DisplayAround(bufferNext.file.filePosition);
 		}
 	}
@@ -1377,6 +1400,50 @@ bool SciTEBase::AddFileToBuffer(const BufferState &bufferState) {
 	return opened;
 }
 
+bool SciTEBase::AddDeferredBuffer(const BufferState &bufferState) {
+	// Add a buffer for a session file without reading it
+	if (!bufferState.file.Exists() || (buffers.GetDocumentByName(bufferState.file) >= 0)) {
+		return false;
+	}
+	InitialiseBuffers();
+	BufferIndex iBuffer = 0;
+	// Overwrite the initial untitled, clean buffer as New does
+	if ((buffers.length > 1) ||
+			(buffers.Current() != 0) ||
+			(buffers.buffers[0].isDirty) ||
+			(!buffers.buffers[0].file.IsUntitled())) {
+		if (!IsBufferAvailable()) {
+			return false;
+		}
+		iBuffer = buffers.Add();
+	}
+	Buffer &buffer = buffers.buffers[iBuffer];
+	buffer.file = bufferState.file;
+	buffer.foldState = bufferState.foldState;
+	buffer.bookmarks = bufferState.bookmarks;
+	buffer.isReadOnly = bufferState.readOnly;
+	buffer.lifeState = Buffer::LifeState::deferred;
+	if (extender)
+		extender->InitBuffer(iBuffer);
+	SetBuffersMenu();
+	return true;
+}
+
+void SciTEBase::LoadDeferredBuffer() {
+	// Read the file of the current buffer if it was added by AddDeferredBuffer
+	Buffer *buffer = CurrentBuffer();
+	if (buffer->lifeState != Buffer::LifeState::deferred) {
+		return;
+	}
+	BufferState bufferState;
+	bufferState.file = buffer->file;
+	bufferState.foldState = buffer->foldState;
+	bufferState.bookmarks = buffer->bookmarks;
+	bufferState.readOnly = buffer->isReadOnly;
+	buffer->lifeState = Buffer::LifeState::empty;
+	AddFileToBuffer(bufferState);
+}
+
 void SciTEBase::AddFileToStack(const RecentFile &file) {
 	if (!file.IsSet())
 		return;
@@ -22,15 +22,19 @@
 #include <string_view>
 #include <vector>
 #include <array>
+#include <deque>
 #include <map>
 #include <set>
 #include <optional>
 #include <algorithm>
 #include <ranges>
+#include <functional>
 #include <memory>
 #include <chrono>
 #include <atomic>
 #include <mutex>
+#include <condition_variable>
+#include <thread>
 
 #include <fcntl.h>
 
@@ -55,6 +59,7 @@
 #include "FileWorker.h"
 #include "MatchMarker.h"
 #include "Searcher.h"
+#include "StringSearch.h"
 #include "SciTEBase.h"
 
 #if defined(GTK)
@@ -249,6 +254,10 @@ SA::DocumentOption LoadingOptions(const PropSetFile &props, const long long file
 	if (sizeNoStyles && (fileSize > sizeNoStyles))
 		docOptions = docOptions | SA::DocumentOption::StylesNone;
 
+	const long long sizePieces = props.GetLongLong("file.size.pieces");
+	if (sizePieces && (fileSize > sizePieces))
+		docOptions = docOptions | SA::DocumentOption::PieceTree;
+
 	return docOptions;
 }
 
@@ -292,6 +301,16 @@ void SciTEBase::OpenCurrentFile(const long long fileSize, bool suppressMessage,
 
 	const SA::Position bufferSize = static_cast<SA::Position>(fileAllocationSize);
 
+	// Large files may be read through a memory mapping to avoid copying into a buffer
+	std::unique_ptr<FileMapping> mapping;
+	const long long sizeMapped = props.GetLongLong("file.size.mapped");
+	if (sizeMapped && (fileSize > sizeMapped)) {
+		mapping = std::make_unique<FileMapping>(filePath);
+		if (!mapping->Mapped()) {
+			mapping.reset();
+		}
+	}
+
 	CurrentBuffer()->SetTimeFromFile();
 
 	CurrentBuffer()->lifeState = Buffer::LifeState::reading;
@@ -299,6 +318,7 @@ void SciTEBase::OpenCurrentFile(const long long fileSize, bool suppressMessage,
 		wEditor.ClearAll();
 		// Turn grey while loading
 		wEditor.StyleSetBack(StyleDefault, 0xEEEEEE);
+		editorStylesApplied.clear();
 		wEditor.SetReadOnly(true);
 		assert(CurrentBufferConst()->pFileWorker == nullptr);
 		Scintilla::ILoader *pdocLoad = nullptr;
@@ -310,7 +330,8 @@ void SciTEBase::OpenCurrentFile(const long long fileSize, bool suppressMessage,
 			wEditor.SetStatus(SA::Status::Ok);
 			return;
 		}
-		CurrentBuffer()->pFileWorker = std::make_unique<FileLoader>(this, pdocLoad, filePath, static_cast<size_t>(fileSize), fp);
+		CurrentBuffer()->pFileWorker = std::make_unique<FileLoader>(this, pdocLoad, filePath, static_cast<size_t>(fileSize), fp,
+			std::move(mapping));
 		CurrentBuffer()->pFileWorker->sleepTime = props.GetInt("asynchronous.sleep");
 		PerformOnNewThread(CurrentBuffer()->pFileWorker.get());
 	} else {
@@ -319,12 +340,18 @@ void SciTEBase::OpenCurrentFile(const long long fileSize, bool suppressMessage,
 			UndoBlock ub(wEditor);	// Group together clear and insert
 			wEditor.ClearAll();
 			wEditor.Allocate(bufferSize);
-			std::vector<char> data(blockSize);
-			size_t lenFile = fread(data.data(), 1, data.size(), fp);
-			while (lenFile > 0) {
-				const std::string_view dataBlock = convert->convert(std::string_view(data.data(), lenFile));
-				AddText(wEditor, dataBlock);
-				lenFile = fread(data.data(), 1, data.size(), fp);
+			if (mapping) {
+				// Unless UTF-16, the whole mapping is passed through to Scintilla in one call
+				AddText(wEditor, convert->convert(mapping->View()));
+				mapping.reset();
+			} else {
+				std::vector<char> data(blockSize);
+				size_t lenFile = fread(data.data(), 1, data.size(), fp);
+				while (lenFile > 0) {
+					const std::string_view dataBlock = convert->convert(std::string_view(data.data(), lenFile));
+					AddText(wEditor, dataBlock);
+					lenFile = fread(data.data(), 1, data.size(), fp);
+				}
 			}
 			fclose(fp);
 			// Handle case where convert is holding a lead surrogate but no more data
@@ -969,6 +996,9 @@ SciTEBase::SaveResult SciTEBase::SaveIfUnsureAll() {
 	if (extender && extender->NeedsOnClose()) {
 		// Ensure extender is told about each buffer closing
 		for (BufferIndex k = 0; k < buffers.lengthVisible; k++) {
+			// Buffers from a session that were never shown were not opened
+			if (buffers.buffers[k].lifeState == Buffer::LifeState::deferred)
+				continue;
 			SetDocumentAt(k);
 			extender->OnClose(filePath.AsUTF8().c_str());
 		}
@@ -1423,103 +1453,322 @@ void SciTEBase::OpenFilesFromStdin() {
 
 namespace {
 
-class BufferedFile {
-	FileHolder fp;
-	bool readAll = false;
+constexpr bool IsLineEnd(char ch) noexcept {
+	return ch == '\r' || ch == '\n';
+}
+
+// Search one file, returning the text to display for each matching line.
+// The file is read in large blocks, each cut after its last complete line, and the
+// whole block is searched at once. Line numbers are only calculated at matches
+// and at the end of each block.
+std::string GrepFile(GrepFlags gf, const FilePath &fPath, const StringSearch &searcher, const JobQueue &jobQueue) {
+	constexpr size_t blockSize = 1024 * 1024;
+	constexpr size_t binaryCheckLength = 64 * 1024;
+	std::string os;
+	FileHolder fp(fPath.Open(fileRead));
+	if (!fp) {
+		return os;
+	}
+	std::string buffer;
+	size_t lineNumber = 1;	// Line number at start of buffer
 	bool exhausted = false;
-	static constexpr size_t bufLen = 64 * 1024;
-	std::array<char, bufLen> buffer;
-	size_t pos = 0;
-	size_t valid = 0;
-	void EnsureData() noexcept {
-		if (pos >= valid) {
-			if (readAll || !fp) {
-				exhausted = true;
-			} else {
-				valid = fread(buffer.data(), 1, bufLen, fp.get());
-				if (valid < bufLen) {
-					readAll = true;
+	bool firstBlock = true;
+	while (!exhausted) {
+		if (jobQueue.Cancelled())
+			return os;
+		const size_t carried = buffer.length();
+		buffer.resize(carried + blockSize);
+		const size_t lenRead = fread(buffer.data() + carried, 1, blockSize, fp.get());
+		buffer.resize(carried + lenRead);
+		exhausted = lenRead < blockSize;
+		if (firstBlock) {
+			firstBlock = false;
+			if (!FlagIsSet(gf, GrepFlags::binary) &&
+				std::string_view(buffer.data(), std::min(buffer.length(), binaryCheckLength)).find('\0') != std::string_view::npos) {
+				return os;
+			}
+		}
+
+		// Only search complete lines: a line end as last byte may be the CR of a CR+LF
+		size_t complete = buffer.length();
+		if (!exhausted) {
+			complete = 0;
+			for (size_t i = buffer.length() - 1; i > 0; i--) {
+				if (IsLineEnd(buffer[i - 1])) {
+					complete = i;
+					if (buffer[i - 1] == '\r' && buffer[i] == '\n') {
+						complete++;
+					}
+					break;
 				}
-				pos = 0;
 			}
 		}
+		const std::string_view text(buffer.data(), complete);
+
+		size_t counted = 0;	// Line ends before counted have been added to lineNumber
+		size_t position = 0;
+		while (position < text.length()) {
+			const size_t match = searcher.Find(text, position);
+			if (match == std::string_view::npos || match >= text.length())
+				break;
+			size_t lineStart = match;
+			while (lineStart > counted && !IsLineEnd(text[lineStart - 1])) {
+				lineStart--;
+			}
+			size_t lineEnd = match + searcher.Length();
+			while (lineEnd < text.length() && !IsLineEnd(text[lineEnd])) {
+				lineEnd++;
+			}
+			lineNumber += CountLineEnds(text.substr(counted, lineStart - counted));
+			counted = lineStart;
+			os.append(fPath.AsUTF8());
+			os.append(":");
+			os.append(StdStringFromSizeT(lineNumber));
+			os.append(":");
+			os.append(text.substr(lineStart, lineEnd - lineStart));
+			os.append("\n");
+			// Continue after this line's end
+			position = lineEnd;
+			if (position < text.length()) {
+				position += (text[position] == '\r' && position + 1 < text.length() && text[position + 1] == '\n') ? 2 : 1;
+			}
+		}
+		lineNumber += CountLineEnds(text.substr(counted));
+		buffer.erase(0, complete);
 	}
-public:
-	explicit BufferedFile(const FilePath &fPath) noexcept : fp(fPath.Open(fileRead)) {
-		exhausted = !fp;
-		buffer[0] = 0;
+	return os;
+}
+
+// A file found while walking the tree. matches is written by the searching thread then
+// read by the thread producing output once searched is set.
+struct GrepFileEntry {
+	FilePath path;
+	std::string matches;
+	bool searched = false;
+	explicit GrepFileEntry(const FilePath &path_) : path(path_) {
 	}
-	[[nodiscard]] bool Exhausted() const noexcept {
-		return exhausted;
+};
+
+// A directory in the tree. Its files and directories are filled in by the thread that
+// lists it and are not changed after listed is set.
+struct GrepDirectoryEntry {
+	FilePath path;
+	std::vector<GrepFileEntry> files;
+	std::vector<std::unique_ptr<GrepDirectoryEntry>> directories;
+	bool listed = false;
+	explicit GrepDirectoryEntry(const FilePath &path_) : path(path_) {
 	}
-	[[nodiscard]] char NextByte() noexcept {
-		EnsureData();
-		if (pos >= valid) {
-			return 0;
+};
+
+// Either a directory to list or a file to search.
+struct GrepTask {
+	GrepDirectoryEntry *directory = nullptr;
+	GrepFileEntry *file = nullptr;
+};
+
+// Each thread owns a deque of tasks, taking the newest task it added for locality and
+// stealing the oldest task from other threads when its own deque is empty.
+struct GrepTaskDeque {
+	std::mutex mutex;
+	std::deque<GrepTask> tasks;
+};
+
+/**
+ * Search a directory tree with a pool of threads: directories are listed and files
+ * searched concurrently while the calling thread waits for results in the same
+ * depth-first, sorted path order as a serial walk and passes them to the output.
+ */
+class GrepTree {
+	GrepFlags gf;
+	const StringSearch &searcher;
+	GUI::gui_string_view fileTypes;
+	GUI::gui_string_view excludedTypes;
+	const JobQueue &jobQueue;
+	std::function<bool(const FilePath &)> intoDirectory;
+
+	std::vector<std::unique_ptr<GrepTaskDeque>> deques;
+	std::atomic_size_t pending = 0;
+	std::atomic_bool stopping = false;
+	std::mutex mutexWork;
+	std::condition_variable workAvailable;
+	std::mutex mutexResults;
+	std::condition_variable resultAvailable;
+
+	void Push(size_t thread, GrepTask task) {
+		pending++;
+		{
+			std::lock_guard<std::mutex> guard(deques[thread]->mutex);
+			deques[thread]->tasks.push_back(task);
 		}
-		return buffer[pos++];
+		workAvailable.notify_one();
 	}
-	[[nodiscard]] bool BufferContainsNull() noexcept {
-		EnsureData();
-		for (size_t i = 0; i < valid; i++) {
-			if (buffer[i] == '\0')
-				return true;
+
+	[[nodiscard]] std::optional<GrepTask> Take(size_t thread) {
+		{
+			GrepTaskDeque &own = *deques[thread];
+			std::lock_guard<std::mutex> guard(own.mutex);
+			if (!own.tasks.empty()) {
+				const GrepTask task = own.tasks.back();
+				own.tasks.pop_back();
+				return task;
+			}
 		}
-		return false;
+		for (size_t i = 1; i < deques.size(); i++) {
+			GrepTaskDeque &victim = *deques[(thread + i) % deques.size()];
+			std::lock_guard<std::mutex> guard(victim.mutex);
+			if (!victim.tasks.empty()) {
+				const GrepTask task = victim.tasks.front();
+				victim.tasks.pop_front();
+				return task;
+			}
+		}
+		return {};
 	}
-};
 
-class FileReader {
-	// Using dynamic allocation of BufferedFile to avoid large object on stack.
-	std::unique_ptr<BufferedFile> bf;
-	int lineNum = 0;
-	bool lastWasCR = false;
-	std::string lineToCompare;
-	std::string lineToShow;
-	bool caseSensitive = false;
-public:
-	FileReader(const FilePath &fPath, bool caseSensitive_) : bf(std::make_unique<BufferedFile>(fPath)) {
-		caseSensitive = caseSensitive_;
-	}
-	// Deleted so FileReader objects can not be copied.
-	FileReader(const FileReader &) = delete;
-	const char *Next() {
-		if (bf->Exhausted()) {
-			return nullptr;
-		}
-		lineToShow.clear();
-		while (!bf->Exhausted()) {
-			const char ch = bf->NextByte();
-			if (lastWasCR && ch == '\n' && lineToShow.empty()) {
-				lastWasCR = false;
-			} else if (ch == '\r' || ch == '\n') {
-				lastWasCR = ch == '\r';
-				break;
-			} else {
-				lineToShow.push_back(ch);
+	void List(size_t thread, GrepDirectoryEntry &directory) {
+		FilePathSet directories;
+		FilePathSet files;
+		directory.path.List(directories, files);
+		for (const FilePath &fPath : files) {
+			if ((fileTypes.empty() || fPath.Matches(fileTypes)) &&
+				(excludedTypes.empty() || !fPath.Matches(excludedTypes))) {
+				directory.files.emplace_back(fPath);
+			}
+		}
+		for (const FilePath &fPath : directories) {
+			if (FlagIsSet(gf, GrepFlags::dot) || intoDirectory(fPath.Name())) {
+				if ((excludedTypes.empty() || !fPath.Matches(excludedTypes))) {
+					directory.directories.push_back(std::make_unique<GrepDirectoryEntry>(fPath));
+				}
 			}
 		}
-		lineNum++;
-		lineToCompare = lineToShow;
-		if (!caseSensitive) {
-			LowerCaseAZ(lineToCompare);
+		{
+			std::lock_guard<std::mutex> guard(mutexResults);
+			directory.listed = true;
+		}
+		resultAvailable.notify_all();
+		// Push in reverse so the owning thread, taking the newest, proceeds in path order
+		for (auto it = directory.directories.rbegin(); it != directory.directories.rend(); ++it) {
+			Push(thread, GrepTask{ it->get(), nullptr });
+		}
+		for (auto it = directory.files.rbegin(); it != directory.files.rend(); ++it) {
+			Push(thread, GrepTask{ nullptr, &*it });
 		}
-		return lineToCompare.c_str();
 	}
-	[[nodiscard]] int LineNumber() const noexcept {
-		return lineNum;
+
+	void Search(GrepFileEntry &file) {
+		std::string matches = GrepFile(gf, file.path, searcher, jobQueue);
+		{
+			std::lock_guard<std::mutex> guard(mutexResults);
+			file.matches = std::move(matches);
+			file.searched = true;
+		}
+		resultAvailable.notify_all();
 	}
-	[[nodiscard]] const char *Original() const noexcept {
-		return lineToShow.c_str();
+
+	void Work(size_t thread) {
+		while (!stopping) {
+			const std::optional<GrepTask> task = Take(thread);
+			if (!task) {
+				if (pending == 0) {
+					return;
+				}
+				std::unique_lock<std::mutex> lock(mutexWork);
+				workAvailable.wait_for(lock, std::chrono::milliseconds(1));
+				continue;
+			}
+			try {
+				if (jobQueue.Cancelled()) {
+					stopping = true;
+				} else if (task->directory) {
+					List(thread, *task->directory);
+				} else {
+					Search(*task->file);
+				}
+			} catch (const std::exception &) {
+				// Out of memory or similar so abandon search
+				stopping = true;
+			}
+			pending--;
+		}
+		workAvailable.notify_all();
+		resultAvailable.notify_all();
+	}
+
+	// Wait until condition holds or the search is stopped. Periodically checks
+	// for cancellation since there may be no work completing to wake this thread.
+	template <typename Condition>
+	bool WaitFor(Condition condition) {
+		std::unique_lock<std::mutex> lock(mutexResults);
+		while (!condition()) {
+			if (stopping || jobQueue.Cancelled()) {
+				stopping = true;
+				return false;
+			}
+			resultAvailable.wait_for(lock, std::chrono::milliseconds(50));
+		}
+		return true;
 	}
-	[[nodiscard]] bool BufferContainsNull() noexcept {
-		return bf->BufferContainsNull();
+
+	template <typename Output>
+	bool Emit(GrepDirectoryEntry &directory, Output &output) {
+		if (!WaitFor([&directory]() noexcept { return directory.listed; }))
+			return false;
+		std::string os;
+		for (GrepFileEntry &file : directory.files) {
+			if (!WaitFor([&file]() noexcept { return file.searched; }))
+				return false;
+			os.append(file.matches);
+			file.matches = std::string();
+		}
+		if (!os.empty()) {
+			output(os);
+		}
+		for (const std::unique_ptr<GrepDirectoryEntry> &subDirectory : directory.directories) {
+			if (!Emit(*subDirectory, output))
+				return false;
+		}
+		return true;
 	}
-};
 
-constexpr bool IsWordCharacter(int ch) noexcept {
-	return (ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z') || (ch >= '0' && ch <= '9') || (ch == '_');
-}
+public:
+	GrepTree(GrepFlags gf_, const StringSearch &searcher_, GUI::gui_string_view fileTypes_,
+		GUI::gui_string_view excludedTypes_, const JobQueue &jobQueue_,
+		std::function<bool(const FilePath &)> intoDirectory_) :
+		gf(gf_), searcher(searcher_), fileTypes(fileTypes_), excludedTypes(excludedTypes_),
+		jobQueue(jobQueue_), intoDirectory(std::move(intoDirectory_)) {
+	}
+
+	template <typename Output>
+	void Run(const FilePath &baseDir, Output output) {
+		const size_t threads = std::max(std::thread::hardware_concurrency(), 1U);
+		for (size_t i = 0; i < threads; i++) {
+			deques.push_back(std::make_unique<GrepTaskDeque>());
+		}
+		GrepDirectoryEntry root(baseDir);
+		Push(0, GrepTask{ &root, nullptr });
+		std::vector<std::thread> workers;
+		try {
+			for (size_t i = 0; i < threads; i++) {
+				workers.emplace_back([this, i]() {
+					Work(i);
+				});
+			}
+		} catch (const std::system_error &) {
+			// Proceed with however many threads could be started
+		}
+		if (workers.empty()) {
+			// No threads so perform the search on this thread
+			Work(0);
+		}
+		Emit(root, output);
+		stopping = true;
+		workAvailable.notify_all();
+		for (std::thread &worker : workers) {
+			worker.join();
+		}
+	}
+};
 
 }
 
@@ -1528,68 +1777,20 @@ bool SciTEBase::GrepIntoDirectory(const FilePath &directory) {
 	return sDirectory[0] != '.';
 }
 
-void SciTEBase::GrepRecursive(GrepFlags gf, const FilePath &baseDir, const char *searchString,
+void SciTEBase::GrepTreeParallel(GrepFlags gf, const FilePath &baseDir, std::string_view searchString,
 	GUI::gui_string_view fileTypes, GUI::gui_string_view excludedTypes) {
-	constexpr int checkAfterLines = 10'000;
-	FilePathSet directories;
-	FilePathSet files;
-	baseDir.List(directories, files);
-	const size_t searchLength = strlen(searchString);
-	std::string os;
-	for (const FilePath &fPath : files) {
-		if (jobQueue.Cancelled())
-			return;
-		if ((fileTypes.empty() || fPath.Matches(fileTypes)) &&
-			(excludedTypes.empty() || !fPath.Matches(excludedTypes))) {
-			//OutputAppendStringSynchronised(fPath.AsUTF8());
-			//OutputAppendStringSynchronised("\n");
-			FileReader fr(fPath, FlagIsSet(gf, GrepFlags::matchCase));
-			if (FlagIsSet(gf, GrepFlags::binary) || !fr.BufferContainsNull()) {
-				while (const char *line = fr.Next()) {
-					if (((fr.LineNumber() % checkAfterLines) == 0) && jobQueue.Cancelled())
-						return;
-					const char *match = strstr(line, searchString);
-					if (match) {
-						if (FlagIsSet(gf, GrepFlags::wholeWord)) {
-							const char *lineEnd = line + strlen(line);
-							while (match) {
-								if (((match == line) || !IsWordCharacter(match[-1])) &&
-										((match + searchLength == lineEnd) || !IsWordCharacter(match[searchLength]))) {
-									break;
-								}
-								match = strstr(match + 1, searchString);
-							}
-						}
-						if (match) {
-							os.append(fPath.AsUTF8());
-							os.append(":");
-							std::string lNumber = StdStringFromInteger(fr.LineNumber());
-							os.append(lNumber);
-							os.append(":");
-							os.append(fr.Original());
-							os.append("\n");
-						}
-					}
-				}
-			}
-		}
-	}
-	if (!os.empty()) {
+	const StringSearch searcher(searchString, FlagIsSet(gf, GrepFlags::matchCase), FlagIsSet(gf, GrepFlags::wholeWord));
+	GrepTree grepTree(gf, searcher, fileTypes, excludedTypes, jobQueue,
+		[this](const FilePath &directory) {
+			return GrepIntoDirectory(directory);
+		});
+	grepTree.Run(baseDir, [this, gf](std::string_view os) {
 		if (FlagIsSet(gf, GrepFlags::stdOut)) {
-			fwrite(os.c_str(), os.length(), 1, stdout);
+			fwrite(os.data(), os.length(), 1, stdout);
 		} else {
 			OutputAppendStringSynchronised(os);
 		}
-	}
-	for (const FilePath &fPath : directories) {
-		if (jobQueue.Cancelled())
-			return;
-		if (FlagIsSet(gf, GrepFlags::dot) || GrepIntoDirectory(fPath.Name())) {
-			if ((excludedTypes.empty() || !fPath.Matches(excludedTypes))) {
-				GrepRecursive(gf, fPath, searchString, fileTypes, excludedTypes);
-			}
-		}
-	}
+	});
 }
 
 void SciTEBase::InternalGrep(GrepFlags gf, const FilePath &directory, GUI::gui_string_view fileTypes, GUI::gui_string_view excludedTypes,
@@ -1606,11 +1807,7 @@ void SciTEBase::InternalGrep(GrepFlags gf, const FilePath &directory, GUI::gui_s
 		ShowOutputOnMainThread();
 		originalEnd += os.length();
 	}
-	std::string searchString(search);
-	if (!FlagIsSet(gf, GrepFlags::matchCase)) {
-		LowerCaseAZ(searchString);
-	}
-	GrepRecursive(gf, directory, searchString.c_str(), fileTypes, excludedTypes);
+	GrepTreeParallel(gf, directory, search, fileTypes, excludedTypes);
 	if (!FlagIsSet(gf, GrepFlags::stdOut)) {
 		std::string sExitMessage(">");
 		if (jobQueue.TimeCommands()) {
@@ -190,28 +190,32 @@ where this property file is found. If it is not found $(SciteDirectoryHome) will
 be set to $(FilePath).
 */
 void SciTEBase::ReadDirectoryPropFile() {
-	propsDirectory.Clear();
+	// Read into a new set then assign so keys that keep their values, as is common when
+	// switching between files in one directory, do not discard remembered GetWild results.
+	PropSetFile propsRead;
+	propsRead.superPS = propsDirectory.superPS;
 
-	propsDirectory.SetPath("FilePath", filePath);
-	propsDirectory.SetPath("FileDir", filePath.Directory());
-	propsDirectory.SetPath("FileName", filePath.BaseName());
-	propsDirectory.SetPath("FileExt", filePath.Extension());
-	propsDirectory.SetPath("FileNameExt", FileNameExt());
+	propsRead.SetPath("FilePath", filePath);
+	propsRead.SetPath("FileDir", filePath.Directory());
+	propsRead.SetPath("FileName", filePath.BaseName());
+	propsRead.SetPath("FileExt", filePath.Extension());
+	propsRead.SetPath("FileNameExt", FileNameExt());
 
 	if (propsUser.GetInt("properties.directory.enable") != 0) {
 		const FilePath propfile = GetDirectoryPropertiesFileName();
 		const FilePath propfileDirectory = propfile.Directory();
 		const GUI::gui_string relPath = propfileDirectory.RelativePathTo(filePath);
-		propsDirectory.Set("RelativePath", GUI::UTF8FromString(relPath));
+		propsRead.Set("RelativePath", GUI::UTF8FromString(relPath));
 
 		props.SetPath("SciteDirectoryHome", propfileDirectory);
 
-		propsDirectory.Read(propfile, propfileDirectory, filter, nullptr, 0);
+		propsRead.Read(propfile, propfileDirectory, filter, nullptr, 0);
 	} else {
-		propsDirectory.SetPath("RelativePath", filePath.Name());
+		propsRead.SetPath("RelativePath", filePath.Name());
 	}
-	propsDirectory.Unset("SciteDefaultHome");
-	propsDirectory.Unset("SciteUserHome");
+	propsRead.Unset("SciteDefaultHome");
+	propsRead.Unset("SciteUserHome");
+	propsDirectory = propsRead;
 }
 
 /**
@@ -224,12 +228,14 @@ void SciTEBase::ReadLocalPropFile() {
 
 	FilePath propfile = GetLocalPropertiesFileName();
 
-	propsLocal.Clear();
+	PropSetFile propsRead;
+	propsRead.superPS = propsLocal.superPS;
 	if (propsUser.GetInt("properties.local.enable", 1) != 0) {
-		propsLocal.Read(propfile, propfile.Directory(), filter, nullptr, 0);
-		propsLocal.Unset("SciteDefaultHome");
-		propsLocal.Unset("SciteUserHome");
+		propsRead.Read(propfile, propfile.Directory(), filter, nullptr, 0);
+		propsRead.Unset("SciteDefaultHome");
+		propsRead.Unset("SciteUserHome");
 	}
+	propsLocal = propsRead;
 
 	props.Set("Chrome", "#C0C0C0");
 	props.Set("ChromeHighlight", "#FFFFFF");
@@ -360,22 +366,18 @@ void SciTEBase::SetOneStyle(GUI::ScintillaWindow &win, int style, std::string_vi
 	win.StyleSetCharacterSet(style, characterSet);
 }
 
-void SciTEBase::SetStyleBlock(GUI::ScintillaWindow &win, const char *lang, int start, int last) {
+void SciTEBase::AddStyleBlock(StyleDefinitions &definitions, const char *lang, int start, int last) {
 	for (int style = start; style <= last; style++) {
 		if (style != StyleDefault) {
 			const std::string key = StyleName(lang, style-start);
 			std::string sval = props.GetExpandedString(key);
 			if (sval.length()) {
-				SetOneStyle(win, style, sval);
+				definitions.emplace_back(style, std::move(sval));
 			}
 		}
 	}
 }
 
-void SciTEBase::SetStyleFor(GUI::ScintillaWindow &win, const char *lang) {
-	SetStyleBlock(win, lang, 0, StyleMax);
-}
-
 void SciTEBase::SetOneIndicator(GUI::ScintillaWindow &win, SA::IndicatorNumbers indicator, const IndicatorDefinition &ind) {
 	const int indic = static_cast<int>(indicator);
 	win.IndicSetStyle(indic, ind.style);
@@ -1226,6 +1228,16 @@ void SciTEBase::ReadProperties() {
 	wOutput.SetLayoutCache(static_cast<SA::LineCache>(
 				       props.GetInt("output.cache.layout", static_cast<int>(SA::LineCache::Caret))));
 
+	const bool positionCacheShared = props.GetInt("cache.position.shared");
+	wEditor.SetPositionCacheShared(positionCacheShared);
+	wOutput.SetPositionCacheShared(positionCacheShared);
+	const int positionCacheSize = props.GetInt("cache.position");
+	if ((positionCacheSize > 0) && (positionCacheSize != wEditor.PositionCache())) {
+		wEditor.SetPositionCache(positionCacheSize);
+	}
+	wEditor.SetLineBitmapCache(props.GetInt("cache.line.bitmaps"));
+	wEditor.SetChunkedLayoutLength(props.GetInt("layout.chunked.length"));
+
 	wEditor.SetLayoutThreads(props.GetInt("threads.layout", 1));
 
 	bracesCheck = props.GetInt("braces.check");
@@ -1298,6 +1310,8 @@ void SciTEBase::ReadProperties() {
 	wEditor.SetWrapVisualFlagsLocation(static_cast<SA::WrapVisualLocation>(props.GetInt("wrap.visual.flags.location")));
 	wEditor.SetWrapStartIndent(props.GetInt("wrap.visual.startindent"));
 	wEditor.SetWrapIndentMode(static_cast<SA::WrapIndentMode>(props.GetInt("wrap.indent.mode")));
+	wEditor.SetIdleWrapping(static_cast<SA::IdleWrapping>(props.GetInt("idle.wrapping")));
+	wEditor.SetEstimateWrapHeights(props.GetInt("wrap.estimate.heights"));
 
 	idleStyling = static_cast<SA::IdleStyling>(props.GetInt("idle.styling", static_cast<int>(SA::IdleStyling::None)));
 	wEditor.SetIdleStyling(idleStyling);
@@ -1735,33 +1749,31 @@ void SciTEBase::ReadFontProperties() {
 	// For each window set the global default style, then the language default style, then the other global styles, then the other language styles
 
 	const SA::FontQuality fontQuality = static_cast<SA::FontQuality>(props.GetInt("font.quality"));
-	wEditor.SetFontQuality(fontQuality);
-	wOutput.SetFontQuality(fontQuality);
-
-	wEditor.StyleResetDefault();
-	wOutput.StyleResetDefault();
-
-	std::string fontLocale = props.GetExpandedString("font.locale");
-	if (!fontLocale.empty()) {
-		wEditor.SetFontLocale(fontLocale.c_str());
-		wOutput.SetFontLocale(fontLocale.c_str());
-	}
-
-	std::string sval = props.GetExpandedString(StyleName("*", StyleDefault));
-	SetOneStyle(wEditor, StyleDefault, sval);
-	SetOneStyle(wOutput, StyleDefault, sval);
-
-	sval = props.GetExpandedString(StyleName(language, StyleDefault));
-	SetOneStyle(wEditor, StyleDefault, sval);
-
-	wEditor.StyleClearAll();
-
-	SetStyleFor(wEditor, "*");
-	SetStyleFor(wEditor, language.c_str());
+	const std::string fontLocale = props.GetExpandedString("font.locale");
+	const std::string defaultGlobal = props.GetExpandedString(StyleName("*", StyleDefault));
+
+	// Everything that determines the styles of each window is gathered first so that a window is only
+	// restyled when that differs from what was last applied, such as when switching between buffers of
+	// the same language, as restyling discards the measurements and layouts held by the window.
+	std::string common = StdStringFromInteger(static_cast<int>(fontQuality));
+	common += '\n';
+	common += fontLocale;
+	common += '\n';
+	common += StdStringFromInteger(static_cast<int>(characterSet));
+	common += '\n';
+	common += monospaceFonts;
+	common += '\n';
+	common += defaultGlobal;
+	common += '\n';
+
+	const std::string defaultLanguage = props.GetExpandedString(StyleName(language, StyleDefault));
+	StyleDefinitions editorStyles;
+	AddStyleBlock(editorStyles, "*", 0, StyleMax);
+	AddStyleBlock(editorStyles, language.c_str(), 0, StyleMax);
 	if (props.GetInt("error.inline")) {
 		wEditor.ReleaseAllExtendedStyles();
 		diagnosticStyleStart = wEditor.AllocateExtendedStyles(diagnosticStyles);
-		SetStyleBlock(wEditor, "error", diagnosticStyleStart, diagnosticStyleStart+diagnosticStyles-1);
+		AddStyleBlock(editorStyles, "error", diagnosticStyleStart, diagnosticStyleStart+diagnosticStyles-1);
 	}
 
 	const int diffToSecondary = wEditor.DistanceToSecondaryStyles();
@@ -1771,40 +1783,93 @@ void SciTEBase::ReadFontProperties() {
 		for (int subStyle=0; subStyle<subStylesLength; subStyle++) {
 			for (int active=0; active<(diffToSecondary?2:1); active++) {
 				const int activity = active * diffToSecondary;
-				sval = props.GetExpandedString(
-					StyleName(language, subStyleBase + activity, subStyle + 1));
-				SetOneStyle(wEditor, subStylesStart + subStyle + activity, sval);
+				editorStyles.emplace_back(subStylesStart + subStyle + activity, props.GetExpandedString(
+					StyleName(language, subStyleBase + activity, subStyle + 1)));
 			}
 		}
 	}
 
-	// Turn grey while loading
-	if (CurrentBuffer()->lifeState == Buffer::LifeState::reading)
-		wEditor.StyleSetBack(StyleDefault, 0xEEEEEE);
+	const bool reading = CurrentBuffer()->lifeState == Buffer::LifeState::reading;
+	const std::string fontMonospace = CurrentBuffer()->useMonoFont ? props.GetExpandedString("font.monospace") : std::string();
 
-	wOutput.StyleClearAll();
+	std::string editorSignature = common;
+	editorSignature += defaultLanguage;
+	editorSignature += reading ? "\nreading\n" : "\n\n";
+	editorSignature += CurrentBuffer()->useMonoFont ? fontMonospace : std::string("\x01");
+	for (const auto &[style, definition] : editorStyles) {
+		editorSignature += '\n';
+		editorSignature += StdStringFromInteger(style);
+		editorSignature += '=';
+		editorSignature += definition;
+	}
 
-	sval = props.GetExpandedString(StyleName("errorlist", StyleDefault));
-	SetOneStyle(wOutput, StyleDefault, sval);
+	if (editorSignature != editorStylesApplied) {
+		wEditor.SetFontQuality(fontQuality);
+		wEditor.StyleResetDefault();
+		if (!fontLocale.empty()) {
+			wEditor.SetFontLocale(fontLocale.c_str());
+		}
+		SetOneStyle(wEditor, StyleDefault, defaultGlobal);
+		SetOneStyle(wEditor, StyleDefault, defaultLanguage);
 
-	wOutput.StyleClearAll();
+		wEditor.StyleClearAll();
 
-	SetStyleFor(wOutput, "*");
-	SetStyleFor(wOutput, "errorlist");
+		for (const auto &[style, definition] : editorStyles) {
+			SetOneStyle(wEditor, style, definition);
+		}
 
-	if (CurrentBuffer()->useMonoFont) {
-		sval = props.GetExpandedString("font.monospace");
-		StyleDefinition sd(sval);
-		for (int style = 0; style <= StyleMax; style++) {
-			if (style != static_cast<int>(SA::StylesCommon::LineNumber)) {
-				if (sd.specified & StyleDefinition::sdFont) {
-					wEditor.StyleSetFont(style, sd.font.c_str());
-				}
-				if (sd.specified & StyleDefinition::sdSize) {
-					wEditor.StyleSetSizeFractional(style, sd.FractionalSize());
+		// Turn grey while loading
+		if (reading)
+			wEditor.StyleSetBack(StyleDefault, 0xEEEEEE);
+
+		if (CurrentBuffer()->useMonoFont) {
+			StyleDefinition sd(fontMonospace);
+			for (int style = 0; style <= StyleMax; style++) {
+				if (style != static_cast<int>(SA::StylesCommon::LineNumber)) {
+					if (sd.specified & StyleDefinition::sdFont) {
+						wEditor.StyleSetFont(style, sd.font.c_str());
+					}
+					if (sd.specified & StyleDefinition::sdSize) {
+						wEditor.StyleSetSizeFractional(style, sd.FractionalSize());
+					}
 				}
 			}
 		}
+		editorStylesApplied = editorSignature;
+	}
+
+	const std::string defaultErrorList = props.GetExpandedString(StyleName("errorlist", StyleDefault));
+	StyleDefinitions outputStyles;
+	AddStyleBlock(outputStyles, "*", 0, StyleMax);
+	AddStyleBlock(outputStyles, "errorlist", 0, StyleMax);
+
+	std::string outputSignature = common;
+	outputSignature += defaultErrorList;
+	for (const auto &[style, definition] : outputStyles) {
+		outputSignature += '\n';
+		outputSignature += StdStringFromInteger(style);
+		outputSignature += '=';
+		outputSignature += definition;
+	}
+
+	if (outputSignature != outputStylesApplied) {
+		wOutput.SetFontQuality(fontQuality);
+		wOutput.StyleResetDefault();
+		if (!fontLocale.empty()) {
+			wOutput.SetFontLocale(fontLocale.c_str());
+		}
+		SetOneStyle(wOutput, StyleDefault, defaultGlobal);
+
+		wOutput.StyleClearAll();
+
+		SetOneStyle(wOutput, StyleDefault, defaultErrorList);
+
+		wOutput.StyleClearAll();
+
+		for (const auto &[style, definition] : outputStyles) {
+			SetOneStyle(wOutput, style, definition);
+		}
+		outputStylesApplied = outputSignature;
 	}
 }
 
@@ -0,0 +1,199 @@
+// SciTE - Scintilla based Text Editor
+/** @file StringSearch.cxx
+ ** Implementation of a fast byte string search used by Find in Files.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <tuple>
+#include <bit>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <set>
+#include <chrono>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define STRINGSEARCH_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define STRINGSEARCH_SSE2
+#endif
+
+#include "GUI.h"
+#include "StringHelpers.h"
+#include "StringSearch.h"
+
+namespace {
+
+constexpr bool IsWordCharacter(int ch) noexcept {
+	return (ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z') || (ch >= '0' && ch <= '9') || (ch == '_');
+}
+
+#if defined(STRINGSEARCH_AVX2)
+
+constexpr size_t blockSize = 32;
+using Block = __m256i;
+
+Block Load(const char *p) noexcept {
+	return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+}
+
+Block Splat(char ch) noexcept {
+	return _mm256_set1_epi8(ch);
+}
+
+// Fold A-Z to a-z. Bytes >= 0x80 are negative as signed so are not changed.
+Block FoldAZ(Block b) noexcept {
+	const Block upper = _mm256_and_si256(
+		_mm256_cmpgt_epi8(b, _mm256_set1_epi8('A' - 1)),
+		_mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), b));
+	return _mm256_or_si256(b, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+}
+
+uint32_t Equal(Block a, Block b) noexcept {
+	return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+}
+
+#elif defined(STRINGSEARCH_SSE2)
+
+constexpr size_t blockSize = 16;
+using Block = __m128i;
+
+Block Load(const char *p) noexcept {
+	return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+}
+
+Block Splat(char ch) noexcept {
+	return _mm_set1_epi8(ch);
+}
+
+// Fold A-Z to a-z. Bytes >= 0x80 are negative as signed so are not changed.
+Block FoldAZ(Block b) noexcept {
+	const Block upper = _mm_and_si128(
+		_mm_cmpgt_epi8(b, _mm_set1_epi8('A' - 1)),
+		_mm_cmplt_epi8(b, _mm_set1_epi8('Z' + 1)));
+	return _mm_or_si128(b, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+uint32_t Equal(Block a, Block b) noexcept {
+	return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)));
+}
+
+#endif
+
+}
+
+StringSearch::StringSearch(std::string_view needle_, bool matchCase_, bool wholeWord_) :
+	needle(needle_), matchCase(matchCase_), wholeWord(wholeWord_) {
+	if (!matchCase) {
+		LowerCaseAZ(needle);
+	}
+}
+
+bool StringSearch::MatchesAt(std::string_view haystack, size_t position) const noexcept {
+	if (matchCase) {
+		return memcmp(haystack.data() + position, needle.data(), needle.length()) == 0;
+	}
+	for (size_t i = 0; i < needle.length(); i++) {
+		if (MakeLowerCase(haystack[position + i]) != needle[i])
+			return false;
+	}
+	return true;
+}
+
+bool StringSearch::WordBounded(std::string_view haystack, size_t position) const noexcept {
+	const size_t end = position + needle.length();
+	return ((position == 0) || !IsWordCharacter(static_cast<unsigned char>(haystack[position - 1]))) &&
+		((end == haystack.length()) || !IsWordCharacter(static_cast<unsigned char>(haystack[end])));
+}
+
+size_t StringSearch::Find(std::string_view haystack, size_t start) const noexcept {
+	const size_t length = needle.length();
+	if (length == 0) {
+		return (start <= haystack.length()) ? start : std::string_view::npos;
+	}
+	if (start > haystack.length() || length > haystack.length() - start) {
+		return std::string_view::npos;
+	}
+	const size_t last = haystack.length() - length;	// Last possible match position
+	size_t position = start;
+#if defined(STRINGSEARCH_AVX2) || defined(STRINGSEARCH_SSE2)
+	// Compare first and last bytes of needle over a block of candidate positions
+	// then check the middle only where both match.
+	const Block first = Splat(needle.front());
+	const Block lastByte = Splat(needle.back());
+	const char *data = haystack.data();
+	for (; position + blockSize <= last + 1; position += blockSize) {
+		Block blockFirst = Load(data + position);
+		Block blockLast = Load(data + position + length - 1);
+		if (!matchCase) {
+			blockFirst = FoldAZ(blockFirst);
+			blockLast = FoldAZ(blockLast);
+		}
+		uint32_t mask = Equal(blockFirst, first) & Equal(blockLast, lastByte);
+		while (mask) {
+			const size_t candidate = position + std::countr_zero(mask);
+			if (MatchesAt(haystack, candidate) && (!wholeWord || WordBounded(haystack, candidate))) {
+				return candidate;
+			}
+			mask &= mask - 1;
+		}
+	}
+#endif
+	if (matchCase) {
+		while (position <= last) {
+			const void *found = memchr(haystack.data() + position, needle.front(), last + 1 - position);
+			if (!found) {
+				return std::string_view::npos;
+			}
+			position = static_cast<const char *>(found) - haystack.data();
+			if (MatchesAt(haystack, position) && (!wholeWord || WordBounded(haystack, position))) {
+				return position;
+			}
+			position++;
+		}
+	} else {
+		for (; position <= last; position++) {
+			if (MatchesAt(haystack, position) && (!wholeWord || WordBounded(haystack, position))) {
+				return position;
+			}
+		}
+	}
+	return std::string_view::npos;
+}
+
+size_t CountLineEnds(std::string_view text) noexcept {
+	// Lines = LF + CR - CR+LF
+	size_t lineEnds = 0;
+	size_t position = 0;
+#if defined(STRINGSEARCH_AVX2) || defined(STRINGSEARCH_SSE2)
+	const Block cr = Splat('\r');
+	const Block lf = Splat('\n');
+	const char *data = text.data();
+	for (; position + blockSize + 1 <= text.length(); position += blockSize) {
+		const Block block = Load(data + position);
+		const Block blockNext = Load(data + position + 1);
+		const uint32_t crs = Equal(block, cr);
+		const uint32_t lfs = Equal(block, lf);
+		const uint32_t crlfs = crs & Equal(blockNext, lf);
+		lineEnds += std::popcount(crs) + std::popcount(lfs) - std::popcount(crlfs);
+	}
+#endif
+	for (; position < text.length(); position++) {
+		const char ch = text[position];
+		if (ch == '\n') {
+			lineEnds++;
+		} else if (ch == '\r') {
+			if ((position + 1 >= text.length()) || (text[position + 1] != '\n')) {
+				lineEnds++;
+			}
+		}
+	}
+	return lineEnds;
+}
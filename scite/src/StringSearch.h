@@ -0,0 +1,32 @@
+// SciTE - Scintilla based Text Editor
+/** @file StringSearch.h
+ ** Definition of a fast byte string search used by Find in Files.
+ **/
+// Copyright 2026 by Neil Hodgson <neilh@scintilla.org>
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef STRINGSEARCH_H
+#define STRINGSEARCH_H
+
+// Find a byte string in a buffer, optionally ignoring ASCII case and optionally only
+// matching whole words. Candidates are found by comparing the first and last bytes of
+// the needle against blocks of the haystack with vector instructions where available.
+class StringSearch {
+	std::string needle;
+	bool matchCase;
+	bool wholeWord;
+	[[nodiscard]] bool MatchesAt(std::string_view haystack, size_t position) const noexcept;
+	[[nodiscard]] bool WordBounded(std::string_view haystack, size_t position) const noexcept;
+public:
+	StringSearch(std::string_view needle_, bool matchCase_, bool wholeWord_);
+	[[nodiscard]] size_t Length() const noexcept {
+		return needle.length();
+	}
+	// Returns position of first match at or after start or std::string_view::npos.
+	[[nodiscard]] size_t Find(std::string_view haystack, size_t start) const noexcept;
+};
+
+// Number of line ends (CR, LF, or CR+LF) in text. A CR at the end of text is counted.
+[[nodiscard]] size_t CountLineEnds(std::string_view text) noexcept;
+
+#endif
@@ -84,11 +84,19 @@ int TextReader::GetLineState(SA::Line line) {
 	return sc.LineState(line);
 }
 
+std::string TextReader::GetRange(SA::Position start, SA::Position end) {
+	start = std::max<SA::Position>(start, 0);
+	end = std::min(end, Length());
+	if (end <= start)
+		return {};
+	std::string text(end - start, '\0');
+	CopyText(sc, text.data(), SA::Span(start, end));
+	return text;
+}
+
 StyleWriter::StyleWriter(SA::ScintillaCall &sc_) noexcept :
 	TextReader(sc_),
-	validLen(0),
 	startSeg(0) {
-	styleBuf[0] = 0;
 }
 
 void StyleWriter::SetLineState(SA::Line line, int state) {
@@ -105,18 +113,18 @@ void StyleWriter::StartSegment(SA::Position pos) noexcept {
 
 void StyleWriter::ColourTo(SA::Position pos, int chAttr) {
 	// Only perform styling if non empty range
-	if (pos != startSeg - 1) {
-		if (validLen + (pos - startSeg + 1) >= bufferSize)
-			Flush();
-		if (validLen + (pos - startSeg + 1) >= bufferSize) {
-			// Too big for buffer so send directly
-			sc.SetStyling(pos - startSeg + 1, chAttr);
-		} else {
-			const unsigned char attr = chAttr & 0xffU;
-			for (SA::Position i = startSeg; i <= pos; i++) {
-				styleBuf[validLen++] = attr;
-			}
-		}
+	const SA::Position length = pos - startSeg + 1;
+	if (length <= 0) {
+		// Positions before startSeg have already been styled
+		return;
+	}
+	if (static_cast<SA::Position>(styleBuf.length()) + length >= styleBufferMax)
+		Flush();
+	if (length >= styleBufferMax) {
+		// Too big for buffer so send directly
+		sc.SetStyling(length, chAttr);
+	} else {
+		styleBuf.append(length, static_cast<char>(chAttr & 0xffU));
 	}
 	startSeg = pos+1;
 }
@@ -128,9 +136,9 @@ void StyleWriter::SetLevel(SA::Line line, SA::FoldLevel level) {
 void StyleWriter::Flush() {
 	startPos = extremePosition;
 	lenDoc = -1;
-	if (validLen > 0) {
-		sc.SetStylingEx(validLen, styleBuf);
-		validLen = 0;
+	if (!styleBuf.empty()) {
+		sc.SetStylingEx(styleBuf.length(), styleBuf.data());
+		styleBuf.clear();
 	}
 }
 
@@ -63,13 +63,16 @@ public:
 	Scintilla::FoldLevel LevelAt(Scintilla::Line line);
 	Scintilla::Position Length();
 	int GetLineState(Scintilla::Line line);
+	std::string GetRange(Scintilla::Position start, Scintilla::Position end);
 };
 
 // Adds methods needed to write styles and folding
 class StyleWriter : public TextReader {
 protected:
-	char styleBuf[bufferSize];
-	Scintilla::Position validLen;
+	/** Styles are accumulated in @a styleBuf which grows as needed up to
+	 * @a styleBufferMax bytes before being sent with one SCI_SETSTYLINGEX. */
+	static constexpr Scintilla::Position styleBufferMax = 0x100000;
+	std::string styleBuf;
 	Scintilla::Position startSeg;
 public:
 	explicit StyleWriter(Scintilla::ScintillaCall &sc_) noexcept;
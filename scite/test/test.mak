@@ -4,7 +4,7 @@
 DEL = del /q
 EXE = unitTest.exe
 
-INCLUDEDIRS = /I../src
+INCLUDEDIRS = /I../src /I../../scintilla/include
 
 CXXFLAGS = /MP /EHsc /std:c++20 $(OPTIMIZATION) /nologo /D_HAS_AUTO_PTR_ETC=1 /wd 4805 $(INCLUDEDIRS)
 
@@ -13,8 +13,13 @@ TESTSRC=test*.cxx
 # Files being tested from scintilla/src directory
 TESTEDSRC=\
  ../src/Cookie.cxx \
+ ../src/FilePath.cxx \
+ ../src/PathMatch.cxx \
+ ../src/PropSetFile.cxx \
  ../src/StringHelpers.cxx \
- ../src/Utf8_16.cxx
+ ../src/StringSearch.cxx \
+ ../src/Utf8_16.cxx \
+ ../win32/GUIWin.cxx
 
 TESTS=$(EXE)
 
@@ -27,4 +32,4 @@ clean:
 	$(DEL) $(TESTS) *.o *.obj *.exe
 
 $(EXE): $(TESTSRC) $(TESTEDSRC) $(@B).obj
-	$(CXX) $(CXXFLAGS) /Fe$@ $**
+	$(CXX) $(CXXFLAGS) /Fe$@ $** user32.lib
@@ -0,0 +1,174 @@
+/** @file testPropSetFile.cxx
+ ** Unit Tests for SciTE internal data structures
+ **/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+
+#include <stdexcept>
+#include <compare>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <set>
+#include <optional>
+#include <algorithm>
+#include <memory>
+#include <chrono>
+
+#include "GUI.h"
+#include "StringHelpers.h"
+#include "FilePath.h"
+#include "PropSetFile.h"
+
+#include "catch.hpp"
+
+#if defined(GTK) || defined(__APPLE__)
+
+// The platform layer is not linked into the tests so provide its UTF-8 string functions.
+// On Win32, GUIWin.cxx is linked instead.
+
+namespace GUI {
+
+gui_string StringFromUTF8(const char *s) {
+	return s ? gui_string(s) : gui_string();
+}
+
+gui_string StringFromUTF8(const std::string &s) {
+	return s;
+}
+
+gui_string StringFromUTF8(std::string_view sv) {
+	return gui_string(sv);
+}
+
+std::string UTF8FromString(gui_string_view sv) {
+	return std::string(sv);
+}
+
+// Only ASCII is lowered which is sufficient for the tests
+std::string LowerCaseUTF8(std::string_view sv) {
+	std::string lower(sv);
+	LowerCaseAZ(lower);
+	return lower;
+}
+
+}
+
+#endif
+
+using namespace std::literals;
+
+// Test PropSetFile::GetWild remembering results.
+
+TEST_CASE("PropSetFile") {
+
+	PropSetFile base;
+	PropSetFile props;
+	props.superPS = &base;
+	base.Set("file.patterns.cpp", "*.cxx;*.h");
+	base.Set("lexer.$(file.patterns.cpp)", "cpp");
+	base.Set("indent.size", "4");
+	props.Set("tabsize", "8");
+
+	REQUIRE(props.GetWild("lexer.", "x.cxx") == "cpp"sv);
+	REQUIRE(props.IsWildRemembered("lexer.", "x.cxx"));
+	REQUIRE(props.GetWild("lexer.", "x.py").empty());
+	REQUIRE(props.IsWildRemembered("lexer.", "x.py"));
+
+	SECTION("KeptAfterUnrelatedSetAndUnset") {
+		props.Set("tabsize", "2");
+		props.Set("lexer", "none");
+		base.Unset("indent.size");
+		props.Unset("tabsize");
+		REQUIRE(props.IsWildRemembered("lexer.", "x.cxx"));
+		REQUIRE(props.IsWildRemembered("lexer.", "x.py"));
+		REQUIRE(props.GetWild("lexer.", "x.cxx") == "cpp"sv);
+	}
+
+	SECTION("KeptAfterUnrelatedClear") {
+		props.Clear();
+		REQUIRE(props.IsWildRemembered("lexer.", "x.cxx"));
+		PropSetFile other;
+		other.Set("margin.width", "16");
+		other.Clear();
+		REQUIRE(props.IsWildRemembered("lexer.", "x.cxx"));
+		REQUIRE(props.GetWild("lexer.", "x.cxx") == "cpp"sv);
+	}
+
+	SECTION("KeptAfterSameValue") {
+		base.Set("file.patterns.cpp", "*.cxx;*.h");
+		base.Set("lexer.$(file.patterns.cpp)", "cpp");
+		REQUIRE(props.IsWildRemembered("lexer.", "x.cxx"));
+		// Assignment only changes keys with different values
+		const PropSetFile copy(base);
+		base = copy;
+		REQUIRE(props.IsWildRemembered("lexer.", "x.cxx"));
+		REQUIRE(props.GetWild("lexer.", "x.cxx") == "cpp"sv);
+	}
+
+	SECTION("DroppedWhenKeyUnderKeyBaseChanges") {
+		props.Set("lexer.*.py", "python");
+		REQUIRE(!props.IsWildRemembered("lexer.", "x.py"));
+		REQUIRE(props.GetWild("lexer.", "x.py") == "python"sv);
+		base.Set("lexer.$(file.patterns.cpp)", "c");
+		REQUIRE(!props.IsWildRemembered("lexer.", "x.cxx"));
+		REQUIRE(props.GetWild("lexer.", "x.cxx") == "c"sv);
+		base.Unset("lexer.$(file.patterns.cpp)");
+		REQUIRE(!props.IsWildRemembered("lexer.", "x.cxx"));
+		REQUIRE(props.GetWild("lexer.", "x.cxx").empty());
+	}
+
+	SECTION("DroppedWhenPatternVariableChanges") {
+		base.Set("file.patterns.cpp", "*.cpp");
+		REQUIRE(!props.IsWildRemembered("lexer.", "x.cxx"));
+		REQUIRE(props.GetWild("lexer.", "x.cxx").empty());
+		REQUIRE(props.GetWild("lexer.", "x.cpp") == "cpp"sv);
+		// Defining the variable in the derived set also changes the pattern
+		props.Set("file.patterns.cpp", "*.cxx");
+		REQUIRE(!props.IsWildRemembered("lexer.", "x.cpp"));
+		REQUIRE(props.GetWild("lexer.", "x.cxx") == "cpp"sv);
+	}
+
+	SECTION("DroppedWhenBaseCleared") {
+		base.Clear();
+		REQUIRE(!props.IsWildRemembered("lexer.", "x.cxx"));
+		REQUIRE(props.GetWild("lexer.", "x.cxx").empty());
+	}
+
+	SECTION("DroppedWhenAssignedDifferentValues") {
+		PropSetFile replacement;
+		replacement.Set("file.patterns.cpp", "*.c");
+		replacement.Set("lexer.$(file.patterns.cpp)", "cpp");
+		base = replacement;
+		REQUIRE(!props.IsWildRemembered("lexer.", "x.cxx"));
+		REQUIRE(props.GetWild("lexer.", "x.cxx").empty());
+		REQUIRE(props.GetWild("lexer.", "x.c") == "cpp"sv);
+	}
+
+	SECTION("DroppedWhenBaseSetChanges") {
+		PropSetFile other;
+		other.Set("lexer.*.cxx", "other");
+		props.superPS = &other;
+		REQUIRE(!props.IsWildRemembered("lexer.", "x.cxx"));
+		REQUIRE(props.GetWild("lexer.", "x.cxx") == "other"sv);
+		// Assignment may also attach a different base set
+		PropSetFile withBase;
+		withBase.superPS = &base;
+		props = withBase;
+		REQUIRE(!props.IsWildRemembered("lexer.", "x.cxx"));
+		REQUIRE(props.GetWild("lexer.", "x.cxx") == "cpp"sv);
+		// As may a change deeper in the chain
+		PropSetFile top;
+		top.superPS = &props;
+		REQUIRE(top.GetWild("lexer.", "x.cxx") == "cpp"sv);
+		props.superPS = &other;
+		REQUIRE(!top.IsWildRemembered("lexer.", "x.cxx"));
+		REQUIRE(top.GetWild("lexer.", "x.cxx") == "other"sv);
+	}
+}
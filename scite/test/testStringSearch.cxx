@@ -0,0 +1,97 @@
+/** @file testStringSearch.cxx
+ ** Unit Tests for SciTE internal data structures
+ **/
+
+#include <cstddef>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "StringSearch.h"
+
+#include "catch.hpp"
+
+using namespace std::literals;
+
+namespace {
+
+constexpr size_t npos = std::string_view::npos;
+
+}
+
+TEST_CASE("StringSearch") {
+
+	SECTION("MatchCase") {
+		const StringSearch search("gar", true, false);
+		REQUIRE(search.Length() == 3);
+		REQUIRE(search.Find("budgerigar", 0) == 7);
+		REQUIRE(search.Find("budgerigar", 8) == npos);
+		REQUIRE(search.Find("budgeriGar", 0) == npos);
+		REQUIRE(search.Find("", 0) == npos);
+		REQUIRE(search.Find("ga", 0) == npos);
+	}
+
+	SECTION("IgnoreCase") {
+		const StringSearch search("GaR", false, false);
+		REQUIRE(search.Find("budgerigar", 0) == 7);
+		REQUIRE(search.Find("budgeriGAR", 0) == 7);
+		// Only ASCII is folded
+		const StringSearch searchHigh("\xC3\x89t\xC3\xA9", false, false);
+		REQUIRE(searchHigh.Find("L'\xC3\x89T\xC3\xA9", 0) == 2);
+		REQUIRE(searchHigh.Find("L'\xC3\xA9T\xC3\xA9", 0) == npos);
+	}
+
+	SECTION("WholeWord") {
+		const StringSearch search("cat", true, true);
+		REQUIRE(search.Find("concatenate cat", 0) == 12);
+		REQUIRE(search.Find("cat", 0) == 0);
+		REQUIRE(search.Find("cats_cat(cat)", 0) == 9);
+		REQUIRE(search.Find("catcat", 0) == npos);
+	}
+
+	SECTION("Empty") {
+		const StringSearch search("", true, false);
+		REQUIRE(search.Find("abc", 1) == 1);
+		REQUIRE(search.Find("abc", 3) == 3);
+		REQUIRE(search.Find("abc", 4) == npos);
+	}
+
+	SECTION("LongHaystack") {
+		// Check vectorised blocks and the scalar tail find the same positions
+		std::string haystack(1000, 'x');
+		for (size_t position = 0; position + 4 <= haystack.length(); position += 37) {
+			std::string text = haystack;
+			text.replace(position, 4, "NeEd");
+			const StringSearch searchCase("NeEd", true, false);
+			REQUIRE(searchCase.Find(text, 0) == position);
+			REQUIRE(searchCase.Find(text, position + 1) == npos);
+			const StringSearch searchNoCase("need", false, false);
+			REQUIRE(searchNoCase.Find(text, 0) == position);
+		}
+		// Candidates where first and last bytes match but the middle does not
+		const std::string nearMisses = std::string(100, 'a') + "abcab" + std::string(50, 'a') + "abbab";
+		const StringSearch search("abbab", true, false);
+		REQUIRE(search.Find(nearMisses, 0) == 155);
+	}
+
+	SECTION("CountLineEnds") {
+		REQUIRE(CountLineEnds("") == 0);
+		REQUIRE(CountLineEnds("a") == 0);
+		REQUIRE(CountLineEnds("a\nb\rc\r\nd") == 3);
+		REQUIRE(CountLineEnds("\r\n\r\n") == 2);
+		REQUIRE(CountLineEnds("\n\r") == 2);
+		REQUIRE(CountLineEnds("\r") == 1);
+		std::string lines;
+		for (int i = 0; i < 100; i++) {
+			lines += (i % 3 == 0) ? "line\r\n" : ((i % 3 == 1) ? "line\n" : "line\r");
+		}
+		REQUIRE(CountLineEnds(lines) == 100);
+		// CR+LF split at every position in a block
+		for (size_t position = 0; position < 40; position++) {
+			std::string text(40, 'x');
+			text.insert(position, "\r\n");
+			REQUIRE(CountLineEnds(text) == 1);
+		}
+	}
+}
@@ -547,6 +547,7 @@ SciTEIO.obj: \
 	../src/FileWorker.h \
 	../src/MatchMarker.h \
 	../src/Searcher.h \
+	../src/StringSearch.h \
 	../src/SciTEBase.h
 SciTEProps.obj: \
 	../src/SciTEProps.cxx \
@@ -587,6 +588,10 @@ StringList.obj: \
 	../src/GUI.h \
 	../src/StringList.h \
 	../src/StringHelpers.h
+StringSearch.obj: \
+	../src/StringSearch.cxx \
+	../src/StringHelpers.h \
+	../src/StringSearch.h
 StyleDefinition.obj: \
 	../src/StyleDefinition.cxx \
 	../../scintilla/include/ScintillaTypes.h \
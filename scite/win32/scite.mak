@@ -91,6 +91,7 @@ SHAREDOBJS=\
 	SciTEWinDlg.obj \
 	StringHelpers.obj \
 	StringList.obj \
+	StringSearch.obj \
 	Strips.obj \
 	StyleDefinition.obj \
 	StyleWriter.obj \